@@ -1,17 +1,102 @@
 #define SDL_MAIN_HANDLED
 
+#include <charconv>
 #include <exception>
+#include <iostream>
 #include <memory>
+#include <string>
 
 #include "Core/Application.hpp"
 #include "Core/UI.h"
 #include "Core/Debug/Instrumentor.hpp"
+#include "Core/FrameCapture.h"
 #include "Core/Log.hpp"
 
-int main() {
+namespace {
+void print_usage(const char* program) {
+  std::cout << "usage: " << program
+            << " [--headless] [--frames N] [--capture DIR]"
+               " [--capture-format bmp|png|qoi] [--capture-range FIRST:LAST]"
+               " [--capture-every N] [--capture-no-drop]\n";
+}
+
+// whole string as a base 10 int no smaller than minimum
+bool parse_int(const std::string& text, int minimum, int& out) {
+  int parsed = 0;
+  const char* end = text.data() + text.size();
+  const auto [ptr, ec] = std::from_chars(text.data(), end, parsed);
+  if (ec != std::errc() or ptr != end or parsed < minimum)
+    return false;
+  out = parsed;
+  return true;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool headless = false;
+  int frame_limit = 0;
+  bool capturing = false;
+  FrameCapture::Settings capture;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--headless") {
+      headless = true;
+      continue;
+    }
+    if (arg == "--capture-no-drop") {
+      capture.drop_when_busy = false;
+      continue;
+    }
+    if (arg != "--frames" and arg != "--capture" and
+        arg != "--capture-format" and arg != "--capture-range" and
+        arg != "--capture-every") {
+      print_usage(argv[0]);
+      return 1;
+    }
+    if (i + 1 >= argc) {
+      std::cout << "error: " << arg << " needs a value\n";
+      return 1;
+    }
+    const std::string value = argv[++i];
+    bool valid = true;
+    if (arg == "--frames") {
+      valid = parse_int(value, 0, frame_limit);
+    } else if (arg == "--capture") {
+      capture.directory = value;
+      capturing = true;
+    } else if (arg == "--capture-format") {
+      if (not FrameCapture::parse_format(value, capture.format)) {
+        std::cout << "error: unknown capture format " << value << "\n";
+        return 1;
+      }
+    } else if (arg == "--capture-range") {
+      // FIRST:LAST, FIRST: runs to the end
+      const auto colon = value.find(':');
+      valid = parse_int(value.substr(0, colon), 0, capture.first_frame);
+      if (valid and colon != std::string::npos and colon + 1 < value.size())
+        valid = parse_int(value.substr(colon + 1), capture.first_frame,
+                          capture.last_frame);
+    } else {
+      valid = parse_int(value, 1, capture.every);
+    }
+    if (not valid) {
+      std::cout << "error: bad value " << value << " for " << arg << "\n";
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+  if (capturing)
+    FrameCapture::getInstance().configure(capture);
+
   try {
     APP_PROFILE_BEGIN_SESSION_WITH_FILE("App", "profile.json");
 
+    if (headless) {
+      const auto status = App::Application::run_headless(frame_limit);
+      APP_PROFILE_END_SESSION();
+      return static_cast<int>(status);
+    }
+
     {
       APP_PROFILE_SCOPE("Pulsar scope");
       App::Application app{"Pulsar"};
@@ -0,0 +1,85 @@
+#define SDL_MAIN_HANDLED
+
+#include <SDL2/SDL.h>
+#include <SDL2_image/SDL_image.h>
+#include <charconv>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "Core/AtlasBuilder.h"
+#include "Core/Resources.hpp"
+#include "Core/TextureAtlas.h"
+
+namespace {
+void print_usage(const char* program) {
+  std::cout << "usage: " << program
+            << " [images_dir] [out_dir] [--page-size N] [--padding N]"
+               " [--extrude N]\n";
+}
+
+// whole string as a base 10 int no smaller than minimum
+bool parse_int(const std::string& text, int minimum, int& out) {
+  int parsed = 0;
+  const char* end = text.data() + text.size();
+  const auto [ptr, ec] = std::from_chars(text.data(), end, parsed);
+  if (ec != std::errc() or ptr != end or parsed < minimum)
+    return false;
+  out = parsed;
+  return true;
+}
+}  // namespace
+
+// Packs the game's images into atlas pages the engine picks up on startup.
+// Defaults to <game>/images and <game>/atlas.
+int main(int argc, char* argv[]) {
+  std::filesystem::path images_dir = App::Resources::game_path() / "images";
+  std::filesystem::path out_dir =
+      App::Resources::game_path() / TextureAtlas::DIRECTORY;
+  AtlasBuildOptions options;
+
+  int positional = 0;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    int* value = nullptr;
+    // pages need at least a pixel, padding and extrude can be 0
+    int minimum = 0;
+    if (arg == "--page-size") {
+      value = &options.page_size;
+      minimum = 1;
+    } else if (arg == "--padding") {
+      value = &options.padding;
+    } else if (arg == "--extrude") {
+      value = &options.extrude;
+    }
+
+    if (value != nullptr) {
+      if (i + 1 >= argc) {
+        std::cout << "error: " << arg << " needs a value\n";
+        print_usage(argv[0]);
+        return 1;
+      }
+      const std::string text = argv[++i];
+      if (not parse_int(text, minimum, *value)) {
+        std::cout << "error: bad value " << text << " for " << arg << "\n";
+        print_usage(argv[0]);
+        return 1;
+      }
+    } else if (positional == 0) {
+      images_dir = arg;
+      positional++;
+    } else if (positional == 1) {
+      out_dir = arg;
+      positional++;
+    } else {
+      std::cout << "error: unexpected argument " << arg << "\n";
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+
+  IMG_Init(IMG_INIT_PNG);
+  const bool ok = AtlasBuilder::build(images_dir, out_dir, options);
+  IMG_Quit();
+  return ok ? 0 : 1;
+}
@@ -73,20 +73,9 @@ luabridge::LuaRef Actor::LuaCreateActor(const std::string& template_name) {
   if (template_name.empty())
     return {L};
 
-  // move to helper later
-  const std::string templates_path = (App::Resources::game_path() / "actor_templates").generic_string();
-  const std::string actor_templates_path =
-      templates_path + "/" + template_name + ".template";
-
-  if (not std::filesystem::exists(actor_templates_path)) {
-    std::cout << "error: template " << template_name << " is missing";
-    std::exit(0);
-  }
-  rapidjson::Document actor_templates;
-  EngineUtils::ReadJsonFile(actor_templates_path, actor_templates);
-
   auto* new_actor = new Actor;
-  ActorTemplate::update_from_source_file(*new_actor, actor_templates);
+  ActorTemplate::update_from_source_file(
+      *new_actor, ActorTemplate::get_template_data(template_name));
   new_actor->set_id();
 
   auto& scm = SceneManager::getInstance();
@@ -11,23 +11,46 @@
 #include <rapidjson/document.h>
 #include <filesystem>
 
+std::unordered_map<std::string, std::unique_ptr<rapidjson::Document>>
+    ActorTemplate::template_data;
+
 Actor ActorTemplate::load_actor_template(const std::string& template_name) {
-  const std::string templates_path =
-      (App::Resources::game_path() / "actor_templates").generic_string();
+  Actor actor;
+  update_from_source_file(actor, get_template_data(template_name));
+  actor.set_id();
+  return actor;
+}
+
+const rapidjson::Document* ActorTemplate::find_template_data(
+    const std::string& template_name) {
+  if (const auto it = template_data.find(template_name);
+      it != template_data.end())
+    return it->second.get();
+
   const std::string actor_templates_path =
-      templates_path + "/" + template_name + ".template";
+      (App::Resources::game_path() / "actor_templates" /
+       (template_name + ".template"))
+          .generic_string();
+  if (not std::filesystem::exists(actor_templates_path))
+    return nullptr;
+  auto document = std::make_unique<rapidjson::Document>();
+  EngineUtils::ReadJsonFile(actor_templates_path, *document);
+  return template_data.emplace(template_name, std::move(document))
+      .first->second.get();
+}
 
-  if (not std::filesystem::exists(actor_templates_path)) {
+const rapidjson::Document& ActorTemplate::get_template_data(
+    const std::string& template_name) {
+  const rapidjson::Document* document = find_template_data(template_name);
+  if (document == nullptr) {
     std::cout << "error: template " << template_name << " is missing";
-    std::exit(0);
+    GameThread::quit(0);
   }
-  rapidjson::Document actor_templates;
-  EngineUtils::ReadJsonFile(actor_templates_path, actor_templates);
+  return *document;
+}
 
-  Actor actor;
-  update_from_source_file(actor, actor_templates);
-  actor.set_id();
-  return actor;
+void ActorTemplate::clear_template_data() {
+  template_data.clear();
 }
 void ActorTemplate::update_from_source_file(Actor& actor,
                                             const rapidjson::Value& actorData) {
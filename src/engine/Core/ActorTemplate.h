@@ -5,16 +5,29 @@
 #ifndef PULSAR_SRC_ENGINE_CORE_ACTORTEMPLATE_H_
 #define PULSAR_SRC_ENGINE_CORE_ACTORTEMPLATE_H_
 
+#include <memory>
 #include <optional>
 #include <unordered_map>
 
 #include "Actor.h"
 
 class ActorTemplate {
+  // parsed .template files, so Actor.Instantiate doesn't hit the disk
+  static std::unordered_map<std::string, std::unique_ptr<rapidjson::Document>>
+      template_data;
+
  public:
   static Actor load_actor_template(const std::string& template_name);
   static void update_from_source_file(Actor& actor,
                                       const rapidjson::Value& actorData);
+
+  // null when the template doesn't exist
+  static const rapidjson::Document* find_template_data(
+      const std::string& template_name);
+  // same, but a missing template is an error
+  static const rapidjson::Document& get_template_data(
+      const std::string& template_name);
+  static void clear_template_data();
 };
 
 
@@ -9,6 +9,7 @@
 #include <backends/imgui_impl_sdlrenderer2.h>
 #include <imgui.h>
 
+#include <iostream>
 #include <memory>
 #include <string>
 
@@ -17,6 +18,8 @@
 #include "Core/Engine.h"
 #include "Core/ResourceManager.h"
 #include "Core/EngineUtils.h"
+#include "Core/FrameCapture.h"
+#include "Core/FramePacer.h"
 #include "Core/Log.hpp"
 #include "Core/Resources.hpp"
 #include "Core/SceneManager.h"
@@ -137,6 +140,41 @@ ExitStatus App::Application::run() {
   return m_exit_status;
 }
 
+ExitStatus App::Application::run_headless(const int frame_limit) {
+  APP_PROFILE_FUNCTION();
+
+  // no SDL_INIT_VIDEO, the software renderer doesn't need a display
+  if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
+    APP_ERROR("Error: {}", SDL_GetError());
+    return ExitStatus::FAILURE;
+  }
+  IMG_Init(IMG_INIT_PNG);
+  TTF_Init();
+
+  Engine& engine = Engine::getInstance();
+  engine.set_headless(true);
+  engine.set_frame_limit(frame_limit);
+  engine.initialize();
+  engine.run_game();
+
+  FrameCapture& capture = FrameCapture::getInstance();
+  if (capture.is_enabled()) {
+    capture.flush();
+    std::cout << "captured " << capture.get_written_count() << " frames, "
+              << capture.get_dropped_count() << " dropped\n";
+  }
+
+  const auto summary = FramePacer::getInstance().get_summary();
+  std::cout << "frames " << engine.get_frames_run() << ", p50 " << summary.p50
+            << " ms, p95 " << summary.p95 << " ms, p99 " << summary.p99
+            << " ms, max " << summary.max << " ms\n";
+
+  TTF_Quit();
+  IMG_Quit();
+  SDL_Quit();
+  return ExitStatus::SUCCESS;
+}
+
 void App::Application::stop() {
   APP_PROFILE_FUNCTION();
 
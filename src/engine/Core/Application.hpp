@@ -32,6 +32,10 @@ class Application {
   ExitStatus run();
   void stop();
 
+  // Plays the game with no window, editor or audio (--headless), printing
+  // frame time percentiles at the end. frame_limit 0 runs until it quits.
+  static ExitStatus run_headless(int frame_limit);
+
   void on_event(const SDL_WindowEvent& event);
   void on_minimize();
   void on_shown();
@@ -0,0 +1,192 @@
+#include "AtlasBuilder.h"
+
+#include <SDL2/SDL.h>
+#include <SDL2_image/SDL_image.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "SkylinePacker.h"
+#include "TextureAtlas.h"
+
+namespace {
+
+struct SourceImage {
+  std::string name;
+  SDL_Surface* surface;
+};
+
+struct Placement {
+  size_t page;
+  int x;
+  int y;
+};
+
+// Copies src onto page with its top left pixel at (x, y), plus extrude pixels
+// of clamped edge on every side. Both surfaces are RGBA32.
+void blit_extruded(const SDL_Surface* src,
+                   SDL_Surface* page,
+                   int x,
+                   int y,
+                   int extrude) {
+  const auto* src_pixels = static_cast<const Uint8*>(src->pixels);
+  auto* page_pixels = static_cast<Uint8*>(page->pixels);
+  for (int row = -extrude; row < src->h + extrude; row++) {
+    const int src_row = std::clamp(row, 0, src->h - 1);
+    Uint8* dst_line = page_pixels + (y + row) * page->pitch;
+    const Uint8* src_line = src_pixels + src_row * src->pitch;
+    for (int col = -extrude; col < src->w + extrude; col++) {
+      const int src_col = std::clamp(col, 0, src->w - 1);
+      std::copy_n(src_line + src_col * 4, 4, dst_line + (x + col) * 4);
+    }
+  }
+}
+
+}  // namespace
+
+bool AtlasBuilder::build(const std::filesystem::path& images_dir,
+                         const std::filesystem::path& out_dir,
+                         const AtlasBuildOptions& options) {
+  if (not std::filesystem::is_directory(images_dir)) {
+    std::cout << "error: " << images_dir.generic_string()
+              << " is not a directory\n";
+    return false;
+  }
+  std::filesystem::create_directories(out_dir);
+  const auto out_canonical = std::filesystem::weakly_canonical(out_dir);
+
+  std::vector<SourceImage> images;
+  for (const auto& entry :
+       std::filesystem::recursive_directory_iterator(images_dir)) {
+    if (not entry.is_regular_file() or entry.path().extension() != ".png")
+      continue;
+    // a previous build's pages when out_dir sits under images_dir
+    const auto parent =
+        std::filesystem::weakly_canonical(entry.path().parent_path());
+    if (parent == out_canonical)
+      continue;
+    SDL_Surface* loaded = IMG_Load(entry.path().generic_string().c_str());
+    if (loaded == nullptr) {
+      std::cout << "warning: skipping " << entry.path().generic_string()
+                << ": " << IMG_GetError() << "\n";
+      continue;
+    }
+    SDL_Surface* rgba =
+        SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(loaded);
+    if (rgba == nullptr)
+      continue;
+    // same name Renderer asks for: relative path, no extension
+    auto name = std::filesystem::relative(entry.path(), images_dir);
+    name.replace_extension();
+    images.push_back({name.generic_string(), rgba});
+  }
+
+  // tallest first keeps the skyline flat
+  std::sort(images.begin(), images.end(),
+            [](const SourceImage& a, const SourceImage& b) {
+              if (a.surface->h != b.surface->h)
+                return a.surface->h > b.surface->h;
+              return a.surface->w > b.surface->w;
+            });
+
+  bool ok = true;
+  const int border = options.extrude * 2 + options.padding;
+  std::vector<SkylinePacker> packers;
+  std::vector<SDL_Surface*> pages;
+  std::vector<std::pair<const SourceImage*, Placement>> placed;
+  for (const auto& image : images) {
+    const int cell_w = image.surface->w + border;
+    const int cell_h = image.surface->h + border;
+    if (cell_w > options.page_size or cell_h > options.page_size) {
+      std::cout << "note: " << image.name << " (" << image.surface->w << "x"
+                << image.surface->h << ") is bigger than a page, it stays a "
+                << "standalone texture\n";
+      continue;
+    }
+    Placement placement{packers.size(), 0, 0};
+    for (size_t i = 0; i < packers.size(); i++) {
+      if (packers[i].insert(cell_w, cell_h, placement.x, placement.y)) {
+        placement.page = i;
+        break;
+      }
+    }
+    if (placement.page == packers.size()) {
+      // comes back zeroed, i.e. transparent
+      SDL_Surface* page = SDL_CreateRGBSurfaceWithFormat(
+          0, options.page_size, options.page_size, 32, SDL_PIXELFORMAT_RGBA32);
+      if (page == nullptr) {
+        std::cout << "error: could not allocate a page: " << SDL_GetError()
+                  << "\n";
+        ok = false;
+        break;
+      }
+      packers.emplace_back(options.page_size, options.page_size);
+      pages.push_back(page);
+      if (not packers.back().insert(cell_w, cell_h, placement.x,
+                                    placement.y))
+        continue;
+    }
+    // the image itself starts past the extruded border
+    placement.x += options.extrude;
+    placement.y += options.extrude;
+    blit_extruded(image.surface, pages[placement.page], placement.x,
+                  placement.y, options.extrude);
+    placed.emplace_back(&image, placement);
+  }
+
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  writer.StartObject();
+  writer.Key("pages");
+  writer.StartArray();
+  for (size_t i = 0; i < pages.size(); i++) {
+    const std::string page_name = "page_" + std::to_string(i) + ".png";
+    const std::string page_path = (out_dir / page_name).generic_string();
+    if (IMG_SavePNG(pages[i], page_path.c_str()) != 0) {
+      std::cout << "error: could not write " << page_path << ": "
+                << IMG_GetError() << "\n";
+      ok = false;
+    }
+    writer.String(page_name.c_str());
+    std::cout << page_name << ": "
+              << static_cast<int>(packers[i].get_occupancy() * 100.0f)
+              << "% used\n";
+  }
+  writer.EndArray();
+  writer.Key("regions");
+  writer.StartObject();
+  for (const auto& [image, placement] : placed) {
+    writer.Key(image->name.c_str());
+    writer.StartObject();
+    writer.Key("page");
+    writer.Int(static_cast<int>(placement.page));
+    writer.Key("x");
+    writer.Int(placement.x);
+    writer.Key("y");
+    writer.Int(placement.y);
+    writer.Key("w");
+    writer.Int(image->surface->w);
+    writer.Key("h");
+    writer.Int(image->surface->h);
+    writer.EndObject();
+  }
+  writer.EndObject();
+  writer.EndObject();
+
+  std::ofstream manifest(out_dir / TextureAtlas::MANIFEST);
+  manifest << buffer.GetString();
+  ok = ok and manifest.good();
+
+  std::cout << placed.size() << " of " << images.size() << " images packed on "
+            << pages.size() << " page(s)\n";
+  for (auto* page : pages)
+    SDL_FreeSurface(page);
+  for (auto& image : images)
+    SDL_FreeSurface(image.surface);
+  return ok;
+}
@@ -0,0 +1,26 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_ATLASBUILDER_H_
+#define PULSAR_SRC_ENGINE_CORE_ATLASBUILDER_H_
+
+#include <filesystem>
+
+struct AtlasBuildOptions {
+  int page_size = 2048;
+  // empty pixels between neighbouring images
+  int padding = 2;
+  // edge pixels repeated around each image so linear filtering at the
+  // border never samples the neighbour
+  int extrude = 1;
+};
+
+// Offline half of the texture atlas, run by the AtlasPacker tool. Packs every
+// png under images_dir onto skyline packed pages and writes them plus an
+// atlas.json manifest (see TextureAtlas) to out_dir. Images too big for a
+// page are left out, the renderer loads those on their own like before.
+class AtlasBuilder {
+ public:
+  static bool build(const std::filesystem::path& images_dir,
+                    const std::filesystem::path& out_dir,
+                    const AtlasBuildOptions& options);
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_ATLASBUILDER_H_
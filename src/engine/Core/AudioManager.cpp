@@ -8,10 +8,15 @@
 #include <string>
 
 #include "AudioHelper.h"
+#include "GameThread.h"
+#include "JobSystem.h"
 
 std::unordered_map<std::string, Mix_Chunk*> AudioManager::audio_clips;
+bool AudioManager::enabled = true;
 
 void AudioManager::initialize() {
+  if (not enabled)
+    return;
   if (AudioHelper::Mix_OpenAudio498(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
     std::cout << "[my] error: failed to initialize audio";
   }
@@ -19,6 +24,8 @@ void AudioManager::initialize() {
 }
 
 void AudioManager::start_intro_music(const rapidjson::Document& game_config) {
+  if (not enabled)
+    return;
   std::string base_path = AudioManager::getInstance().AUDIO_PATH;
   if (const auto key = AudioManager::getInstance().INTRO.c_str();
       game_config.HasMember(key) && game_config[key].IsString()) {
@@ -35,7 +42,7 @@ void AudioManager::start_intro_music(const rapidjson::Document& game_config) {
       }
     }
     std::cout << "error: failed to play audio clip " << intro_bgm;
-    std::exit(0);
+    GameThread::quit(0);
   }
 }
 void AudioManager::stop_intro_music() {
@@ -74,7 +81,7 @@ void AudioManager::stop_intro_music() {
 void AudioManager::play_channel(const std::string& key,
                                 const int channel,
                                 const int loops) {
-  if (key.empty())
+  if (key.empty() or not enabled)
     return;
   if (audio_clips.find(key) == audio_clips.end()) {
     //        std::cout << key << " audio requested on " << channel <<
@@ -92,6 +99,8 @@ void AudioManager::LuaPlayChannel(int channel,
 }
 
 void AudioManager::halt_channel(const int channel) {
+  if (not enabled)
+    return;
   AudioHelper::Mix_HaltChannel498(channel);
 }
 
@@ -100,20 +109,51 @@ void AudioManager::load_sfx(const std::string& key) {
     return;
   if (audio_clips.find(key) != audio_clips.end())
     return;
+  if (const std::string path = get_clip_path(key); not path.empty())
+    audio_clips[key] = AudioHelper::Mix_LoadWAV498(path.c_str());
+}
+
+std::string AudioManager::get_clip_path(const std::string& key) {
+  if (key.empty())
+    return {};
   std::string base_path = AudioManager::getInstance().AUDIO_PATH;
   base_path += key;
   for (const auto& ext : AudioManager::getInstance().EXTS) {
     std::string path = base_path;
     path += ext;
-    if (std::filesystem::exists(path)) {
-      const auto audio_clip_mix = AudioHelper::Mix_LoadWAV498(path.c_str());
-      audio_clips[key] = audio_clip_mix;
-      return;
-    }
+    if (std::filesystem::exists(path))
+      return path;
   }
+  return {};
+}
+
+// Each chunk decodes on its own, only the map insert has to be serial.
+void AudioManager::preload_clips(const std::set<std::string>& keys) {
+  if (not enabled)
+    return;
+  std::vector<std::pair<std::string, std::string>> to_load;
+  for (const auto& key : keys) {
+    if (audio_clips.find(key) != audio_clips.end())
+      continue;
+    if (std::string path = get_clip_path(key); not path.empty())
+      to_load.emplace_back(key, std::move(path));
+  }
+  if (to_load.empty())
+    return;
+
+  std::vector<Mix_Chunk*> chunks(to_load.size(), nullptr);
+  JobSystem::getInstance().parallel_for(
+      to_load.size(), 1, [&to_load, &chunks](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+          chunks[i] = AudioHelper::Mix_LoadWAV498(to_load[i].second.c_str());
+      });
+  for (size_t i = 0; i < to_load.size(); i++)
+    audio_clips[to_load[i].first] = chunks[i];
 }
 
 void AudioManager::SetVolume(int channel, float volume) {
+  if (not enabled)
+    return;
   volume = std::max(0, std::min(static_cast<int>(volume), 128));
   AudioHelper::Mix_Volume498(channel, volume);
 }
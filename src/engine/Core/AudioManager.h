@@ -7,6 +7,7 @@
 
 #include <SDL2_mixer/SDL_mixer.h>
 #include <rapidjson/document.h>
+#include <set>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -27,6 +28,10 @@ class AudioManager {
     return instance;
   }
 
+  // off for headless runs, every call below becomes a no-op
+  static bool enabled;
+  static void set_enabled(bool value) { enabled = value; }
+
   bool loaded_intro_music = false;
   bool halted_intro_music = false;
   static void initialize();
@@ -42,6 +47,10 @@ class AudioManager {
                              bool doesLoop);
   static void halt_channel(int channel);
   static void load_sfx(const std::string& key);
+  // empty when there's no clip by that name
+  [[nodiscard]] static std::string get_clip_path(const std::string& key);
+  // decodes the clips on the JobSystem, returns once they're all in
+  static void preload_clips(const std::set<std::string>& keys);
   static void SetVolume(int channel, float volume);
   [[maybe_unused]] const int SCORE_CHANNEL = 1;
 };
@@ -0,0 +1,34 @@
+#include "ComponentTracker.h"
+
+void ComponentTracker::track(const void* slot,
+                             const luabridge::LuaRef& component) {
+  lua_state = component.state();
+  push_table();
+  component.push(lua_state);
+  lua_rawsetp(lua_state, -2, slot);
+  lua_pop(lua_state, 1);
+}
+
+bool ComponentTracker::referenced(const void* slot) const {
+  if (lua_state == nullptr)
+    return false;
+  push_table();
+  lua_rawgetp(lua_state, -1, slot);
+  const bool is_referenced = not lua_isnil(lua_state, -1);
+  lua_pop(lua_state, 2);
+  return is_referenced;
+}
+
+// keyed by the tracker's address, each pool gets its own table
+void ComponentTracker::push_table() const {
+  if (lua_rawgetp(lua_state, LUA_REGISTRYINDEX, this) == LUA_TTABLE)
+    return;
+  lua_pop(lua_state, 1);
+  lua_newtable(lua_state);
+  lua_newtable(lua_state);
+  lua_pushstring(lua_state, "v");
+  lua_setfield(lua_state, -2, "__mode");
+  lua_setmetatable(lua_state, -2);
+  lua_pushvalue(lua_state, -1);
+  lua_rawsetp(lua_state, LUA_REGISTRYINDEX, this);
+}
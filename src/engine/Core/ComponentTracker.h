@@ -0,0 +1,25 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_COMPONENTTRACKER_H_
+#define PULSAR_SRC_ENGINE_CORE_COMPONENTTRACKER_H_
+
+// clang-format off
+#include "lua.hpp"
+#include <LuaBridge/LuaBridge.h>
+// clang-format on
+
+// Weak valued registry table of pool slot -> the component ECS made for it.
+// Component pools keep a released slot out of reuse while referenced() says
+// a script may still be holding its component.
+class ComponentTracker {
+ public:
+  void track(const void* slot, const luabridge::LuaRef& component);
+  [[nodiscard]] bool referenced(const void* slot) const;
+  // the Lua state is about to close, nothing is referenced after this
+  void forget() { lua_state = nullptr; }
+
+ private:
+  void push_table() const;
+
+  lua_State* lua_state = nullptr;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_COMPONENTTRACKER_H_
@@ -9,6 +9,8 @@
 #include <iostream>
 #include <string>
 
+#include "StaticGeometry.h"
+
 class Actor;
 
 class Contact {
@@ -64,12 +66,25 @@ class Contact {
   }
 
   static Actor* GetActorA(b2Contact* contact) {
-    return reinterpret_cast<Actor*>(
-        contact->GetFixtureA()->GetUserData().pointer);
+    return StaticGeometry::resolve_actor(
+        contact->GetFixtureA(),
+        GetResolveHint(contact, contact->GetFixtureB()));
   }
   static Actor* GetActorB(b2Contact* contact) {
-    return reinterpret_cast<Actor*>(
-        contact->GetFixtureB()->GetUserData().pointer);
+    return StaticGeometry::resolve_actor(
+        contact->GetFixtureB(),
+        GetResolveHint(contact, contact->GetFixtureA()));
+  }
+
+  // Where on a merged static fixture the contact happened, falls back to the
+  // other body's position once the manifold is gone (EndContact).
+  static b2Vec2 GetResolveHint(b2Contact* contact, b2Fixture* other) {
+    if (contact->GetManifold()->pointCount > 0) {
+      b2WorldManifold world_manifold;
+      contact->GetWorldManifold(&world_manifold);
+      return world_manifold.points[0];
+    }
+    return other->GetBody()->GetPosition();
   }
 
  private:
@@ -3,6 +3,7 @@
 //
 
 #include "ContactListener.h"
+#include "PhysicsPipeline.h"
 
 void ContactListener::BeginContact(b2Contact* contact) {
   Contact new_contact;
@@ -83,6 +84,13 @@ void ContactListener::EndContact(b2Contact* contact) {
 void ContactListener::LuaOnContactHandle(const Contact& contact,
                                          EngineUtils::LifeCycle event,
                                          Actor* caller) {
+  // Step is running on the physics thread, lua has to wait for the sync point
+  if (auto& pipeline = PhysicsPipeline::getInstance();
+      pipeline.on_worker_thread()) {
+    pipeline.queue_contact(contact, event, caller);
+    return;
+  }
+
   if (caller->lifecycle_function_map.count(event) <= 0) return;
 
   auto contact_functions = caller->lifecycle_function_map.at(event);
@@ -8,6 +8,8 @@
 
 #include "ECS.h"
 #include "EventBus.h"
+#include "FramePacer.h"
+#include "GameThread.h"
 #include "AudioManager.h"
 #include "CameraManager.h"
 #include "Renderer.h"
@@ -15,6 +17,9 @@
 #include "SceneManager.h"
 #include "Actor.h"
 #include "Rigidbody.h"
+#include "RigidbodyPool.h"
+#include "TriggerBroadphase.h"
+#include "PhysicsQuery.h"
 #include "Raycaster.h"
 
 namespace App {
@@ -49,6 +54,7 @@ void ECS::initialize_functions() {
   reg_scene_manager();
   reg_actor_class();
   reg_rigidbody_class();
+  reg_trigger_volume_class();
   reg_actor_static_namespace();
   reg_contact_class();
   reg_raycaster_class();
@@ -102,6 +108,7 @@ void ECS::reg_application_namespace() {
       .addFunction("Quit", &Lua_App_Quit)
       .addFunction("Sleep", &Lua_App_Sleep)
       .addFunction("GetFrame", &Lua_App_GetFrame)
+      .addFunction("GetFrameStats", &Lua_App_GetFrameStats)
       .addFunction("OpenURL", &Lua_App_OpenURL)
       .endNamespace();
 }
@@ -131,6 +138,15 @@ void ECS::reg_renderer() {
       .addStaticFunction("Draw", &Renderer::LuaDraw)
       .addStaticFunction("DrawEx", &Renderer::LuaDrawEx)
       .addStaticFunction("DrawPixel", &Renderer::LuaDrawPixel)
+      .addStaticFunction("DrawPixels", &Renderer::LuaDrawPixels)
+      .addStaticFunction("GetStats", &Renderer::LuaGetRenderStats)
+      .addStaticFunction("Preload", &Renderer::LuaPreload)
+      .addStaticFunction("GetTextureStats", &Renderer::LuaGetTextureStats)
+      .addStaticFunction("SetLayer", &Renderer::LuaSetLayer)
+      .addStaticFunction("SetLayerOffset", &Renderer::LuaSetLayerOffset)
+      .addStaticFunction("BeginLayer", &Renderer::LuaBeginLayer)
+      .addStaticFunction("EndLayer", &Renderer::LuaEndLayer)
+      .addStaticFunction("InvalidateLayer", &Renderer::LuaInvalidateLayer)
       .endClass()
 
       .beginClass<Renderer>("Text")
@@ -185,8 +201,48 @@ void ECS::reg_actor_static_namespace() {
       .addFunction("FindAll", &SceneManager::GetActors)
       .addFunction("Instantiate", &Actor::LuaCreateActor)
       .addFunction("Destroy", &Actor::LuaDestroyActor)
+      .addFunction("FindInRadius", &SceneManager::LuaFindInRadius)
+      .addFunction("FindInRect", &SceneManager::LuaFindInRect)
+      .endNamespace()
+      .beginNamespace("Spatial")
+      .addFunction("Update", &SceneManager::LuaSpatialUpdate)
+      .addFunction("Remove", &SceneManager::LuaSpatialRemove)
       .endNamespace();
 }
+namespace {
+// Lua reaches pooled component methods (Rigidbody, TriggerVolume) through
+// this. A script holding on to a destroyed actor's component gets an error
+// instead of a quiet no-op.
+template <typename T>
+void require_live(const T* component) {
+  if (not component->released)
+    return;
+  std::cout << "error: " << component->type << " " << component->key
+            << " used after its actor was destroyed";
+  GameThread::quit(0);
+}
+
+template <auto Method>
+struct Live;
+template <typename T, typename R, typename... Args, R (T::*Method)(Args...)>
+struct Live<Method> {
+  static R call(T* component, Args... args) {
+    require_live(component);
+    return (component->*Method)(args...);
+  }
+};
+template <typename T,
+          typename R,
+          typename... Args,
+          R (T::*Method)(Args...) const>
+struct Live<Method> {
+  static R call(T* component, Args... args) {
+    require_live(component);
+    return (component->*Method)(args...);
+  }
+};
+}  // namespace
+
 void ECS::reg_rigidbody_class() {
   luabridge::getGlobalNamespace(lua_state)
       .beginClass<Rigidbody>("Rigidbody")
@@ -194,6 +250,8 @@ void ECS::reg_rigidbody_class() {
       .addData("y", &Rigidbody::y)
       .addData("body_type", &Rigidbody::body_type)
       .addData("precise", &Rigidbody::precise)
+      .addData("auto_ccd", &Rigidbody::auto_ccd)
+      .addData("allow_sleep", &Rigidbody::allow_sleep)
       .addData("gravity_scale", &Rigidbody::gravity_scale)
       .addData("density", &Rigidbody::density)
       .addData("angular_friction", &Rigidbody::angular_friction)
@@ -211,29 +269,60 @@ void ECS::reg_rigidbody_class() {
       .addData("bounciness", &Rigidbody::bounciness)
       .addData("friction", &Rigidbody::friction)
 
+      .addData("layer", &Rigidbody::layer)
+      .addData("collides_with", &Rigidbody::collides_with)
       .addData("trigger_type", &Rigidbody::trigger_type)
       .addData("trigger_width", &Rigidbody::trigger_width)
       .addData("trigger_height", &Rigidbody::trigger_height)
       .addData("trigger_radius", &Rigidbody::trigger_radius)
 
-      .addFunction("OnStart", &Rigidbody::Initialize)
+      .addFunction("OnStart", &Live<&Rigidbody::Initialize>::call)
       .addFunction("OnDestroy", &Rigidbody::Destroy)
-      .addFunction("GetPosition", &Rigidbody::GetPosition)
-      .addFunction("SetPosition", &Rigidbody::SetPosition)
-      .addFunction("GetRotation", &Rigidbody::GetRotation)
-      .addFunction("SetRotation", &Rigidbody::SetRotation)
+      .addFunction("GetPosition", &Live<&Rigidbody::GetPosition>::call)
+      .addFunction("IsBullet", &Live<&Rigidbody::IsBullet>::call)
+      .addFunction("IsAwake", &Live<&Rigidbody::IsAwake>::call)
+      .addFunction("SetAwake", &Live<&Rigidbody::SetAwake>::call)
+      .addFunction("SetPosition", &Live<&Rigidbody::SetPosition>::call)
+      .addFunction("GetRotation", &Live<&Rigidbody::GetRotation>::call)
+      .addFunction("SetRotation", &Live<&Rigidbody::SetRotation>::call)
+
+      .addFunction("AddForce", &Live<&Rigidbody::AddForce>::call)
+      .addFunction("SetVelocity", &Live<&Rigidbody::SetVelocity>::call)
+      .addFunction("SetAngularVelocity",
+                   &Live<&Rigidbody::SetAngularVelocity>::call)
+      .addFunction("SetGravityScale", &Live<&Rigidbody::SetGravityScale>::call)
+      .addFunction("SetUpDirection", &Live<&Rigidbody::SetUpDirection>::call)
+      .addFunction("SetRightDirection",
+                   &Live<&Rigidbody::SetRightDirection>::call)
+      .addFunction("GetVelocity", &Live<&Rigidbody::GetVelocity>::call)
+      .addFunction("GetAngularVelocity",
+                   &Live<&Rigidbody::GetAngularVelocity>::call)
+      .addFunction("GetGravityScale", &Live<&Rigidbody::GetGravityScale>::call)
+      .addFunction("GetUpDirection", &Live<&Rigidbody::GetUpDirection>::call)
+      .addFunction("GetRightDirection",
+                   &Live<&Rigidbody::GetRightDirection>::call)
+      .endClass();
+}
 
-      .addFunction("AddForce", &Rigidbody::AddForce)
-      .addFunction("SetVelocity", &Rigidbody::SetVelocity)
-      .addFunction("SetAngularVelocity", &Rigidbody::SetAngularVelocity)
-      .addFunction("SetGravityScale", &Rigidbody::SetGravityScale)
-      .addFunction("SetUpDirection", &Rigidbody::SetUpDirection)
-      .addFunction("SetRightDirection", &Rigidbody::SetRightDirection)
-      .addFunction("GetVelocity", &Rigidbody::GetVelocity)
-      .addFunction("GetAngularVelocity", &Rigidbody::GetAngularVelocity)
-      .addFunction("GetGravityScale", &Rigidbody::GetGravityScale)
-      .addFunction("GetUpDirection", &Rigidbody::GetUpDirection)
-      .addFunction("GetRightDirection", &Rigidbody::GetRightDirection)
+void ECS::reg_trigger_volume_class() {
+  luabridge::getGlobalNamespace(lua_state)
+      .beginClass<TriggerVolume>("TriggerVolume")
+      .addData("x", &TriggerVolume::x)
+      .addData("y", &TriggerVolume::y)
+      .addData("trigger_type", &TriggerVolume::trigger_type)
+      .addData("width", &TriggerVolume::width)
+      .addData("height", &TriggerVolume::height)
+      .addData("radius", &TriggerVolume::radius)
+      .addData("layer", &TriggerVolume::layer)
+      .addData("collides_with", &TriggerVolume::collides_with)
+      .addData("type", &TriggerVolume::type)
+      .addData("key", &TriggerVolume::key)
+      .addData("actor", &TriggerVolume::actor)
+      .addData("enabled", &TriggerVolume::enabled)
+      .addFunction("OnStart", &Live<&TriggerVolume::Initialize>::call)
+      .addFunction("OnDestroy", &TriggerVolume::Destroy)
+      .addFunction("GetPosition", &Live<&TriggerVolume::GetPosition>::call)
+      .addFunction("SetPosition", &Live<&TriggerVolume::SetPosition>::call)
       .endClass();
 }
 void ECS::reg_vector2() {
@@ -282,11 +371,19 @@ void ECS::reg_raycaster_class() {
                    &RaycastResult::SetNormal)
       .addProperty("is_trigger", &RaycastResult::IsTrigger,
                    &RaycastResult::SetTrigger)
+      .addProperty("fraction", &RaycastResult::GetFraction,
+                   &RaycastResult::SetFraction)
       .endClass()
 
       .beginClass<Raycaster>("Physics")
       .addStaticFunction("Raycast", &Raycaster::LuaRaycast)
       .addStaticFunction("RaycastAll", &Raycaster::LuaRaycastAll)
+      .addStaticFunction("RaycastBatch", &Raycaster::LuaRaycastBatch)
+      .addStaticFunction("OverlapBox", &PhysicsQuery::LuaOverlapBox)
+      .addStaticFunction("OverlapCircle", &PhysicsQuery::LuaOverlapCircle)
+      .addStaticFunction("OverlapPolygon", &PhysicsQuery::LuaOverlapPolygon)
+      .addStaticFunction("ShapeCast", &PhysicsQuery::LuaShapeCast)
+      .addStaticFunction("GetStats", &SceneManager::LuaGetPhysicsStats)
       .endClass();
 }
 void ECS::reg_eventbus_class() {
@@ -304,18 +401,28 @@ std::pair<ECS::ComponentType, luabridge::LuaRef> ECS::create_component(
   if (name == "Rigidbody") {
     // Special C++ component
     SceneManager::getInstance().CreatePhysWorld();
-    auto* rigidbody = new Rigidbody();
+    auto* rigidbody = RigidbodyPool::getInstance().acquire();
     rigidbody->key = key;
     rigidbody->type = name;
     luabridge::LuaRef component(lua_state, rigidbody);
     component["key"] = key;
     component["type"] = name;
+    RigidbodyPool::getInstance().track(rigidbody, component);
+    return {ECS::ComponentType::CPP, component};
+  } else if (name == "TriggerVolume") {
+    auto* volume = TriggerBroadphase::getInstance().acquire();
+    volume->key = key;
+    volume->type = name;
+    luabridge::LuaRef component(lua_state, volume);
+    component["key"] = key;
+    component["type"] = name;
+    TriggerBroadphase::getInstance().track(volume, component);
     return {ECS::ComponentType::CPP, component};
   } else {
     // Basic Lua component
     if (component_registry.find(name) == component_registry.end()) {
       std::cout << "error: failed to locate component " << name;
-      std::exit(0);
+      GameThread::quit(0);
     }
     luabridge::LuaRef component = luabridge::newTable(lua_state);
     establish_inheritance(component, component_registry.at(name));
@@ -337,11 +444,26 @@ void ECS::Lua_LogError(const std::string& message) {
 int ECS::Lua_App_GetFrame() {
   return Helper::GetFrameNumber();
 }
+// frame times in ms over the last FrameTimeHistogram::WINDOW presents
+luabridge::LuaRef ECS::Lua_App_GetFrameStats() {
+  FramePacer& pacer = FramePacer::getInstance();
+  const auto summary = pacer.get_summary();
+  luabridge::LuaRef stats = luabridge::newTable(getInstance().lua_state);
+  stats["p50"] = summary.p50;
+  stats["p95"] = summary.p95;
+  stats["p99"] = summary.p99;
+  stats["max"] = summary.max;
+  stats["mean"] = summary.mean;
+  stats["samples"] = static_cast<int>(summary.samples);
+  stats["target"] = pacer.get_target_rate();
+  stats["vsync"] = pacer.is_yielding_to_vsync();
+  return stats;
+}
 void ECS::Lua_App_Sleep(const int ms) {
   std::this_thread::sleep_for(std::chrono::milliseconds(ms));
 }
 void ECS::Lua_App_Quit() {
-  exit(0);
+  GameThread::quit(0);
 }
 void ECS::Lua_App_OpenURL(const std::string& url) {
 #if defined(_WIN32)  // Windows
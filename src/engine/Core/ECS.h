@@ -46,6 +46,12 @@ class ECS {
   [[nodiscard]] base_component_map get_component_registry() const {
     return component_registry;
   }
+  // null for unknown types, and for the C++ ones
+  [[nodiscard]] const luabridge::LuaRef* find_component_type(
+      const std::string& name) const {
+    const auto it = component_registry.find(name);
+    return it == component_registry.end() ? nullptr : &it->second;
+  }
 
   const std::filesystem::path COMPONENTS_DIR = Resources::game_path() / "component_types";
 
@@ -71,6 +77,7 @@ class ECS {
   void reg_actor_class();
   void reg_actor_static_namespace();
   void reg_rigidbody_class();
+  void reg_trigger_volume_class();
   void reg_contact_class();
   void reg_raycaster_class();
   void reg_eventbus_class();
@@ -80,6 +87,7 @@ class ECS {
   static void Lua_Log(const std::string& message);
   static void Lua_LogError(const std::string& message);
   static int Lua_App_GetFrame();
+  static luabridge::LuaRef Lua_App_GetFrameStats();
   static void Lua_App_Sleep(int ms);
   static void Lua_App_Quit();
   static void Lua_App_OpenURL(const std::string& url);
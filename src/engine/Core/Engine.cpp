@@ -8,8 +8,13 @@
 #include "CameraManager.h"
 #include "EngineUtils.h"
 #include "EventBus.h"
+#include "FrameCapture.h"
+#include "FramePacer.h"
+#include "GameThread.h"
 #include "InputManager.h"
 #include "Helper.h"
+#include "PhysicsConfig.h"
+#include "PhysicsDebugDraw.h"
 
 void Engine::initialize() {
   const std::string game_config_path =
@@ -21,6 +26,9 @@ void Engine::initialize() {
   SceneManager& scene_manager = SceneManager::getInstance();
 
   renderer.initialize(game_config);
+  PhysicsConfig::getInstance().initialize();
+  scene_manager.spatial_hash.set_cell_size(
+      PhysicsConfig::getInstance().spatial_cell_size);
   scene_manager.initialize(game_config);
   CameraManager::initialize();
   AudioManager::initialize();
@@ -40,25 +48,23 @@ void Engine::stop_game() {
 void Engine::run_game() {
   Renderer& renderer = Renderer::getInstance();
   SceneManager& scene_manager = SceneManager::getInstance();
+  FramePacer& pacer = FramePacer::getInstance();
+  FrameCapture& capture = FrameCapture::getInstance();
 
   if (not engine_running) {
    engine_running = true;
-   SDL_ShowWindow(renderer.get_game_window());
-   SDL_RaiseWindow(renderer.get_game_window());
+   if (not renderer.is_headless()) {
+     SDL_ShowWindow(renderer.get_game_window());
+     SDL_RaiseWindow(renderer.get_game_window());
+   }
   //  initialize();
   }
 
+  if (renderer.is_game_loop_threaded())
+    return run_game_threaded();
+
   while (engine_running) {
-    SDL_Event input_event{};
-    while (SDL_PollEvent(&input_event)) {
-      if (input_event.type == SDL_QUIT) {
-        set_engine_off();
-      }
-      if (input_event.window.windowID == renderer.m_window->get_id()) {
-        on_game_window_event(input_event.window);
-        InputManager::ProcessEvent(input_event);
-      }
-    }
+    poll_events();
     SDL_SetRenderDrawColor(renderer.get_sdl_renderer(), 0, 0, 0, 255);
     SDL_RenderClear(renderer.get_sdl_renderer());
 
@@ -73,14 +79,111 @@ void Engine::run_game() {
     App::EventBus::ProcessPendingSubscriptions();
     App::EventBus::ProcessPendingUnsubscriptions();
 
-    if (not is_game_over and not is_game_won)
+    // pipelined physics: last frame's step ran alongside the update above
+    scene_manager.SyncPhysWorld();
+    scene_manager.UpdateTriggerVolumes();
+
+    if (not is_game_over and not is_game_won) {
       renderer.end_of_frame_render();
+      scene_manager.RenderPhysicsDebug();
+    }
 
     InputManager::LateUpdate();
 
+    // returns right away when pipelined, see SyncPhysWorld
     scene_manager.StepPhysWorld();
 
+    capture.capture(renderer.get_sdl_renderer(), frames_run);
+    pacer.wait();
+    SDL_RenderPresent(renderer.get_sdl_renderer());
+    pacer.frame_presented();
+    count_frame();
+  }
+}
+
+// The game thread simulates frame N+1 while this thread draws and presents
+// frame N. Input, the physics debug shapes and the frame swap all happen in
+// the gap where the game thread is parked, so neither side ever sees the
+// other's half written state.
+void Engine::run_game_threaded() {
+  Renderer& renderer = Renderer::getInstance();
+  SceneManager& scene_manager = SceneManager::getInstance();
+  GameThread& game_thread = GameThread::getInstance();
+  FramePacer& pacer = FramePacer::getInstance();
+  FrameCapture& capture = FrameCapture::getInstance();
+
+  while (engine_running) {
+    game_thread.wait();
+    InputManager::LateUpdate();
+    poll_events();
+    if (not engine_running)
+      break;
+
+    renderer.swap_frames();
+    scene_manager.CollectPhysicsDebug();
+    game_thread.kick([this] { simulate_frame(); });
+
+    SDL_SetRenderDrawColor(renderer.get_sdl_renderer(), 0, 0, 0, 255);
+    SDL_RenderClear(renderer.get_sdl_renderer());
+    if (not is_game_over and not is_game_won) {
+      renderer.end_of_frame_render();
+      PhysicsDebugDraw::getInstance().submit(renderer.get_sdl_renderer());
+    }
+    capture.capture(renderer.get_sdl_renderer(), frames_run);
+    pacer.wait();
     SDL_RenderPresent(renderer.get_sdl_renderer());
+    pacer.frame_presented();
+    count_frame();
+  }
+  game_thread.wait();
+}
+
+void Engine::set_headless(const bool value) {
+  Renderer::getInstance().set_headless(value);
+  AudioManager::set_enabled(not value);
+}
+
+void Engine::count_frame() {
+  frames_run++;
+  if (frame_limit > 0 and frames_run >= frame_limit)
+    engine_running = false;
+}
+
+// Everything in a frame that isn't input or drawing, on the game thread.
+void Engine::simulate_frame() {
+  SceneManager& scene_manager = SceneManager::getInstance();
+  scene_manager.update_scene_actors();
+
+  if (SceneManager::latest_scene_change_request) {
+    scene_manager.trigger_scene_change(
+        *SceneManager::latest_scene_change_request);
+    SceneManager::latest_scene_change_request.reset();
+  }
+
+  App::EventBus::ProcessPendingSubscriptions();
+  App::EventBus::ProcessPendingUnsubscriptions();
+
+  scene_manager.SyncPhysWorld();
+  scene_manager.UpdateTriggerVolumes();
+  scene_manager.StepPhysWorld();
+}
+
+void Engine::poll_events() {
+  Renderer& renderer = Renderer::getInstance();
+  SDL_Event input_event{};
+  while (SDL_PollEvent(&input_event)) {
+    if (input_event.type == SDL_QUIT) {
+      set_engine_off();
+    }
+    // the driver lost every target texture, cached layers get drawn again
+    if (input_event.type == SDL_RENDER_TARGETS_RESET or
+        input_event.type == SDL_RENDER_DEVICE_RESET) {
+      renderer.drop_layer_caches();
+    }
+    if (input_event.window.windowID == renderer.m_window->get_id()) {
+      on_game_window_event(input_event.window);
+      InputManager::ProcessEvent(input_event);
+    }
   }
 }
 
@@ -111,6 +214,9 @@ void Engine::reset() {
   rapidjson::Document game_config;
   EngineUtils::ReadJsonFile(game_config_path, game_config);
 
+  PhysicsConfig::getInstance().initialize();
   SceneManager& scene_manager = SceneManager::getInstance();
+  scene_manager.spatial_hash.set_cell_size(
+      PhysicsConfig::getInstance().spatial_cell_size);
   scene_manager.initialize(game_config);
 }
@@ -25,6 +25,15 @@ class Engine {
 
   void reset();
 
+  // before initialize: offscreen software renderer, no audio, uncapped
+  void set_headless(bool value);
+  // run_game returns after this many frames, 0 runs until the game quits
+  void set_frame_limit(int frames) {
+    frame_limit = frames;
+    frames_run = 0;
+  }
+  [[nodiscard]] int get_frames_run() const { return frames_run; }
+
   void on_game_window_event(const SDL_WindowEvent& event);
 
   void set_engine_off() {
@@ -45,9 +54,16 @@ class Engine {
   }
 
  private:
+  void run_game_threaded();
+  void simulate_frame();
+  void poll_events();
+  void count_frame();
+
   bool engine_running{false};
   bool is_game_over{false};
   bool is_game_won{false};
+  int frame_limit{0};
+  int frames_run{0};
 
   std::thread m_game_thread;
   std::queue<std::string> scene_change_queue;
@@ -17,6 +17,8 @@
 
 #include <box2d/box2d.h>
 
+#include "GameThread.h"
+
 class EngineUtils {
  public:
   enum class MoveIntent {
@@ -75,7 +77,7 @@ class EngineUtils {
       const rapidjson::ParseErrorCode errorCode = out_document.GetParseError();
       std::cout << "error parsing json at [" << path << "]" << std::endl;
       std::cout << "error code : " << errorCode << std::endl;
-      exit(0);
+      GameThread::quit(0);
     }
   }
 
@@ -121,33 +123,13 @@ class EngineUtils {
   //      (old) in update need new hash
 
   static bool is_phantom_fixture(const b2Fixture* fixture) {
-    const auto& filter_data = fixture->GetFilterData();
-    return (filter_data.categoryBits & filter_data.maskBits) == 0;
+    // a layer may legitimately not collide with itself, only phantoms have
+    // no category at all
+    return fixture->GetFilterData().categoryBits == 0;
   }
 };
 
 enum class IMGType { Scene, UI, Pixel };
-struct IMGRenderRequest {
-  IMGType type;
-  std::string image_name;
-  float x, y;
-  int render_order = 0;
-
-  int r = 255, g = 255, b = 255, a = 255;
-  float pivot_x = -1.0f, pivot_y = -1.0f;
-  float rotation_degrees = 0.0f, scale_x = 1.0f, scale_y = 1.0f;
-
-  IMGRenderRequest(IMGType type,
-                   std::string image_name,
-                   float x,
-                   float y,
-                   int render_order = 0)
-      : type(type),
-        image_name(std::move(image_name)),
-        x(x),
-        y(y),
-        render_order(render_order) {}
-};
 
 
 #endif  // PULSAR_SRC_ENGINE_CORE_ENGINEUTILS_H_
@@ -0,0 +1,180 @@
+#include "FrameCapture.h"
+
+#include <SDL2_image/SDL_image.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "JobSystem.h"
+#include "QoiEncoder.h"
+
+// Made first so it's destroyed after us, flush() needs the workers.
+FrameCapture::FrameCapture() {
+  JobSystem::getInstance();
+}
+
+FrameCapture::~FrameCapture() {
+  flush();
+}
+
+void FrameCapture::configure(const Settings& new_settings) {
+  flush();
+  settings = new_settings;
+  settings.every = std::max(1, settings.every);
+  settings.ring_size = std::max<size_t>(1, settings.ring_size);
+  ring = std::vector<Slot>(settings.ring_size);
+  written = 0;
+  dropped = 0;
+
+  std::error_code error;
+  std::filesystem::create_directories(settings.directory, error);
+  if (error) {
+    std::cout << "error: can't create capture directory " << settings.directory;
+    std::exit(0);
+  }
+  enabled = true;
+}
+
+bool FrameCapture::selects(const Settings& settings, const int frame) {
+  if (frame < settings.first_frame)
+    return false;
+  if (settings.last_frame >= 0 and frame > settings.last_frame)
+    return false;
+  return (frame - settings.first_frame) % std::max(1, settings.every) == 0;
+}
+
+bool FrameCapture::wants(const int frame) const {
+  return enabled and selects(settings, frame);
+}
+
+void FrameCapture::capture(SDL_Renderer* renderer, const int frame) {
+  if (not wants(frame))
+    return;
+  Slot* slot = acquire_slot();
+  if (slot == nullptr) {
+    dropped++;
+    return;
+  }
+
+  int width = 0;
+  int height = 0;
+  SDL_GetRendererOutputSize(renderer, &width, &height);
+  slot->pixels.resize(static_cast<size_t>(width) * height * 4);
+  slot->width = width;
+  slot->height = height;
+  slot->frame = frame;
+  if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_RGBA32,
+                           slot->pixels.data(), width * 4) != 0) {
+    SDL_Log("SDL_RenderReadPixels() failed: %s", SDL_GetError());
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    slot->busy = false;
+    return;
+  }
+
+  JobSystem::getInstance().submit([this, slot] {
+    write(*slot);
+    // notify under the lock, flush() in our destructor may be waiting
+    std::lock_guard<std::mutex> lock(ring_mutex);
+    slot->busy = false;
+    ring_cv.notify_all();
+  });
+}
+
+FrameCapture::Slot* FrameCapture::acquire_slot() {
+  std::unique_lock<std::mutex> lock(ring_mutex);
+  auto find_free = [this]() -> Slot* {
+    for (auto& slot : ring)
+      if (not slot.busy)
+        return &slot;
+    return nullptr;
+  };
+  Slot* slot = find_free();
+  if (slot == nullptr and not settings.drop_when_busy) {
+    ring_cv.wait(lock, [&] { return (slot = find_free()) != nullptr; });
+  }
+  if (slot != nullptr)
+    slot->busy = true;
+  return slot;
+}
+
+void FrameCapture::flush() {
+  std::unique_lock<std::mutex> lock(ring_mutex);
+  ring_cv.wait(lock, [this] {
+    for (const auto& slot : ring)
+      if (slot.busy)
+        return false;
+    return true;
+  });
+}
+
+// on a JobSystem worker
+void FrameCapture::write(Slot& slot) {
+  const std::string path =
+      (std::filesystem::path(settings.directory) /
+       file_name(slot.frame, settings.format))
+          .string();
+  const int pitch = slot.width * 4;
+
+  if (settings.format == Format::QOI) {
+    const auto encoded =
+        Qoi::encode(slot.pixels.data(), slot.width, slot.height, pitch);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(encoded.data()),
+               static_cast<std::streamsize>(encoded.size()));
+    if (not file) {
+      SDL_Log("FrameCapture: failed to write %s", path.c_str());
+      return;
+    }
+  } else {
+    // wraps the slot's pixels, nothing is copied
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(
+        slot.pixels.data(), slot.width, slot.height, 32, pitch,
+        SDL_PIXELFORMAT_RGBA32);
+    if (surface == nullptr) {
+      SDL_Log("FrameCapture: %s", SDL_GetError());
+      return;
+    }
+    const int result = settings.format == Format::PNG
+                           ? IMG_SavePNG(surface, path.c_str())
+                           : SDL_SaveBMP(surface, path.c_str());
+    SDL_FreeSurface(surface);
+    if (result != 0) {
+      SDL_Log("FrameCapture: failed to write %s: %s", path.c_str(),
+              SDL_GetError());
+      return;
+    }
+  }
+  written++;
+}
+
+bool FrameCapture::parse_format(const std::string& name, Format& format) {
+  if (name == "bmp")
+    format = Format::BMP;
+  else if (name == "png")
+    format = Format::PNG;
+  else if (name == "qoi")
+    format = Format::QOI;
+  else
+    return false;
+  return true;
+}
+
+std::string FrameCapture::file_name(const int frame, const Format format) {
+  std::stringstream name;
+  name << "frame_" << std::setw(5) << std::setfill('0') << frame;
+  switch (format) {
+    case Format::BMP:
+      name << ".bmp";
+      break;
+    case Format::PNG:
+      name << ".png";
+      break;
+    case Format::QOI:
+      name << ".qoi";
+      break;
+  }
+  return name.str();
+}
@@ -0,0 +1,113 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+void FramePacer::configure(SDL_Renderer* renderer, SDL_Window* window,
+                           const int target) {
+  SDL_RendererInfo info;
+  vsync = renderer != nullptr and SDL_GetRendererInfo(renderer, &info) == 0 and
+          (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+
+  SDL_DisplayMode mode;
+  const int display = window != nullptr ? SDL_GetWindowDisplayIndex(window) : 0;
+  refresh_rate = 0;
+  if (display >= 0 and SDL_GetCurrentDisplayMode(display, &mode) == 0)
+    refresh_rate = mode.refresh_rate;
+
+  set_target_rate(target);
+}
+
+void FramePacer::set_target_rate(const int target) {
+  target_rate = std::max(0, target);
+  frequency = SDL_GetPerformanceFrequency();
+  period = target_rate > 0 ? frequency / static_cast<uint64_t>(target_rate) : 0;
+  next_deadline = 0;
+
+  // drivers report 0 when they don't know, most of those are 60 Hz panels
+  const int refresh = refresh_rate > 0 ? refresh_rate : 60;
+  yield_to_vsync = vsync and target_rate >= refresh;
+  vsync_probed = false;
+
+  std::lock_guard<std::mutex> lock(histogram_mutex);
+  histogram.clear();
+}
+
+void FramePacer::wait() {
+  if (period == 0 or yield_to_vsync)
+    return;
+
+  const uint64_t now = SDL_GetPerformanceCounter();
+  // first frame, or a whole frame behind (a load, a breakpoint): start the
+  // schedule over rather than rushing frames out to catch up
+  if (next_deadline == 0 or now >= next_deadline + period) {
+    next_deadline = now + period;
+    return;
+  }
+  sleep_until(next_deadline);
+  next_deadline += period;
+}
+
+void FramePacer::sleep_until(const uint64_t deadline) const {
+  const uint64_t spin_ticks =
+      static_cast<uint64_t>(SPIN_MS * static_cast<double>(frequency) / 1000.0);
+  for (uint64_t now = SDL_GetPerformanceCounter(); now < deadline;
+       now = SDL_GetPerformanceCounter()) {
+    const uint64_t remaining = deadline - now;
+    if (remaining > spin_ticks) {
+      const auto sleep_ms =
+          static_cast<Uint32>((remaining - spin_ticks) * 1000 / frequency);
+      ::SDL_Delay(std::max<Uint32>(sleep_ms, 1));
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void FramePacer::frame_presented() {
+  if (frequency == 0)
+    frequency = SDL_GetPerformanceFrequency();
+  const uint64_t now = SDL_GetPerformanceCounter();
+  if (last_present != 0) {
+    const double frame_ms =
+        static_cast<double>(now - last_present) * 1000.0 /
+        static_cast<double>(frequency);
+    std::lock_guard<std::mutex> lock(histogram_mutex);
+    histogram.add(frame_ms);
+  }
+  last_present = now;
+
+  if (yield_to_vsync and not vsync_probed)
+    probe_vsync();
+}
+
+// Some drivers hand back a vsync renderer and then don't block in present
+// (forced off in the control panel, minimized windows, etc.), which would
+// leave the loop running flat out. If presents come back well under a
+// refresh period, pace ourselves after all.
+void FramePacer::probe_vsync() {
+  double p50 = 0.0;
+  {
+    std::lock_guard<std::mutex> lock(histogram_mutex);
+    if (histogram.size() < VSYNC_PROBE_FRAMES)
+      return;
+    p50 = histogram.percentile(0.5);
+  }
+  vsync_probed = true;
+  const int refresh = refresh_rate > 0 ? refresh_rate : 60;
+  const double refresh_ms = 1000.0 / refresh;
+  if (p50 < refresh_ms * 0.8) {
+    yield_to_vsync = false;
+    next_deadline = 0;
+  }
+}
+
+FrameTimeHistogram::Summary FramePacer::get_summary() {
+  std::lock_guard<std::mutex> lock(histogram_mutex);
+  return histogram.summarize();
+}
+
+void FramePacer::for_each_sample(const std::function<void(float)>& fn) {
+  std::lock_guard<std::mutex> lock(histogram_mutex);
+  histogram.for_each_sample(fn);
+}
@@ -0,0 +1,73 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_FRAMEPACER_H_
+#define PULSAR_SRC_ENGINE_CORE_FRAMEPACER_H_
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include "FrameTimeHistogram.h"
+
+// Holds the main loop to rendering.config's "target_frame_rate" off the
+// performance counter: SDL_Delay for most of the wait, then spin the last
+// couple of ms since SDL_Delay can overshoot by a whole scheduler tick.
+// When the renderer presents with vsync at (or below) the target rate the
+// present already blocks, so we get out of its way. Every present also
+// lands in a FrameTimeHistogram for Application.GetFrameStats and the editor.
+class FramePacer {
+  FramePacer() = default;
+  ~FramePacer() = default;
+
+ public:
+  FramePacer(const FramePacer&) = delete;
+  FramePacer& operator=(const FramePacer&) = delete;
+  FramePacer(FramePacer&&) = delete;
+  FramePacer& operator=(FramePacer&&) = delete;
+
+  static FramePacer& getInstance() {
+    static FramePacer instance;
+    return instance;
+  }
+
+  // 0 leaves the frame rate to vsync (or nothing)
+  static constexpr int DEFAULT_TARGET_RATE = 60;
+  // closer than this to the deadline we spin instead of sleeping
+  static constexpr double SPIN_MS = 2.0;
+  // frames to watch before deciding whether vsync really blocks
+  static constexpr size_t VSYNC_PROBE_FRAMES = 120;
+
+  void configure(SDL_Renderer* renderer, SDL_Window* window, int target_rate);
+  void set_target_rate(int target_rate);
+
+  // Call right before SDL_RenderPresent.
+  void wait();
+  // Call right after, records the present to present time.
+  void frame_presented();
+
+  // any thread
+  [[nodiscard]] FrameTimeHistogram::Summary get_summary();
+  void for_each_sample(const std::function<void(float)>& fn);
+
+  [[nodiscard]] int get_target_rate() const { return target_rate; }
+  [[nodiscard]] int get_refresh_rate() const { return refresh_rate; }
+  [[nodiscard]] bool is_yielding_to_vsync() const { return yield_to_vsync; }
+
+ private:
+  void sleep_until(uint64_t deadline) const;
+  void probe_vsync();
+
+  int target_rate = DEFAULT_TARGET_RATE;
+  int refresh_rate = 0;
+  bool vsync = false;
+  bool yield_to_vsync = false;
+  bool vsync_probed = false;
+
+  uint64_t frequency = 0;
+  uint64_t period = 0;  // counter ticks per frame, 0 when uncapped
+  uint64_t next_deadline = 0;
+  uint64_t last_present = 0;
+
+  std::mutex histogram_mutex;
+  FrameTimeHistogram histogram;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_FRAMEPACER_H_
@@ -0,0 +1,68 @@
+#include "FrameTimeHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+size_t FrameTimeHistogram::bucket_of(float frame_ms) {
+  if (not (frame_ms > 0.0f))
+    return 0;
+  const auto bucket = static_cast<size_t>(frame_ms / BUCKET_MS);
+  return std::min(bucket, BUCKETS - 1);
+}
+
+void FrameTimeHistogram::add(double frame_ms) {
+  const auto sample = static_cast<float>(frame_ms);
+  if (count == WINDOW) {
+    const float oldest = samples[next];
+    buckets[bucket_of(oldest)]--;
+    sum -= oldest;
+  } else {
+    count++;
+  }
+  samples[next] = sample;
+  buckets[bucket_of(sample)]++;
+  sum += sample;
+  next = (next + 1) % WINDOW;
+}
+
+void FrameTimeHistogram::clear() {
+  buckets.fill(0);
+  next = 0;
+  count = 0;
+  sum = 0.0;
+}
+
+double FrameTimeHistogram::percentile(double p) const {
+  if (count == 0)
+    return 0.0;
+  const auto rank = static_cast<size_t>(
+      std::max(1.0, std::ceil(p * static_cast<double>(count))));
+  size_t seen = 0;
+  for (size_t bucket = 0; bucket < BUCKETS; bucket++) {
+    seen += buckets[bucket];
+    if (seen >= rank)
+      return std::min(static_cast<double>(bucket + 1) * BUCKET_MS, max());
+  }
+  return max();
+}
+
+double FrameTimeHistogram::max() const {
+  float longest = 0.0f;
+  for_each_sample([&longest](float sample) {
+    longest = std::max(longest, sample);
+  });
+  return longest;
+}
+
+FrameTimeHistogram::Summary FrameTimeHistogram::summarize() const {
+  Summary summary;
+  summary.samples = count;
+  if (count == 0)
+    return summary;
+  summary.p50 = percentile(0.50);
+  summary.p95 = percentile(0.95);
+  summary.p99 = percentile(0.99);
+  summary.max = max();
+  summary.mean = sum / static_cast<double>(count);
+  return summary;
+}
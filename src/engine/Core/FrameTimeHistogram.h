@@ -0,0 +1,53 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_FRAMETIMEHISTOGRAM_H_
+#define PULSAR_SRC_ENGINE_CORE_FRAMETIMEHISTOGRAM_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The last WINDOW frame times, kept both as a ring (for max and plotting)
+// and as 0.1 ms buckets, so percentiles are a walk over the buckets rather
+// than a sort. Anything past the last bucket lands in it.
+class FrameTimeHistogram {
+ public:
+  static constexpr size_t WINDOW = 600;  // 10 s at 60 Hz
+  static constexpr double BUCKET_MS = 0.1;
+  static constexpr size_t BUCKETS = 1000;  // up to 100 ms
+
+  struct Summary {
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    size_t samples = 0;
+  };
+
+  void add(double frame_ms);
+  void clear();
+
+  // upper edge of the bucket holding the p-th sample, capped at max
+  [[nodiscard]] double percentile(double p) const;
+  [[nodiscard]] double max() const;
+  [[nodiscard]] Summary summarize() const;
+  [[nodiscard]] size_t size() const { return count; }
+
+  // oldest first
+  template <typename Fn>
+  void for_each_sample(Fn&& fn) const {
+    const size_t first = (next + WINDOW - count) % WINDOW;
+    for (size_t i = 0; i < count; i++)
+      fn(samples[(first + i) % WINDOW]);
+  }
+
+ private:
+  static size_t bucket_of(float frame_ms);
+
+  std::array<float, WINDOW> samples{};
+  std::array<uint16_t, BUCKETS> buckets{};
+  size_t next = 0;
+  size_t count = 0;
+  double sum = 0.0;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_FRAMETIMEHISTOGRAM_H_
@@ -0,0 +1,87 @@
+#include "GameThread.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+GameThread::~GameThread() {
+  bool parked = false;
+  {
+    std::lock_guard lock(frame_mutex);
+    halt = true;
+    parked = exit_status.has_value();
+  }
+  frame_cv.notify_all();
+  if (not worker.joinable())
+    return;
+  // a parked worker never comes back, and joining ourselves would throw
+  if (parked or on_game_thread())
+    worker.detach();
+  else
+    worker.join();
+}
+
+bool GameThread::on_game_thread() const {
+  return std::this_thread::get_id() == worker.get_id();
+}
+
+void GameThread::kick(std::function<void()> frame) {
+  wait();
+  if (not worker.joinable())
+    worker = std::thread(&GameThread::worker_loop, this);
+  {
+    std::lock_guard lock(frame_mutex);
+    frame_work = std::move(frame);
+    frame_requested = true;
+  }
+  frame_cv.notify_all();
+}
+
+void GameThread::wait() {
+  if (on_game_thread())
+    return;
+  std::unique_lock lock(frame_mutex);
+  frame_cv.wait(lock, [this] { return not frame_requested; });
+  if (exit_status.has_value()) {
+    const int status = *exit_status;
+    lock.unlock();
+    std::exit(status);
+  }
+}
+
+void GameThread::quit(const int status) {
+  GameThread& game_thread = getInstance();
+  if (not game_thread.on_game_thread())
+    std::exit(status);
+
+  std::cout.flush();
+  {
+    // notify under the lock, the main thread may destroy us right after
+    std::lock_guard lock(game_thread.frame_mutex);
+    game_thread.exit_status = status;
+    game_thread.frame_requested = false;
+    game_thread.frame_cv.notify_all();
+  }
+  // touches nothing, so it's safe while the main thread tears down statics
+  while (true)
+    std::this_thread::sleep_for(std::chrono::hours(1));
+}
+
+void GameThread::worker_loop() {
+  while (true) {
+    std::unique_lock lock(frame_mutex);
+    frame_cv.wait(lock, [this] { return halt or frame_requested; });
+    if (halt)
+      return;
+    const std::function<void()> work = std::move(frame_work);
+    lock.unlock();
+
+    work();
+
+    lock.lock();
+    frame_requested = false;
+    lock.unlock();
+    frame_cv.notify_all();
+  }
+}
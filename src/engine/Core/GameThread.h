@@ -0,0 +1,55 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_GAMETHREAD_H_
+#define PULSAR_SRC_ENGINE_CORE_GAMETHREAD_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// Runs a frame of game logic (scripts, scene changes, physics) on its own
+// thread when rendering.config sets "threaded_game_loop". SDL wants its window
+// and renderer used from the thread that made them, so that one keeps
+// drawing and presenting frame N while this thread simulates frame N+1 into
+// the other RenderFrame. Same kick / wait handshake as PhysicsPipeline.
+class GameThread {
+  GameThread() = default;
+  ~GameThread();
+
+ public:
+  GameThread(const GameThread&) = delete;
+  GameThread& operator=(const GameThread&) = delete;
+  GameThread(GameThread&&) = delete;
+  GameThread& operator=(GameThread&&) = delete;
+
+  static GameThread& getInstance() {
+    static GameThread instance;
+    return instance;
+  }
+
+  // Hands a frame to the thread and returns right away.
+  void kick(std::function<void()> frame);
+  // Blocks until the in-flight frame (if any) is done. Exits the process
+  // if that frame asked to quit.
+  void wait();
+  [[nodiscard]] bool on_game_thread() const;
+
+  // std::exit for anything scripts or scene changes can reach. On the game
+  // thread it hands the exit to the main thread, which runs it from wait(),
+  // and parks this thread for good so static destructors never run on it
+  // (or under the main thread's feet).
+  [[noreturn]] static void quit(int status);
+
+ private:
+  void worker_loop();
+
+  std::thread worker;
+  std::mutex frame_mutex;
+  std::condition_variable frame_cv;
+  std::function<void()> frame_work;
+  bool frame_requested = false;
+  bool halt = false;
+  std::optional<int> exit_status;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_GAMETHREAD_H_
@@ -0,0 +1,94 @@
+#include "GlyphAtlas.h"
+
+#include <algorithm>
+
+GlyphAtlas::GlyphAtlas(TTF_Font* font)
+    : font(font), line_height(TTF_FontHeight(font)) {}
+
+GlyphAtlas::~GlyphAtlas() {
+  for (SDL_Texture* page : pages)
+    SDL_DestroyTexture(page);
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::get(SDL_Renderer* renderer, Uint16 ch) {
+  const auto it = glyphs.find(ch);
+  if (it != glyphs.end())
+    return it->second;
+  return glyphs.emplace(ch, rasterize(renderer, ch)).first->second;
+}
+
+int GlyphAtlas::get_kerning(Uint16 previous, Uint16 ch) const {
+  return TTF_GetFontKerningSizeGlyphs(font, previous, ch);
+}
+
+GlyphAtlas::Glyph GlyphAtlas::rasterize(SDL_Renderer* renderer, Uint16 ch) {
+  Glyph glyph{nullptr, {0.0f, 0.0f, 0.0f, 0.0f}, 0, 0, 0, 0};
+  int min_x = 0;
+  int max_x = 0;
+  int min_y = 0;
+  int max_y = 0;
+  if (TTF_GlyphMetrics(font, ch, &min_x, &max_x, &min_y, &max_y,
+                       &glyph.advance) != 0)
+    return glyph;
+  // the bitmap is shifted right by however far the glyph hangs left of the pen
+  glyph.offset_x = std::min(0, min_x);
+
+  constexpr SDL_Color white = {255, 255, 255, 255};
+  SDL_Surface* solid = TTF_RenderGlyph_Solid(font, ch, white);
+  if (solid == nullptr)
+    return glyph;
+  // the colour key becomes alpha on the way to RGBA
+  SDL_Surface* rgba =
+      SDL_ConvertSurfaceFormat(solid, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(solid);
+  if (rgba == nullptr)
+    return glyph;
+
+  size_t page = 0;
+  int x = 0;
+  int y = 0;
+  // a pixel of gap so neighbours never bleed in
+  if (rgba->w > 0 and rgba->h > 0 and
+      place(renderer, rgba->w + 1, rgba->h + 1, page, x, y)) {
+    const SDL_Rect rect = {x, y, rgba->w, rgba->h};
+    SDL_UpdateTexture(pages[page], &rect, rgba->pixels, rgba->pitch);
+    constexpr auto size = static_cast<float>(PAGE_SIZE);
+    glyph.texture = pages[page];
+    glyph.uv = {static_cast<float>(x) / size, static_cast<float>(y) / size,
+                static_cast<float>(rgba->w) / size,
+                static_cast<float>(rgba->h) / size};
+    glyph.width = rgba->w;
+    glyph.height = rgba->h;
+  }
+  SDL_FreeSurface(rgba);
+  return glyph;
+}
+
+bool GlyphAtlas::place(SDL_Renderer* renderer,
+                       int w,
+                       int h,
+                       size_t& page,
+                       int& x,
+                       int& y) {
+  if (w > PAGE_SIZE or h > PAGE_SIZE)
+    return false;
+  for (page = 0; page < packers.size(); page++) {
+    if (packers[page].insert(w, h, x, y))
+      return true;
+  }
+  SDL_Texture* texture =
+      SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                        SDL_TEXTUREACCESS_STATIC, PAGE_SIZE, PAGE_SIZE);
+  if (texture == nullptr)
+    return false;
+  // static textures start out undefined, the gaps between glyphs must be clear
+  const std::vector<Uint32> clear(static_cast<size_t>(PAGE_SIZE) * PAGE_SIZE,
+                                  0);
+  SDL_UpdateTexture(texture, nullptr, clear.data(),
+                    PAGE_SIZE * static_cast<int>(sizeof(Uint32)));
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  pages.push_back(texture);
+  packers.emplace_back(PAGE_SIZE, PAGE_SIZE);
+  page = pages.size() - 1;
+  return packers.back().insert(w, h, x, y);
+}
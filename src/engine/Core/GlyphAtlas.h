@@ -0,0 +1,58 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_GLYPHATLAS_H_
+#define PULSAR_SRC_ENGINE_CORE_GLYPHATLAS_H_
+
+#include <SDL2/SDL.h>
+#include <SDL2_ttf/SDL_ttf.h>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "SkylinePacker.h"
+
+// Glyphs of one (font, size), rasterized white the first time they're asked
+// for and packed onto PAGE_SIZE textures. Text is then quads sampling these,
+// tinted through the vertex colour, so a string costs no rasterizing or
+// uploads once its glyphs are in. Doesn't own the font.
+class GlyphAtlas {
+ public:
+  explicit GlyphAtlas(TTF_Font* font);
+  ~GlyphAtlas();
+  GlyphAtlas(const GlyphAtlas&) = delete;
+  GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+  GlyphAtlas(GlyphAtlas&&) = delete;
+  GlyphAtlas& operator=(GlyphAtlas&&) = delete;
+
+  static constexpr int PAGE_SIZE = 512;
+
+  struct Glyph {
+    // null when the font has nothing to draw for it, e.g. a space
+    SDL_Texture* texture;
+    SDL_FRect uv;
+    int width;
+    int height;
+    // from the pen position to the left edge of the bitmap
+    int offset_x;
+    int advance;
+  };
+
+  // Latin-1 like TTF_RenderText_Solid
+  const Glyph& get(SDL_Renderer* renderer, Uint16 ch);
+  [[nodiscard]] int get_kerning(Uint16 previous, Uint16 ch) const;
+  [[nodiscard]] int get_height() const { return line_height; }
+
+  [[nodiscard]] size_t get_glyph_count() const { return glyphs.size(); }
+  [[nodiscard]] size_t get_page_count() const { return pages.size(); }
+
+ private:
+  Glyph rasterize(SDL_Renderer* renderer, Uint16 ch);
+  bool place(SDL_Renderer* renderer, int w, int h, size_t& page, int& x,
+             int& y);
+
+  TTF_Font* font;
+  int line_height;
+  std::vector<SDL_Texture*> pages;
+  std::vector<SkylinePacker> packers;
+  std::unordered_map<Uint16, Glyph> glyphs;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_GLYPHATLAS_H_
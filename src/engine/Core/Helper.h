@@ -26,6 +26,8 @@
 
 #include "SDL2/SDL.h"
 #include "SDL2_image/SDL_image.h"
+#include "FrameCapture.h"
+#include "FramePacer.h"
 
 enum InputStatus { NOT_INITIALIZED, INPUT_FILE_MISSING, INPUT_FILE_PRESENT };
 enum RenderLoggerStatus { RL_NOT_INITIALIZED, RL_NOT_ENABLED, RL_ENABLED };
@@ -113,44 +115,24 @@ class Helper {
     }
 
     static bool initialized = false;
-    static SDL_Surface* saving_surface = nullptr;
 
     if (RECORDING_MODE || _autograder_mode) {
       if (!initialized) {
-        /* Check for existence of frames folder and establish it if necessary.
-         */
-        if (!std::filesystem::exists(frame_directory_relative_path)) {
-          std::filesystem::create_directory(frame_directory_relative_path);
-        }
-
-        /* Create reusable surface. */
-        int height, width;
-        SDL_GetRendererOutputSize(renderer, &width, &height);
-        saving_surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 24,
-                                                        SDL_PIXELFORMAT_RGB24);
+        /* Every frame as frames/frame_XXXXX.bmp, none may be skipped. */
+        FrameCapture::Settings settings;
+        settings.directory = frame_directory_relative_path;
+        settings.format = FrameCapture::Format::BMP;
+        settings.drop_when_busy = false;
+        FrameCapture::getInstance().configure(settings);
 
         current_frame_start_timestamp = SDL_GetTicks();
         frame_number = 0;
         initialized = true;
       }
 
-      /* Read the current renderer's data and persist it as a .bmp file to disk
-       * (BMP format is fast-to-write compared to PNG). */
-      if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGB24,
-                               saving_surface->pixels,
-                               saving_surface->pitch) != 0) {
-        SDL_Log("SDL_RenderReadPixels() failed: %s", SDL_GetError());
-      }
-      std::stringstream filenameStream;
-      filenameStream << "frame_" << std::setw(5) << std::setfill('0')
-                     << frame_number << ".bmp";
-      std::string output_file_name = filenameStream.str();
-      std::string output_file_path =
-          frame_directory_relative_path + "/" + output_file_name;
-
-      if (SDL_SaveBMP(saving_surface, output_file_path.c_str()) != 0) {
-        SDL_Log("SDL_SaveBMP() failed: %s", SDL_GetError());
-      }
+      /* Read the current renderer's data back; the .bmp is written on a
+       * JobSystem worker so the frame doesn't wait on the disk. */
+      FrameCapture::getInstance().capture(renderer, frame_number);
     }
 
     /* Present and then wait for the next frame to begin */
@@ -349,8 +331,8 @@ class Helper {
 
   static bool IsLoggingMode() { return IsEnvVariableSet("RENDERLOGGER"); }
 
-  /* The engine will aim for 60fps (16ms per frame) during a normal play
-   * session. */
+  /* The engine will aim for the FramePacer's target rate (60fps unless
+   * rendering.config says otherwise) during a normal play session. */
   /* If the engine detects it is being autograded, it will run as fast as
    * possible. */
   static void SDL_Delay() {
@@ -358,18 +340,10 @@ class Helper {
       //::SDL_Delay(1); Don't bother delaying at all. Gotta go fast when
       //: autograding.
     } else {
-      Uint32 current_frame_end_timestamp =
-          SDL_GetTicks();  // Record end time of the frame
-      Uint32 current_frame_duration_milliseconds =
-          current_frame_end_timestamp - current_frame_start_timestamp;
-      Uint32 desired_frame_duration_milliseconds = 16;
-
-      int delay_ticks =
-          std::max(static_cast<int>(desired_frame_duration_milliseconds) -
-                       static_cast<int>(current_frame_duration_milliseconds),
-                   1);
-
-      ::SDL_Delay(delay_ticks);
+      // present already happened here, so pace the next one off this point
+      FramePacer& pacer = FramePacer::getInstance();
+      pacer.wait();
+      pacer.frame_presented();
     }
 
     current_frame_start_timestamp =
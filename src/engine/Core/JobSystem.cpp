@@ -0,0 +1,99 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+JobSystem::JobSystem() {
+  // leave a core for the game thread
+  const unsigned int hw = std::thread::hardware_concurrency();
+  const size_t worker_count = hw > 1 ? hw - 1 : 1;
+  workers.reserve(worker_count);
+  for (size_t i = 0; i < worker_count; i++)
+    workers.emplace_back(&JobSystem::worker_loop, this);
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard lock(queue_mutex);
+    halt = true;
+  }
+  queue_cv.notify_all();
+  for (auto& worker : workers) {
+    if (worker.joinable())
+      worker.join();
+  }
+}
+
+void JobSystem::submit(std::function<void()> job) {
+  {
+    std::lock_guard lock(queue_mutex);
+    jobs.push(std::move(job));
+  }
+  queue_cv.notify_one();
+}
+
+void JobSystem::worker_loop() {
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock lock(queue_mutex);
+      queue_cv.wait(lock, [this] { return halt or not jobs.empty(); });
+      if (halt and jobs.empty())
+        return;
+      job = std::move(jobs.front());
+      jobs.pop();
+    }
+    job();
+  }
+}
+
+void JobSystem::parallel_for(size_t count,
+                             size_t min_batch,
+                             const std::function<void(size_t, size_t)>& fn) {
+  if (count == 0)
+    return;
+  min_batch = std::max<size_t>(min_batch, 1);
+  const size_t max_batches = (count + min_batch - 1) / min_batch;
+  const size_t batch_count = std::min(max_batches, workers.size() + 1);
+  if (batch_count <= 1) {
+    fn(0, count);
+    return;
+  }
+  const size_t batch_size = (count + batch_count - 1) / batch_count;
+
+  // Helpers can still be queued behind unrelated jobs after every batch is
+  // done, so the state is shared with them instead of living on our stack.
+  // A late helper claims nothing and never touches fn.
+  struct SharedState {
+    std::atomic<size_t> next_batch{0};
+    size_t batches_done = 0;
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+  };
+  const auto state = std::make_shared<SharedState>();
+
+  auto run_batches = [state, &fn, count, batch_size, batch_count] {
+    size_t batch;
+    while ((batch = state->next_batch.fetch_add(1)) < batch_count) {
+      const size_t begin = batch * batch_size;
+      const size_t end = std::min(begin + batch_size, count);
+      if (begin < end)
+        fn(begin, end);
+      // notify under the lock, the caller may return the moment it sees this
+      std::lock_guard lock(state->done_mutex);
+      if (++state->batches_done == batch_count)
+        state->done_cv.notify_all();
+    }
+  };
+
+  for (size_t i = 0; i + 1 < batch_count; i++)
+    submit(run_batches);
+
+  run_batches();
+
+  std::unique_lock lock(state->done_mutex);
+  state->done_cv.wait(lock, [&state, batch_count] {
+    return state->batches_done == batch_count;
+  });
+}
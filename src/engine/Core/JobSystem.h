@@ -0,0 +1,51 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_JOBSYSTEM_H_
+#define PULSAR_SRC_ENGINE_CORE_JOBSYSTEM_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Small fixed-size worker pool shared by the engine subsystems. Jobs must not
+// touch the lua_State, only the caller's thread owns that.
+class JobSystem {
+  JobSystem();
+  ~JobSystem();
+
+ public:
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+  JobSystem(JobSystem&&) = delete;
+  JobSystem& operator=(JobSystem&&) = delete;
+
+  static JobSystem& getInstance() {
+    static JobSystem instance;
+    return instance;
+  }
+
+  // Fire and forget.
+  void submit(std::function<void()> job);
+
+  // Splits [0, count) into batches of at least min_batch and runs
+  // fn(begin, end) on the workers. The calling thread helps out and only
+  // returns once every batch is done.
+  void parallel_for(size_t count,
+                    size_t min_batch,
+                    const std::function<void(size_t, size_t)>& fn);
+
+  [[nodiscard]] size_t get_worker_count() const { return workers.size(); }
+
+ private:
+  void worker_loop();
+
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> jobs;
+  std::mutex queue_mutex;
+  std::condition_variable queue_cv;
+  bool halt = false;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_JOBSYSTEM_H_
@@ -0,0 +1,168 @@
+#include "PhysicsConfig.h"
+
+#include <rapidjson/document.h>
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+#include "EngineUtils.h"
+#include "GameThread.h"
+#include "Core/Resources.hpp"
+
+void PhysicsConfig::initialize() {
+  reset();
+
+  const std::string physics_config_path =
+      (App::Resources::game_path() / "physics.config").generic_string();
+  if (not std::filesystem::exists(physics_config_path))
+    return;
+
+  rapidjson::Document physics_config;
+  EngineUtils::ReadJsonFile(physics_config_path, physics_config);
+  load(physics_config);
+}
+
+void PhysicsConfig::reset() {
+  pipelined = false;
+  merge_static_colliders = false;
+  static_tile_size = 1.0f;
+  spatial_cell_size = 2.0f;
+  world = WorldSettings();
+  layers = {"default"};
+  layer_masks.fill(0x00FF);
+}
+
+void PhysicsConfig::load(const rapidjson::Document& physics_config) {
+  if (physics_config.HasMember("pipelined") and
+      physics_config["pipelined"].IsBool())
+    pipelined = physics_config["pipelined"].GetBool();
+
+  if (physics_config.HasMember("merge_static_colliders") and
+      physics_config["merge_static_colliders"].IsBool())
+    merge_static_colliders = physics_config["merge_static_colliders"].GetBool();
+
+  if (physics_config.HasMember("static_tile_size") and
+      physics_config["static_tile_size"].IsNumber())
+    static_tile_size = physics_config["static_tile_size"].GetFloat();
+
+  if (physics_config.HasMember("spatial_cell_size") and
+      physics_config["spatial_cell_size"].IsNumber())
+    spatial_cell_size = physics_config["spatial_cell_size"].GetFloat();
+
+  if (physics_config.HasMember("world") and physics_config["world"].IsObject())
+    world.load(physics_config["world"]);
+
+  load_layers(physics_config);
+}
+
+void WorldSettings::load(const rapidjson::Value& settings) {
+  if (settings.HasMember("gravity_x") and settings["gravity_x"].IsNumber())
+    gravity.x = settings["gravity_x"].GetFloat();
+  if (settings.HasMember("gravity_y") and settings["gravity_y"].IsNumber())
+    gravity.y = settings["gravity_y"].GetFloat();
+
+  if (settings.HasMember("velocity_iterations") and
+      settings["velocity_iterations"].IsInt())
+    velocity_iterations = std::max(1, settings["velocity_iterations"].GetInt());
+  if (settings.HasMember("position_iterations") and
+      settings["position_iterations"].IsInt())
+    position_iterations = std::max(1, settings["position_iterations"].GetInt());
+
+  if (settings.HasMember("allow_sleep") and settings["allow_sleep"].IsBool())
+    allow_sleep = settings["allow_sleep"].GetBool();
+
+  if (settings.HasMember("adaptive_iterations") and
+      settings["adaptive_iterations"].IsBool())
+    adaptive_iterations = settings["adaptive_iterations"].GetBool();
+  if (settings.HasMember("step_budget_ms") and
+      settings["step_budget_ms"].IsNumber())
+    step_budget_ms = settings["step_budget_ms"].GetFloat();
+  if (settings.HasMember("min_velocity_iterations") and
+      settings["min_velocity_iterations"].IsInt())
+    min_velocity_iterations =
+        std::max(1, settings["min_velocity_iterations"].GetInt());
+  if (settings.HasMember("min_position_iterations") and
+      settings["min_position_iterations"].IsInt())
+    min_position_iterations =
+        std::max(1, settings["min_position_iterations"].GetInt());
+
+  min_velocity_iterations =
+      std::min(min_velocity_iterations, velocity_iterations);
+  min_position_iterations =
+      std::min(min_position_iterations, position_iterations);
+}
+
+// "layers": ["player", "enemy", "bullet"],
+// "collision_matrix": { "bullet": ["player", "enemy"] }
+// Layers missing from the matrix collide with everything. A pair only
+// collides when both sides allow it, as Box2D checks both masks.
+void PhysicsConfig::load_layers(const rapidjson::Document& physics_config) {
+  if (physics_config.HasMember("layers") and
+      physics_config["layers"].IsArray()) {
+    for (const auto& layer : physics_config["layers"].GetArray()) {
+      if (not layer.IsString())
+        continue;
+      const std::string name = layer.GetString();
+      if (std::find(layers.begin(), layers.end(), name) != layers.end())
+        continue;
+      if (layers.size() == MAX_LAYERS) {
+        std::cout << "error: physics.config defines more than " << MAX_LAYERS
+                  << " layers";
+        GameThread::quit(0);
+      }
+      layers.push_back(name);
+    }
+  }
+
+  if (physics_config.HasMember("collision_matrix") and
+      physics_config["collision_matrix"].IsObject()) {
+    for (const auto& entry : physics_config["collision_matrix"].GetObject()) {
+      const uint16 layer_bit = get_layer_bit(entry.name.GetString());
+      const size_t layer_index = std::countr_zero(layer_bit);
+      layer_masks[layer_index] = 0;
+      if (not entry.value.IsArray())
+        continue;
+      for (const auto& other : entry.value.GetArray()) {
+        if (other.IsString())
+          layer_masks[layer_index] |= get_layer_bit(other.GetString());
+      }
+    }
+  }
+}
+
+bool PhysicsConfig::find_layer_bit(const std::string& name,
+                                   uint16& bit) const {
+  const auto layer_itr = std::find(layers.begin(), layers.end(), name);
+  if (layer_itr == layers.end())
+    return false;
+  bit = static_cast<uint16>(1u << (layer_itr - layers.begin()));
+  return true;
+}
+
+uint16 PhysicsConfig::get_layer_bit(const std::string& name) const {
+  uint16 bit = 0;
+  if (not find_layer_bit(name, bit)) {
+    std::cout << "error: physics layer " << name << " is not defined";
+    GameThread::quit(0);
+  }
+  return bit;
+}
+
+uint16 PhysicsConfig::get_layer_mask(const std::string& name) const {
+  return layer_masks[std::countr_zero(get_layer_bit(name))];
+}
+
+uint16 PhysicsConfig::parse_layer_list(const std::string& names) const {
+  uint16 bits = 0;
+  std::stringstream stream(names);
+  std::string name;
+  while (std::getline(stream, name, ',')) {
+    name.erase(0, name.find_first_not_of(" \t"));
+    name.erase(name.find_last_not_of(" \t") + 1);
+    if (not name.empty())
+      bits |= get_layer_bit(name);
+  }
+  return bits;
+}
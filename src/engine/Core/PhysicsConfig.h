@@ -0,0 +1,85 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_PHYSICSCONFIG_H_
+#define PULSAR_SRC_ENGINE_CORE_PHYSICSCONFIG_H_
+
+#include <box2d/box2d.h>
+#include <array>
+#include <string>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+// b2World settings. physics.config's "world" block holds the project
+// defaults, a scene's "physics" block overrides them for that scene.
+struct WorldSettings {
+  b2Vec2 gravity{0.0f, 9.8f};
+  int32 velocity_iterations = 8;
+  int32 position_iterations = 3;
+  bool allow_sleep = true;
+
+  // Drop solver iterations while the step runs over step_budget_ms and
+  // bring them back up to the values above once there is room again.
+  bool adaptive_iterations = false;
+  float step_budget_ms = 4.0f;
+  int32 min_velocity_iterations = 2;
+  int32 min_position_iterations = 1;
+
+  void load(const rapidjson::Value& settings);
+};
+
+// Project wide physics settings from resources/physics.config. Everything is
+// optional, a missing file keeps the defaults below.
+class PhysicsConfig {
+  PhysicsConfig() = default;
+
+ public:
+  PhysicsConfig(const PhysicsConfig&) = delete;
+  PhysicsConfig& operator=(const PhysicsConfig&) = delete;
+  PhysicsConfig(PhysicsConfig&&) = delete;
+  PhysicsConfig& operator=(PhysicsConfig&&) = delete;
+
+  static PhysicsConfig& getInstance() {
+    static PhysicsConfig instance;
+    return instance;
+  }
+
+  void initialize();
+  // initialize without the file: back to the defaults, then a parsed
+  // physics.config on top
+  void reset();
+  void load(const rapidjson::Document& physics_config);
+
+  // Step the world on a worker thread while the next frame's scripts run.
+  bool pipelined = false;
+
+  // Bake static box colliders of exactly static_tile_size on a shared grid
+  // into merged rectangles, see StaticGeometry. Collision callbacks then come
+  // per merged rectangle, not per tile.
+  bool merge_static_colliders = false;
+  float static_tile_size = 1.0f;
+
+  // cell size of SceneManager::spatial_hash
+  float spatial_cell_size = 2.0f;
+
+  WorldSettings world;
+
+  // Collision layers. Colliders use the layer bits in the low byte of the
+  // Box2D category, triggers the same bits shifted into the high byte, so
+  // there is room for 8 layers. "default" is always layer 0.
+  static constexpr size_t MAX_LAYERS = 8;
+  std::vector<std::string> layers;
+  // layer index -> bits of the layers it collides with
+  std::array<uint16, MAX_LAYERS> layer_masks{};
+
+  // false for layers physics.config doesn't define
+  [[nodiscard]] bool find_layer_bit(const std::string& name, uint16& bit) const;
+  // exits on layers physics.config doesn't define
+  [[nodiscard]] uint16 get_layer_bit(const std::string& name) const;
+  [[nodiscard]] uint16 get_layer_mask(const std::string& name) const;
+  // "player, enemy" -> layer bits, "" -> 0
+  [[nodiscard]] uint16 parse_layer_list(const std::string& names) const;
+
+ private:
+  void load_layers(const rapidjson::Document& physics_config);
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_PHYSICSCONFIG_H_
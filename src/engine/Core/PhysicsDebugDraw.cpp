@@ -0,0 +1,292 @@
+#include "PhysicsDebugDraw.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CameraManager.h"
+#include "Renderer.h"
+#include "TriggerBroadphase.h"
+
+void PhysicsDebugDraw::render(b2World* world, SDL_Renderer* renderer) {
+  collect(world);
+  submit(renderer);
+}
+
+void PhysicsDebugDraw::collect(b2World* world) {
+  fill_vertices.clear();
+  fill_indices.clear();
+  line_vertices.clear();
+  line_indices.clear();
+  if (not is_enabled())
+    return;
+
+  update_view();
+
+  uint32 flags = 0;
+  if (draw_shapes)
+    flags |= e_shapeBit;
+  if (draw_joints)
+    flags |= e_jointBit;
+  if (draw_aabbs)
+    flags |= e_aabbBit;
+  if (draw_centers)
+    flags |= e_centerOfMassBit;
+  SetFlags(flags);
+
+  if (world) {
+    if (flags != 0)
+      world->DebugDraw();
+    if (draw_contacts)
+      collect_contacts(world);
+  }
+  if (draw_shapes)
+    collect_trigger_volumes();
+}
+
+void PhysicsDebugDraw::submit(SDL_Renderer* renderer) {
+  last_vertex_count = 0;
+  last_draw_calls = 0;
+  if (not renderer or (fill_indices.empty() and line_indices.empty()))
+    return;
+
+  // geometry without a texture blends with the renderer's draw blend mode
+  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+  if (not fill_indices.empty()) {
+    SDL_RenderGeometry(renderer, nullptr, fill_vertices.data(),
+                       static_cast<int>(fill_vertices.size()),
+                       fill_indices.data(),
+                       static_cast<int>(fill_indices.size()));
+    last_draw_calls++;
+  }
+  if (not line_indices.empty()) {
+    SDL_RenderGeometry(renderer, nullptr, line_vertices.data(),
+                       static_cast<int>(line_vertices.size()),
+                       line_indices.data(),
+                       static_cast<int>(line_indices.size()));
+    last_draw_calls++;
+  }
+  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+  last_vertex_count = fill_vertices.size() + line_vertices.size();
+}
+
+// Same mapping as Renderer::render_scene_image, zoom folded into the scale.
+void PhysicsDebugDraw::update_view() {
+  const auto& renderer = Renderer::getInstance();
+  const float zoom = CameraManager::zoom_factor;
+  scale = renderer.get_render_unit_dist() * zoom;
+  const float half_width = static_cast<float>(renderer.get_window_width()) * 0.5f;
+  const float half_height =
+      static_cast<float>(renderer.get_window_height()) * 0.5f;
+  origin_x = half_width - CameraManager::cam_x_pos * scale;
+  origin_y = half_height - CameraManager::cam_y_pos * scale;
+
+  view_min_x = CameraManager::cam_x_pos - half_width / scale;
+  view_max_x = CameraManager::cam_x_pos + half_width / scale;
+  view_min_y = CameraManager::cam_y_pos - half_height / scale;
+  view_max_y = CameraManager::cam_y_pos + half_height / scale;
+}
+
+bool PhysicsDebugDraw::in_view(const b2Vec2* vertices, int32 count) const {
+  float min_x = vertices[0].x;
+  float max_x = vertices[0].x;
+  float min_y = vertices[0].y;
+  float max_y = vertices[0].y;
+  for (int32 i = 1; i < count; i++) {
+    min_x = std::min(min_x, vertices[i].x);
+    max_x = std::max(max_x, vertices[i].x);
+    min_y = std::min(min_y, vertices[i].y);
+    max_y = std::max(max_y, vertices[i].y);
+  }
+  return max_x >= view_min_x and min_x <= view_max_x and
+         max_y >= view_min_y and min_y <= view_max_y;
+}
+
+bool PhysicsDebugDraw::in_view(const b2Vec2& center, float radius) const {
+  return center.x + radius >= view_min_x and center.x - radius <= view_max_x and
+         center.y + radius >= view_min_y and center.y - radius <= view_max_y;
+}
+
+SDL_FPoint PhysicsDebugDraw::to_screen(const b2Vec2& p) const {
+  return {origin_x + p.x * scale, origin_y + p.y * scale};
+}
+
+SDL_Color PhysicsDebugDraw::to_sdl(const b2Color& color, float alpha) {
+  auto channel = [](float value) {
+    return static_cast<Uint8>(std::clamp(value, 0.0f, 1.0f) * 255.0f);
+  };
+  return {channel(color.r), channel(color.g), channel(color.b),
+          channel(color.a * alpha)};
+}
+
+void PhysicsDebugDraw::add_line(const SDL_FPoint& a,
+                                const SDL_FPoint& b,
+                                SDL_Color color) {
+  const float dx = b.x - a.x;
+  const float dy = b.y - a.y;
+  const float length = std::sqrt(dx * dx + dy * dy);
+  if (length <= 0.0f)
+    return;
+  const float nx = -dy / length * LINE_WIDTH * 0.5f;
+  const float ny = dx / length * LINE_WIDTH * 0.5f;
+
+  const int base = static_cast<int>(line_vertices.size());
+  line_vertices.push_back({{a.x + nx, a.y + ny}, color, {0.0f, 0.0f}});
+  line_vertices.push_back({{a.x - nx, a.y - ny}, color, {0.0f, 0.0f}});
+  line_vertices.push_back({{b.x - nx, b.y - ny}, color, {0.0f, 0.0f}});
+  line_vertices.push_back({{b.x + nx, b.y + ny}, color, {0.0f, 0.0f}});
+  line_indices.insert(line_indices.end(),
+                      {base, base + 1, base + 2, base, base + 2, base + 3});
+}
+
+void PhysicsDebugDraw::add_outline(const SDL_FPoint* outline,
+                                   int32 count,
+                                   SDL_Color color) {
+  for (int32 i = 0; i < count; i++)
+    add_line(outline[i], outline[(i + 1) % count], color);
+}
+
+// Box2D polygons are convex, so a fan does.
+void PhysicsDebugDraw::add_fill(const SDL_FPoint* outline,
+                                int32 count,
+                                SDL_Color color) {
+  const int base = static_cast<int>(fill_vertices.size());
+  for (int32 i = 0; i < count; i++)
+    fill_vertices.push_back({outline[i], color, {0.0f, 0.0f}});
+  for (int32 i = 1; i + 1 < count; i++)
+    fill_indices.insert(fill_indices.end(), {base, base + i, base + i + 1});
+}
+
+void PhysicsDebugDraw::project(const b2Vec2* vertices, int32 count) {
+  points.clear();
+  for (int32 i = 0; i < count; i++)
+    points.push_back(to_screen(vertices[i]));
+}
+
+void PhysicsDebugDraw::project_circle(const b2Vec2& center, float radius) {
+  points.clear();
+  constexpr float step = 2.0f * b2_pi / CIRCLE_SEGMENTS;
+  for (int32 i = 0; i < CIRCLE_SEGMENTS; i++) {
+    const float angle = step * static_cast<float>(i);
+    points.push_back(to_screen(
+        center + radius * b2Vec2(std::cos(angle), std::sin(angle))));
+  }
+}
+
+void PhysicsDebugDraw::DrawPolygon(const b2Vec2* vertices,
+                                   int32 vertex_count,
+                                   const b2Color& color) {
+  if (vertex_count < 2 or not in_view(vertices, vertex_count))
+    return;
+  project(vertices, vertex_count);
+  add_outline(points.data(), vertex_count, to_sdl(color, 1.0f));
+}
+
+void PhysicsDebugDraw::DrawSolidPolygon(const b2Vec2* vertices,
+                                        int32 vertex_count,
+                                        const b2Color& color) {
+  if (vertex_count < 3 or not in_view(vertices, vertex_count))
+    return;
+  project(vertices, vertex_count);
+  add_fill(points.data(), vertex_count, to_sdl(color, 0.4f));
+  add_outline(points.data(), vertex_count, to_sdl(color, 1.0f));
+}
+
+void PhysicsDebugDraw::DrawCircle(const b2Vec2& center,
+                                  float radius,
+                                  const b2Color& color) {
+  if (not in_view(center, radius))
+    return;
+  project_circle(center, radius);
+  add_outline(points.data(), CIRCLE_SEGMENTS, to_sdl(color, 1.0f));
+}
+
+void PhysicsDebugDraw::DrawSolidCircle(const b2Vec2& center,
+                                       float radius,
+                                       const b2Vec2& axis,
+                                       const b2Color& color) {
+  if (not in_view(center, radius))
+    return;
+  project_circle(center, radius);
+  add_fill(points.data(), CIRCLE_SEGMENTS, to_sdl(color, 0.4f));
+  add_outline(points.data(), CIRCLE_SEGMENTS, to_sdl(color, 1.0f));
+  add_line(to_screen(center), to_screen(center + radius * axis),
+           to_sdl(color, 1.0f));
+}
+
+void PhysicsDebugDraw::DrawSegment(const b2Vec2& p1,
+                                   const b2Vec2& p2,
+                                   const b2Color& color) {
+  const b2Vec2 segment[2] = {p1, p2};
+  if (not in_view(segment, 2))
+    return;
+  add_line(to_screen(p1), to_screen(p2), to_sdl(color, 1.0f));
+}
+
+void PhysicsDebugDraw::DrawTransform(const b2Transform& xf) {
+  if (not in_view(xf.p, 0.4f))
+    return;
+  constexpr float axis_length = 0.4f;
+  const SDL_FPoint origin = to_screen(xf.p);
+  add_line(origin, to_screen(xf.p + axis_length * xf.q.GetXAxis()),
+           {255, 0, 0, 255});
+  add_line(origin, to_screen(xf.p + axis_length * xf.q.GetYAxis()),
+           {0, 255, 0, 255});
+}
+
+void PhysicsDebugDraw::DrawPoint(const b2Vec2& p,
+                                 float size,
+                                 const b2Color& color) {
+  if (not in_view(p, 0.0f))
+    return;
+  const SDL_FPoint center = to_screen(p);
+  const float half = size * 0.5f;
+  const SDL_FPoint square[4] = {{center.x - half, center.y - half},
+                                {center.x + half, center.y - half},
+                                {center.x + half, center.y + half},
+                                {center.x - half, center.y + half}};
+  add_fill(square, 4, to_sdl(color, 1.0f));
+}
+
+void PhysicsDebugDraw::collect_contacts(b2World* world) {
+  const b2Color point_color(1.0f, 0.9f, 0.2f);
+  const b2Color normal_color(0.9f, 0.9f, 0.9f);
+  constexpr float normal_length = 0.3f;
+  for (b2Contact* contact = world->GetContactList(); contact;
+       contact = contact->GetNext()) {
+    if (not contact->IsTouching())
+      continue;
+    const int32 point_count = contact->GetManifold()->pointCount;
+    if (point_count == 0)
+      continue;
+    b2WorldManifold world_manifold;
+    contact->GetWorldManifold(&world_manifold);
+    for (int32 i = 0; i < point_count; i++) {
+      const b2Vec2& point = world_manifold.points[i];
+      DrawPoint(point, 5.0f, point_color);
+      DrawSegment(point, point + normal_length * world_manifold.normal,
+                  normal_color);
+    }
+  }
+}
+
+// Same colour Box2D uses for sensors on sleeping bodies, they never move.
+void PhysicsDebugDraw::collect_trigger_volumes() {
+  const b2Color volume_color(0.6f, 0.6f, 0.9f);
+  TriggerBroadphase::getInstance().for_each_active(
+      [this, &volume_color](const TriggerVolume* volume) {
+        if (not volume->enabled)
+          return;
+        const b2Vec2 center(volume->x, volume->y);
+        if (volume->trigger_type == "circle") {
+          DrawSolidCircle(center, volume->radius, b2Vec2(1.0f, 0.0f),
+                          volume_color);
+          return;
+        }
+        const b2Vec2 half(volume->width * 0.5f, volume->height * 0.5f);
+        const b2Vec2 corners[4] = {center + b2Vec2(-half.x, -half.y),
+                                   center + b2Vec2(half.x, -half.y),
+                                   center + b2Vec2(half.x, half.y),
+                                   center + b2Vec2(-half.x, half.y)};
+        DrawSolidPolygon(corners, 4, volume_color);
+      });
+}
@@ -0,0 +1,107 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_PHYSICSDEBUGDRAW_H_
+#define PULSAR_SRC_ENGINE_CORE_PHYSICSDEBUGDRAW_H_
+
+#include <SDL2/SDL.h>
+#include <box2d/box2d.h>
+#include <cstddef>
+#include <vector>
+
+// Collects b2World::DebugDraw output (plus contact points and TriggerVolumes)
+// into two vertex buffers, fills and lines, and hands each to
+// SDL_RenderGeometry once per frame. Lines are 1px quads so they batch with
+// everything else. Anything outside the camera view is dropped on the way in.
+class PhysicsDebugDraw : public b2Draw {
+  PhysicsDebugDraw() = default;
+
+ public:
+  PhysicsDebugDraw(const PhysicsDebugDraw&) = delete;
+  PhysicsDebugDraw& operator=(const PhysicsDebugDraw&) = delete;
+  PhysicsDebugDraw(PhysicsDebugDraw&&) = delete;
+  PhysicsDebugDraw& operator=(PhysicsDebugDraw&&) = delete;
+
+  static PhysicsDebugDraw& getInstance() {
+    static PhysicsDebugDraw instance;
+    return instance;
+  }
+
+  // toggled from the editor's debug panel
+  bool draw_shapes = false;
+  bool draw_aabbs = false;
+  bool draw_joints = false;
+  bool draw_contacts = false;
+  bool draw_centers = false;
+
+  [[nodiscard]] bool is_enabled() const {
+    return draw_shapes or draw_aabbs or draw_joints or draw_contacts or
+           draw_centers;
+  }
+
+  // world can be null, TriggerVolumes still get drawn then
+  void render(b2World* world, SDL_Renderer* renderer);
+  // render() in two halves for the threaded game loop: collect while the game
+  // thread is parked, submit later alongside the frame it belongs to
+  void collect(b2World* world);
+  void submit(SDL_Renderer* renderer);
+
+  [[nodiscard]] size_t get_vertex_count() const { return last_vertex_count; }
+  [[nodiscard]] size_t get_draw_calls() const { return last_draw_calls; }
+
+  void DrawPolygon(const b2Vec2* vertices,
+                   int32 vertex_count,
+                   const b2Color& color) override;
+  void DrawSolidPolygon(const b2Vec2* vertices,
+                        int32 vertex_count,
+                        const b2Color& color) override;
+  void DrawCircle(const b2Vec2& center,
+                  float radius,
+                  const b2Color& color) override;
+  void DrawSolidCircle(const b2Vec2& center,
+                       float radius,
+                       const b2Vec2& axis,
+                       const b2Color& color) override;
+  void DrawSegment(const b2Vec2& p1,
+                   const b2Vec2& p2,
+                   const b2Color& color) override;
+  void DrawTransform(const b2Transform& xf) override;
+  void DrawPoint(const b2Vec2& p, float size, const b2Color& color) override;
+
+ private:
+  static constexpr int32 CIRCLE_SEGMENTS = 16;
+  static constexpr float LINE_WIDTH = 1.0f;
+
+  void update_view();
+  [[nodiscard]] bool in_view(const b2Vec2* vertices, int32 count) const;
+  [[nodiscard]] bool in_view(const b2Vec2& center, float radius) const;
+  [[nodiscard]] SDL_FPoint to_screen(const b2Vec2& p) const;
+  static SDL_Color to_sdl(const b2Color& color, float alpha);
+
+  void add_line(const SDL_FPoint& a, const SDL_FPoint& b, SDL_Color color);
+  void add_outline(const SDL_FPoint* points, int32 count, SDL_Color color);
+  void add_fill(const SDL_FPoint* points, int32 count, SDL_Color color);
+  void project(const b2Vec2* vertices, int32 count);
+  void project_circle(const b2Vec2& center, float radius);
+
+  void collect_contacts(b2World* world);
+  void collect_trigger_volumes();
+
+  // world to screen: screen = origin + world * scale
+  float scale = 100.0f;
+  float origin_x = 0.0f;
+  float origin_y = 0.0f;
+  // camera view in world units
+  float view_min_x = 0.0f;
+  float view_min_y = 0.0f;
+  float view_max_x = 0.0f;
+  float view_max_y = 0.0f;
+
+  std::vector<SDL_Vertex> fill_vertices;
+  std::vector<int> fill_indices;
+  std::vector<SDL_Vertex> line_vertices;
+  std::vector<int> line_indices;
+  std::vector<SDL_FPoint> points;
+
+  size_t last_vertex_count = 0;
+  size_t last_draw_calls = 0;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_PHYSICSDEBUGDRAW_H_
@@ -0,0 +1,137 @@
+#include "PhysicsPipeline.h"
+
+#include <algorithm>
+
+#include "ContactListener.h"
+#include "PhysicsConfig.h"
+#include "RigidbodyPool.h"
+
+PhysicsPipeline::~PhysicsPipeline() {
+  {
+    std::lock_guard lock(step_mutex);
+    halt = true;
+  }
+  step_cv.notify_all();
+  if (worker.joinable())
+    worker.join();
+}
+
+bool PhysicsPipeline::is_pipelined() const {
+  return PhysicsConfig::getInstance().pipelined;
+}
+
+bool PhysicsPipeline::on_worker_thread() const {
+  return std::this_thread::get_id() == worker.get_id();
+}
+
+void PhysicsPipeline::run_step(b2World* world,
+                               float time_step,
+                               int32 velocity_iterations,
+                               int32 position_iterations) {
+  // b2_toiCalls is a global running counter inside Box2D
+  const int32 toi_calls_before = b2_toiCalls;
+  world->Step(time_step, velocity_iterations, position_iterations);
+  last_toi_calls = b2_toiCalls - toi_calls_before;
+  last_solve_toi_ms = world->GetProfile().solveTOI;
+  last_step_ms = world->GetProfile().step;
+}
+
+void PhysicsPipeline::kick(b2World* world,
+                           float time_step,
+                           int32 velocity_iterations,
+                           int32 position_iterations) {
+  wait();
+  if (not worker.joinable())
+    worker = std::thread(&PhysicsPipeline::worker_loop, this);
+  {
+    std::lock_guard lock(step_mutex);
+    step_world = world;
+    step_time = time_step;
+    step_velocity_iterations = velocity_iterations;
+    step_position_iterations = position_iterations;
+    step_requested = true;
+  }
+  step_cv.notify_all();
+}
+
+void PhysicsPipeline::wait() {
+  if (on_worker_thread())
+    return;
+  std::unique_lock lock(step_mutex);
+  step_cv.wait(lock, [this] { return not step_requested; });
+}
+
+void PhysicsPipeline::worker_loop() {
+  while (true) {
+    std::unique_lock lock(step_mutex);
+    step_cv.wait(lock, [this] { return halt or step_requested; });
+    if (halt)
+      return;
+    b2World* world = step_world;
+    lock.unlock();
+
+    run_step(world, step_time, step_velocity_iterations,
+             step_position_iterations);
+
+    lock.lock();
+    step_requested = false;
+    lock.unlock();
+    step_cv.notify_all();
+  }
+}
+
+void PhysicsPipeline::sync() {
+  wait();
+
+  applying_commands = true;
+  for (const auto& command : commands)
+    command();
+  commands.clear();
+  applying_commands = false;
+
+  if (is_pipelined())
+    RigidbodyPool::getInstance().capture_snapshots();
+
+  {
+    std::lock_guard lock(contact_mutex);
+    contacts_to_dispatch.swap(contacts);
+  }
+  // Actors a callback destroys are only queued as victims, they stay alive
+  // until SceneManager::update_scene_actors runs after this and calls
+  // forget_actor, so nothing here goes away mid-dispatch.
+  for (const auto& queued : contacts_to_dispatch)
+    ContactListener::LuaOnContactHandle(queued.contact, queued.event,
+                                        queued.caller);
+  contacts_to_dispatch.clear();
+}
+
+void PhysicsPipeline::clear() {
+  wait();
+  commands.clear();
+  std::lock_guard lock(contact_mutex);
+  contacts.clear();
+  contacts_to_dispatch.clear();
+}
+
+bool PhysicsPipeline::defer(std::function<void()> command) {
+  if (applying_commands or not is_pipelined())
+    return false;
+  commands.push_back(std::move(command));
+  return true;
+}
+
+void PhysicsPipeline::queue_contact(const Contact& contact,
+                                    EngineUtils::LifeCycle event,
+                                    Actor* caller) {
+  std::lock_guard lock(contact_mutex);
+  contacts.push_back({contact, event, caller});
+}
+
+void PhysicsPipeline::forget_actor(const Actor* actor) {
+  const auto involves_actor = [actor](const QueuedContact& queued) {
+    return queued.caller == actor or queued.contact.GetOther() == actor;
+  };
+  std::lock_guard lock(contact_mutex);
+  std::erase_if(contacts, involves_actor);
+  std::erase_if(contacts_to_dispatch, involves_actor);
+}
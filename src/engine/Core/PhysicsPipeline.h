@@ -0,0 +1,106 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_PHYSICSPIPELINE_H_
+#define PULSAR_SRC_ENGINE_CORE_PHYSICSPIPELINE_H_
+
+#include <box2d/box2d.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Contact.h"
+#include "EngineUtils.h"
+
+class Actor;
+
+// Runs b2World::Step on its own thread when physics.config asks for it.
+// Frame N's step overlaps frame N+1's scripts, which read the Rigidbody
+// snapshots taken at the last sync and queue their writes for the next one.
+// Anything that has to touch the world directly waits for the step first
+// (SceneManager::GetPhysWorld does this for you).
+class PhysicsPipeline {
+  PhysicsPipeline() = default;
+  ~PhysicsPipeline();
+
+ public:
+  PhysicsPipeline(const PhysicsPipeline&) = delete;
+  PhysicsPipeline& operator=(const PhysicsPipeline&) = delete;
+  PhysicsPipeline(PhysicsPipeline&&) = delete;
+  PhysicsPipeline& operator=(PhysicsPipeline&&) = delete;
+
+  static PhysicsPipeline& getInstance() {
+    static PhysicsPipeline instance;
+    return instance;
+  }
+
+  [[nodiscard]] bool is_pipelined() const;
+
+  // The actual b2World::Step, also records per step stats. Used by both the
+  // worker and the serial path.
+  void run_step(b2World* world,
+                float time_step,
+                int32 velocity_iterations,
+                int32 position_iterations);
+  // only meaningful after wait()
+  [[nodiscard]] int32 get_last_toi_calls() const { return last_toi_calls; }
+  [[nodiscard]] float get_last_solve_toi_ms() const {
+    return last_solve_toi_ms;
+  }
+  [[nodiscard]] float get_last_step_ms() const { return last_step_ms; }
+  [[nodiscard]] bool on_worker_thread() const;
+
+  // Hands the step to the worker and returns right away.
+  void kick(b2World* world,
+            float time_step,
+            int32 velocity_iterations,
+            int32 position_iterations);
+  // Blocks until the in-flight step (if any) is done.
+  void wait();
+  // wait() + apply queued writes + refresh snapshots + run queued contacts.
+  void sync();
+  // Drops everything queued without running it, for resets.
+  void clear();
+
+  // Returns false when the caller should just apply the write itself.
+  bool defer(std::function<void()> command);
+  void queue_contact(const Contact& contact,
+                     EngineUtils::LifeCycle event,
+                     Actor* caller);
+  // Drops queued contacts involving a destroyed actor.
+  void forget_actor(const Actor* actor);
+
+ private:
+  struct QueuedContact {
+    Contact contact;
+    EngineUtils::LifeCycle event;
+    Actor* caller;
+  };
+
+  void worker_loop();
+
+  std::thread worker;
+  std::mutex step_mutex;
+  std::condition_variable step_cv;
+  bool step_requested = false;
+  bool halt = false;
+
+  b2World* step_world = nullptr;
+  float step_time = 0.0f;
+  int32 step_velocity_iterations = 0;
+  int32 step_position_iterations = 0;
+
+  int32 last_toi_calls = 0;
+  float last_solve_toi_ms = 0.0f;
+  float last_step_ms = 0.0f;
+
+  // main thread only
+  std::vector<std::function<void()>> commands;
+  bool applying_commands = false;
+
+  // filled from the worker during Step
+  std::mutex contact_mutex;
+  std::vector<QueuedContact> contacts;
+  std::vector<QueuedContact> contacts_to_dispatch;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_PHYSICSPIPELINE_H_
@@ -0,0 +1,239 @@
+#include "PhysicsQuery.h"
+
+#include <algorithm>
+
+#include "ECS.h"
+#include "PhysicsConfig.h"
+#include "Rigidbody.h"
+#include "StaticGeometry.h"
+
+const uint16 PhysicsQuery::DEFAULT_QUERY_MASK =
+    Rigidbody::CATEGORY_COLLIDER | Rigidbody::CATEGORY_TRIGGER;
+
+namespace {
+bool passes_filter(const b2Fixture* fixture, uint16 mask) {
+  if (EngineUtils::is_phantom_fixture(fixture))
+    return false;
+  if ((fixture->GetFilterData().categoryBits & mask) == 0)
+    return false;
+  return fixture->GetUserData().pointer != 0;
+}
+
+// an actor with both a collider and a trigger reports twice
+void push_unique(std::vector<Actor*>& actors, Actor* actor) {
+  if (std::find(actors.begin(), actors.end(), actor) == actors.end())
+    actors.push_back(actor);
+}
+}  // namespace
+
+bool OverlapQueryCallback::ReportFixture(b2Fixture* fixture) {
+  if (not passes_filter(fixture, mask))
+    return true;
+  if (StaticGeometry::is_region_fixture(fixture)) {
+    StaticGeometry::collect_overlapping(fixture, shape, transform, actors);
+    return true;
+  }
+
+  const b2Transform& fixture_transform = fixture->GetBody()->GetTransform();
+  const b2Shape* fixture_shape = fixture->GetShape();
+  for (int32 child = 0; child < fixture_shape->GetChildCount(); child++) {
+    if (b2TestOverlap(shape, 0, fixture_shape, child, transform,
+                      fixture_transform)) {
+      push_unique(actors,
+                  reinterpret_cast<Actor*>(fixture->GetUserData().pointer));
+      break;
+    }
+  }
+  return true;
+}
+
+bool CandidateQueryCallback::ReportFixture(b2Fixture* fixture) {
+  if (passes_filter(fixture, mask))
+    fixtures.push_back(fixture);
+  return true;
+}
+
+std::vector<Actor*> PhysicsQuery::overlap(const b2Shape& shape,
+                                          const b2Transform& transform,
+                                          uint16 mask) {
+  if (not SceneManager::getInstance().HasPhysWorld())
+    return {};
+  const auto phys_world = SceneManager::getInstance().GetPhysWorld();
+
+  b2AABB aabb;
+  shape.ComputeAABB(&aabb, transform, 0);
+  OverlapQueryCallback callback(&shape, transform, mask);
+  phys_world->QueryAABB(&callback, aabb);
+  return callback.actors;
+}
+
+luabridge::LuaRef PhysicsQuery::LuaOverlapBox(const b2Vec2& center,
+                                              float width,
+                                              float height,
+                                              const luabridge::LuaRef& mask) {
+  if (width <= 0.0f or height <= 0.0f)
+    return generate_actor_table({});
+
+  b2PolygonShape box;
+  box.SetAsBox(width * 0.5f, height * 0.5f);
+  const b2Transform transform(center, b2Rot(0.0f));
+  return generate_actor_table(overlap(box, transform, resolve_mask(mask)));
+}
+
+luabridge::LuaRef PhysicsQuery::LuaOverlapCircle(
+    const b2Vec2& center,
+    float radius,
+    const luabridge::LuaRef& mask) {
+  if (radius <= 0.0f)
+    return generate_actor_table({});
+
+  b2CircleShape circle;
+  circle.m_radius = radius;
+  const b2Transform transform(center, b2Rot(0.0f));
+  return generate_actor_table(overlap(circle, transform, resolve_mask(mask)));
+}
+
+luabridge::LuaRef PhysicsQuery::LuaOverlapPolygon(
+    const luabridge::LuaRef& points,
+    const luabridge::LuaRef& mask) {
+  if (not points.isTable())
+    return generate_actor_table({});
+
+  const int count = std::min(points.length(), b2_maxPolygonVertices);
+  if (count < 3)
+    return generate_actor_table({});
+
+  b2Vec2 vertices[b2_maxPolygonVertices];
+  for (int i = 0; i < count; i++)
+    vertices[i] = points[i + 1].cast<b2Vec2>();
+
+  // Set computes the convex hull and fails on degenerate input
+  b2PolygonShape polygon;
+  if (not polygon.Set(vertices, count))
+    return generate_actor_table({});
+
+  b2Transform transform;
+  transform.SetIdentity();
+  return generate_actor_table(
+      overlap(polygon, transform, resolve_mask(mask)));
+}
+
+luabridge::LuaRef PhysicsQuery::LuaShapeCast(const b2Vec2& pos,
+                                             const luabridge::LuaRef& size,
+                                             const b2Vec2& dir,
+                                             float distance,
+                                             const luabridge::LuaRef& mask) {
+  if (not SceneManager::getInstance().HasPhysWorld() or distance < 0.0f)
+    return generate_actor_table({});
+  const auto phys_world = SceneManager::getInstance().GetPhysWorld();
+
+  b2PolygonShape box;
+  b2CircleShape circle;
+  const b2Shape* shape = nullptr;
+  // same rules as OverlapCircle / OverlapBox
+  if (size.isNumber()) {
+    circle.m_radius = size.cast<float>();
+    if (circle.m_radius <= 0.0f)
+      return generate_actor_table({});
+    shape = &circle;
+  } else if (size.isUserdata()) {
+    const auto extents = size.cast<b2Vec2>();
+    if (extents.x <= 0.0f or extents.y <= 0.0f)
+      return generate_actor_table({});
+    box.SetAsBox(extents.x * 0.5f, extents.y * 0.5f);
+    shape = &box;
+  } else {
+    return generate_actor_table({});
+  }
+
+  const b2Transform start(pos, b2Rot(0.0f));
+  const b2Vec2 translation = distance * dir;
+  const b2Transform end(pos + translation, b2Rot(0.0f));
+
+  b2AABB start_aabb;
+  b2AABB end_aabb;
+  shape->ComputeAABB(&start_aabb, start, 0);
+  shape->ComputeAABB(&end_aabb, end, 0);
+  b2AABB swept_aabb;
+  swept_aabb.Combine(start_aabb, end_aabb);
+
+  CandidateQueryCallback callback(resolve_mask(mask));
+  phys_world->QueryAABB(&callback, swept_aabb);
+
+  std::vector<std::pair<float, Actor*>> hits;
+  std::vector<Actor*> overlapping;
+  for (b2Fixture* fixture : callback.fixtures) {
+    const b2Shape* fixture_shape = fixture->GetShape();
+    const b2Transform& fixture_transform = fixture->GetBody()->GetTransform();
+    for (int32 child = 0; child < fixture_shape->GetChildCount(); child++) {
+      // b2ShapeCast gives up on shapes that already overlap at the start
+      if (b2TestOverlap(fixture_shape, child, shape, 0, fixture_transform,
+                        start)) {
+        // every tile under the shape, like the Overlap queries report
+        if (StaticGeometry::is_region_fixture(fixture)) {
+          overlapping.clear();
+          StaticGeometry::collect_overlapping(fixture, shape, start,
+                                              overlapping);
+          for (Actor* actor : overlapping)
+            hits.emplace_back(0.0f, actor);
+        } else {
+          hits.emplace_back(0.0f, StaticGeometry::resolve_actor(fixture, pos));
+        }
+        break;
+      }
+
+      b2ShapeCastInput input;
+      input.proxyA.Set(fixture_shape, child);
+      input.proxyB.Set(shape, 0);
+      input.transformA = fixture_transform;
+      input.transformB = start;
+      input.translationB = translation;
+
+      b2ShapeCastOutput output;
+      if (b2ShapeCast(&output, &input)) {
+        hits.emplace_back(output.lambda,
+                          StaticGeometry::resolve_actor(fixture, output.point));
+        break;
+      }
+    }
+  }
+
+  std::stable_sort(hits.begin(), hits.end(),
+                   [](const auto& a, const auto& b) { return a.first < b.first; });
+  std::vector<Actor*> actors;
+  actors.reserve(hits.size());
+  for (const auto& [fraction, actor] : hits) {
+    if (actor)
+      push_unique(actors, actor);
+  }
+  return generate_actor_table(actors);
+}
+
+// nil -> everything, number -> raw category bits, "a, b" or {"a", "b"} ->
+// those layers' colliders and triggers
+uint16 PhysicsQuery::resolve_mask(const luabridge::LuaRef& mask) {
+  if (mask.isNumber())
+    return static_cast<uint16>(mask.cast<int>());
+
+  const auto& config = PhysicsConfig::getInstance();
+  uint16 layer_bits = 0;
+  if (mask.isString()) {
+    layer_bits = config.parse_layer_list(mask.cast<std::string>());
+  } else if (mask.isTable()) {
+    for (int i = 1; i <= mask.length(); i++)
+      layer_bits |= config.get_layer_bit(mask[i].cast<std::string>());
+  } else {
+    return DEFAULT_QUERY_MASK;
+  }
+  return static_cast<uint16>(layer_bits | (layer_bits << 8));
+}
+
+luabridge::LuaRef PhysicsQuery::generate_actor_table(
+    const std::vector<Actor*>& actors) {
+  const auto L = App::ECS::getInstance().get_lua_state();
+  luabridge::LuaRef actor_table = luabridge::newTable(L);
+  int i = 1;
+  for (Actor* actor : actors)
+    actor_table[i++] = actor;
+  return actor_table;
+}
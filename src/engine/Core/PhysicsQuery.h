@@ -0,0 +1,77 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_PHYSICSQUERY_H_
+#define PULSAR_SRC_ENGINE_CORE_PHYSICSQUERY_H_
+
+#include <box2d/box2d.h>
+
+// clang-format off
+#include "lua.hpp"
+#include <LuaBridge/LuaBridge.h>
+// clang-format on
+
+#include "Actor.h"
+
+#include <vector>
+
+// Collects the actors whose fixtures overlap a query shape. The AABB query
+// only narrows down candidates, b2TestOverlap does the exact check.
+class OverlapQueryCallback : public b2QueryCallback {
+ public:
+  OverlapQueryCallback(const b2Shape* shape,
+                       const b2Transform& transform,
+                       uint16 mask)
+      : shape(shape), transform(transform), mask(mask) {}
+
+  bool ReportFixture(b2Fixture* fixture) override;
+
+  std::vector<Actor*> actors;
+
+ private:
+  const b2Shape* shape;
+  b2Transform transform;
+  uint16 mask;
+};
+
+// Gathers every fixture in the swept AABB of a shape cast, the actual cast
+// happens per candidate afterwards.
+class CandidateQueryCallback : public b2QueryCallback {
+ public:
+  explicit CandidateQueryCallback(uint16 mask) : mask(mask) {}
+
+  bool ReportFixture(b2Fixture* fixture) override;
+
+  std::vector<b2Fixture*> fixtures;
+
+ private:
+  uint16 mask;
+};
+
+class PhysicsQuery {
+ public:
+  static luabridge::LuaRef LuaOverlapBox(const b2Vec2& center,
+                                         float width,
+                                         float height,
+                                         const luabridge::LuaRef& mask);
+  static luabridge::LuaRef LuaOverlapCircle(const b2Vec2& center,
+                                            float radius,
+                                            const luabridge::LuaRef& mask);
+  static luabridge::LuaRef LuaOverlapPolygon(const luabridge::LuaRef& points,
+                                             const luabridge::LuaRef& mask);
+  // size is a radius (circle) or a Vector2 of width/height (box). Actors come
+  // back ordered by when the shape first touches them along the sweep.
+  static luabridge::LuaRef LuaShapeCast(const b2Vec2& pos,
+                                        const luabridge::LuaRef& size,
+                                        const b2Vec2& dir,
+                                        float distance,
+                                        const luabridge::LuaRef& mask);
+
+  static std::vector<Actor*> overlap(const b2Shape& shape,
+                                     const b2Transform& transform,
+                                     uint16 mask);
+  static uint16 resolve_mask(const luabridge::LuaRef& mask);
+  static luabridge::LuaRef generate_actor_table(
+      const std::vector<Actor*>& actors);
+
+  static const uint16 DEFAULT_QUERY_MASK;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_PHYSICSQUERY_H_
@@ -0,0 +1,65 @@
+#include "PixelLayer.h"
+
+#include <algorithm>
+#include <cstring>
+
+void PixelLayer::resize(int new_width, int new_height) {
+  width = std::max(0, new_width);
+  height = std::max(0, new_height);
+  pixels.assign(static_cast<size_t>(width) * height, 0);
+  reset_dirty();
+}
+
+void PixelLayer::clear() {
+  if (empty())
+    return;
+  const SDL_Rect dirty = get_dirty_rect();
+  for (int y = dirty.y; y < dirty.y + dirty.h; y++)
+    std::memset(pixels.data() + static_cast<size_t>(y) * width + dirty.x, 0,
+                static_cast<size_t>(dirty.w) * sizeof(uint32_t));
+  reset_dirty();
+}
+
+void PixelLayer::reset_dirty() {
+  dirty_min_x = std::numeric_limits<int>::max();
+  dirty_min_y = std::numeric_limits<int>::max();
+  dirty_max_x = -1;
+  dirty_max_y = -1;
+  drawn = 0;
+}
+
+// c * a / 255, rounded
+static uint32_t scale_channel(uint32_t c, uint32_t a) {
+  const uint32_t t = c * a + 128;
+  return (t + (t >> 8)) >> 8;
+}
+
+uint32_t PixelLayer::premultiply(SDL_Color color) {
+  return scale_channel(color.r, color.a) |
+         scale_channel(color.g, color.a) << 8 |
+         scale_channel(color.b, color.a) << 16 |
+         static_cast<uint32_t>(color.a) << 24;
+}
+
+// Two channels per multiply (red / blue, then green / alpha), each in its
+// own 16 bit lane. Premultiplied channels never exceed alpha, so the sum
+// can't carry into the next channel.
+uint32_t PixelLayer::blend(uint32_t dst, uint32_t src) {
+  const uint32_t inverse = 255 - (src >> 24);
+  uint32_t rb = (dst & 0x00FF00FFu) * inverse + 0x00800080u;
+  rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+  uint32_t ga = ((dst >> 8) & 0x00FF00FFu) * inverse + 0x00800080u;
+  ga = (ga + ((ga >> 8) & 0x00FF00FFu)) & 0xFF00FF00u;
+  return src + (rb | ga);
+}
+
+uint32_t PixelLayer::unpremultiply(uint32_t pixel) {
+  const uint32_t a = pixel >> 24;
+  if (a == 0 or a == 255)
+    return pixel;
+  auto channel = [a](uint32_t c) {
+    return std::min(255u, (c * 255 + a / 2) / a);
+  };
+  return channel(pixel & 0xFF) | channel((pixel >> 8) & 0xFF) << 8 |
+         channel((pixel >> 16) & 0xFF) << 16 | a << 24;
+}
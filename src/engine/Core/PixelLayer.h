@@ -0,0 +1,78 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_PIXELLAYER_H_
+#define PULSAR_SRC_ENGINE_CORE_PIXELLAYER_H_
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Image.DrawPixel(s) land here instead of the RenderQueue: a window sized
+// buffer of premultiplied ABGR8888 pixels, blended on the CPU in call order,
+// that Renderer uploads to one streaming texture and draws once a frame.
+// Only the rect that was drawn into gets uploaded and cleared.
+class PixelLayer {
+ public:
+  // premultiplied, so drawing the layer with ONE, ONE_MINUS_SRC_ALPHA gives
+  // the same result as blending each pixel into the frame one by one
+  static constexpr Uint32 FORMAT = SDL_PIXELFORMAT_ABGR8888;
+
+  void resize(int width, int height);
+  void clear();
+
+  void draw(int x, int y, SDL_Color color) {
+    if (x < 0 or y < 0 or x >= width or y >= height or color.a == 0)
+      return;
+    uint32_t& dst = pixels[static_cast<size_t>(y) * width + x];
+    dst = color.a == 255 ? pack(color) : blend(dst, premultiply(color));
+    if (x < dirty_min_x)
+      dirty_min_x = x;
+    if (x > dirty_max_x)
+      dirty_max_x = x;
+    if (y < dirty_min_y)
+      dirty_min_y = y;
+    if (y > dirty_max_y)
+      dirty_max_y = y;
+    drawn++;
+  }
+
+  [[nodiscard]] bool empty() const { return drawn == 0; }
+  // only meaningful when not empty
+  [[nodiscard]] SDL_Rect get_dirty_rect() const {
+    return {dirty_min_x, dirty_min_y, dirty_max_x - dirty_min_x + 1,
+            dirty_max_y - dirty_min_y + 1};
+  }
+  [[nodiscard]] const uint32_t* get_row(int y) const {
+    return pixels.data() + static_cast<size_t>(y) * width;
+  }
+  [[nodiscard]] int get_width() const { return width; }
+  [[nodiscard]] int get_height() const { return height; }
+  // draws that landed this frame, off screen ones don't count
+  [[nodiscard]] size_t get_drawn_count() const { return drawn; }
+
+  static uint32_t pack(SDL_Color color) {
+    return static_cast<uint32_t>(color.r) |
+           static_cast<uint32_t>(color.g) << 8 |
+           static_cast<uint32_t>(color.b) << 16 |
+           static_cast<uint32_t>(color.a) << 24;
+  }
+  static uint32_t premultiply(SDL_Color color);
+  // src over dst, both premultiplied
+  static uint32_t blend(uint32_t dst, uint32_t src);
+  // back to straight alpha, for renderers without custom blend modes
+  static uint32_t unpremultiply(uint32_t pixel);
+
+ private:
+  void reset_dirty();
+
+  std::vector<uint32_t> pixels;
+  int width = 0;
+  int height = 0;
+  int dirty_min_x = std::numeric_limits<int>::max();
+  int dirty_min_y = std::numeric_limits<int>::max();
+  int dirty_max_x = -1;
+  int dirty_max_y = -1;
+  size_t drawn = 0;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_PIXELLAYER_H_
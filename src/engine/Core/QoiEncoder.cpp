@@ -0,0 +1,105 @@
+#include "QoiEncoder.h"
+
+#include <array>
+
+namespace {
+constexpr uint8_t OP_INDEX = 0x00;
+constexpr uint8_t OP_DIFF = 0x40;
+constexpr uint8_t OP_LUMA = 0x80;
+constexpr uint8_t OP_RUN = 0xC0;
+constexpr uint8_t OP_RGB = 0xFE;
+constexpr uint8_t OP_RGBA = 0xFF;
+constexpr int MAX_RUN = 62;
+
+struct Pixel {
+  uint8_t r = 0, g = 0, b = 0, a = 255;
+  bool operator==(const Pixel& other) const {
+    return r == other.r and g == other.g and b == other.b and a == other.a;
+  }
+};
+
+int hash(const Pixel& px) {
+  return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+}
+
+void put_u32(std::vector<uint8_t>& out, uint32_t value) {
+  out.push_back(static_cast<uint8_t>(value >> 24));
+  out.push_back(static_cast<uint8_t>(value >> 16));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+  out.push_back(static_cast<uint8_t>(value));
+}
+}  // namespace
+
+std::vector<uint8_t> Qoi::encode(const uint8_t* rgba, const int width,
+                                 const int height, const size_t pitch) {
+  std::vector<uint8_t> out;
+  if (width <= 0 or height <= 0)
+    return out;
+  const size_t count = static_cast<size_t>(width) * height;
+  // worst case is an OP_RGBA per pixel
+  out.reserve(14 + count * 5 + 8);
+  out.insert(out.end(), {'q', 'o', 'i', 'f'});
+  put_u32(out, static_cast<uint32_t>(width));
+  put_u32(out, static_cast<uint32_t>(height));
+  out.push_back(4);  // channels
+  out.push_back(0);  // sRGB with linear alpha
+
+  std::array<Pixel, 64> index{};
+  for (auto& seen : index)
+    seen.a = 0;
+  Pixel prev;
+  int run = 0;
+  size_t emitted = 0;
+
+  for (int y = 0; y < height; y++) {
+    const uint8_t* row = rgba + static_cast<size_t>(y) * pitch;
+    for (int x = 0; x < width; x++) {
+      const Pixel px{row[x * 4], row[x * 4 + 1], row[x * 4 + 2],
+                     row[x * 4 + 3]};
+      emitted++;
+      if (px == prev) {
+        run++;
+        if (run == MAX_RUN or emitted == count) {
+          out.push_back(static_cast<uint8_t>(OP_RUN | (run - 1)));
+          run = 0;
+        }
+        continue;
+      }
+      if (run > 0) {
+        out.push_back(static_cast<uint8_t>(OP_RUN | (run - 1)));
+        run = 0;
+      }
+
+      const int slot = hash(px);
+      if (index[slot] == px) {
+        out.push_back(static_cast<uint8_t>(OP_INDEX | slot));
+      } else {
+        index[slot] = px;
+        if (px.a == prev.a) {
+          const auto vr = static_cast<int8_t>(px.r - prev.r);
+          const auto vg = static_cast<int8_t>(px.g - prev.g);
+          const auto vb = static_cast<int8_t>(px.b - prev.b);
+          const int vg_r = vr - vg;
+          const int vg_b = vb - vg;
+          if (vr > -3 and vr < 2 and vg > -3 and vg < 2 and vb > -3 and
+              vb < 2) {
+            out.push_back(static_cast<uint8_t>(OP_DIFF | (vr + 2) << 4 |
+                                               (vg + 2) << 2 | (vb + 2)));
+          } else if (vg_r > -9 and vg_r < 8 and vg > -33 and vg < 32 and
+                     vg_b > -9 and vg_b < 8) {
+            out.push_back(static_cast<uint8_t>(OP_LUMA | (vg + 32)));
+            out.push_back(static_cast<uint8_t>((vg_r + 8) << 4 | (vg_b + 8)));
+          } else {
+            out.insert(out.end(), {OP_RGB, px.r, px.g, px.b});
+          }
+        } else {
+          out.insert(out.end(), {OP_RGBA, px.r, px.g, px.b, px.a});
+        }
+      }
+      prev = px;
+    }
+  }
+
+  out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+  return out;
+}
@@ -0,0 +1,17 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_QOIENCODER_H_
+#define PULSAR_SRC_ENGINE_CORE_QOIENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// "Quite OK Image" encoder (qoiformat.org), used by FrameCapture. Lossless,
+// a single pass over the pixels and usually within a few percent of PNG's
+// size at many times the speed, which is what we want for dumping frames.
+namespace Qoi {
+// rgba is width * height pixels of RGBA bytes, rows pitch bytes apart
+std::vector<uint8_t> encode(const uint8_t* rgba, int width, int height,
+                            size_t pitch);
+}  // namespace Qoi
+
+#endif  // PULSAR_SRC_ENGINE_CORE_QOIENCODER_H_
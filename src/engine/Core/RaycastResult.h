@@ -24,11 +24,15 @@ class RaycastResult {
   [[nodiscard]] bool IsTrigger() const { return is_trigger; }
   void SetTrigger(bool t) { is_trigger = t; }
 
+  [[nodiscard]] float GetFraction() const { return fraction; }
+  void SetFraction(float f) { fraction = f; }
+
   RaycastResult()
       : actor(nullptr),
         point(0.0f, 0.0f),
         normal(0.0f, 0.0f),
-        is_trigger(false){};
+        is_trigger(false),
+        fraction(0.0f){};
   ~RaycastResult() = default;
 
   void reset() {
@@ -36,6 +40,7 @@ class RaycastResult {
     point = b2Vec2(0.0f, 0.0f);
     normal = b2Vec2(0.0f, 0.0f);
     is_trigger = false;
+    fraction = 0.0f;
   }
 
  private:
@@ -43,6 +48,7 @@ class RaycastResult {
   b2Vec2 point;
   b2Vec2 normal;
   bool is_trigger;
+  float fraction;
 };
 
 #endif  // PULSAR_SRC_ENGINE_CORE_RAYCASTRESULT_H_
@@ -4,18 +4,22 @@
 
 #include "Raycaster.h"
 #include "ECS.h"
+#include "JobSystem.h"
+#include "PhysicsQuery.h"
+#include "StaticGeometry.h"
 
 [[maybe_unused]] std::vector<luabridge::LuaRef> Raycaster::multiple_raycast_results;
 
 luabridge::LuaRef Raycaster::LuaRaycast(const b2Vec2& pos,
                                         const b2Vec2& dir,
-                                        float distance) {
+                                        float distance,
+                                        const luabridge::LuaRef& layers) {
   const auto L = App::ECS::getInstance().get_lua_state();
-  if (distance <= 0.0f)
+  if (distance <= 0.0f or not SceneManager::getInstance().HasPhysWorld())
     return {L};
 
   const auto phys_world = SceneManager::getInstance().GetPhysWorld();
-  SingleRaycastCallback callback;
+  SingleRaycastCallback callback(PhysicsQuery::resolve_mask(layers));
   const auto& scaled_dir = b2Vec2(dir.x * distance, dir.y * distance);
   phys_world->RayCast(&callback, pos, pos + scaled_dir);
 
@@ -26,13 +30,14 @@ luabridge::LuaRef Raycaster::LuaRaycast(const b2Vec2& pos,
 
 luabridge::LuaRef Raycaster::LuaRaycastAll(const b2Vec2& pos,
                                            const b2Vec2& dir,
-                                           float distance) {
+                                           float distance,
+                                           const luabridge::LuaRef& layers) {
   const auto L = App::ECS::getInstance().get_lua_state();
-  if (distance <= 0.0f)
+  if (distance <= 0.0f or not SceneManager::getInstance().HasPhysWorld())
     return {L};
 
   const auto phys_world = SceneManager::getInstance().GetPhysWorld();
-  MultipleRaycastCallback callback;
+  MultipleRaycastCallback callback(PhysicsQuery::resolve_mask(layers));
 
   const auto& scaled_dir = b2Vec2(dir.x * distance, dir.y * distance);
   phys_world->RayCast(&callback, pos, pos + scaled_dir);
@@ -40,6 +45,105 @@ luabridge::LuaRef Raycaster::LuaRaycastAll(const b2Vec2& pos,
   return {L, generate_hit_result_table(callback.results)};
 }
 
+luabridge::LuaRef Raycaster::LuaRaycastBatch(const luabridge::LuaRef& origins,
+                                             const luabridge::LuaRef& dirs,
+                                             const luabridge::LuaRef& distances,
+                                             bool closest_only,
+                                             const luabridge::LuaRef& layers) {
+  const auto L = App::ECS::getInstance().get_lua_state();
+  if (not origins.isTable() or not dirs.isTable())
+    return {L};
+
+  // pull everything out of lua up front, workers can't touch the lua_State
+  const int ray_count = std::min(origins.length(), dirs.length());
+  std::vector<b2Vec2> ray_starts(ray_count);
+  std::vector<b2Vec2> ray_ends(ray_count);
+  for (int i = 0; i < ray_count; i++) {
+    const auto pos = origins[i + 1].cast<b2Vec2>();
+    const auto dir = dirs[i + 1].cast<b2Vec2>();
+    const float distance = distances.isTable()
+                               ? distances[i + 1].cast<float>()
+                               : distances.cast<float>();
+    ray_starts[i] = pos;
+    // zero length rays are skipped, same as LuaRaycast
+    ray_ends[i] = distance > 0.0f ? pos + distance * dir : pos;
+  }
+
+  const uint16 mask = PhysicsQuery::resolve_mask(layers);
+  std::vector<MultipleRaycastCallback> callbacks(ray_count,
+                                                 MultipleRaycastCallback(mask));
+  if (not SceneManager::getInstance().HasPhysWorld())
+    return generate_hit_batch_table(callbacks);
+
+  // b2World::RayCast only reads the broadphase, so rays can go wide
+  const auto phys_world = SceneManager::getInstance().GetPhysWorld();
+
+  JobSystem::getInstance().parallel_for(
+      ray_count, RAYCAST_BATCH_MIN_RAYS_PER_JOB,
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+          if (ray_starts[i] == ray_ends[i])
+            continue;
+          if (closest_only) {
+            SingleRaycastCallback single(mask);
+            phys_world->RayCast(&single, ray_starts[i], ray_ends[i]);
+            if (single.hit)
+              callbacks[i].results.push_back(single.result);
+          } else {
+            phys_world->RayCast(&callbacks[i], ray_starts[i], ray_ends[i]);
+            callbacks[i].sort_results();
+          }
+        }
+      });
+
+  return generate_hit_batch_table(callbacks);
+}
+
+luabridge::LuaRef Raycaster::generate_hit_batch_table(
+    const std::vector<MultipleRaycastCallback>& callbacks) {
+  const auto L = App::ECS::getInstance().get_lua_state();
+  luabridge::LuaRef batch = luabridge::newTable(L);
+  luabridge::LuaRef count = luabridge::newTable(L);
+  luabridge::LuaRef first = luabridge::newTable(L);
+  luabridge::LuaRef actor = luabridge::newTable(L);
+  luabridge::LuaRef point_x = luabridge::newTable(L);
+  luabridge::LuaRef point_y = luabridge::newTable(L);
+  luabridge::LuaRef normal_x = luabridge::newTable(L);
+  luabridge::LuaRef normal_y = luabridge::newTable(L);
+  luabridge::LuaRef fraction = luabridge::newTable(L);
+  luabridge::LuaRef is_trigger = luabridge::newTable(L);
+
+  // hits for ray i live at [first[i], first[i] + count[i]) in the flat arrays
+  int hit_index = 1;
+  for (int ray = 0; ray < static_cast<int>(callbacks.size()); ray++) {
+    const auto& results = callbacks[ray].results;
+    count[ray + 1] = static_cast<int>(results.size());
+    first[ray + 1] = hit_index;
+    for (const auto& result : results) {
+      actor[hit_index] = result.GetActor();
+      point_x[hit_index] = result.GetPoint().x;
+      point_y[hit_index] = result.GetPoint().y;
+      normal_x[hit_index] = result.GetNormal().x;
+      normal_y[hit_index] = result.GetNormal().y;
+      fraction[hit_index] = result.GetFraction();
+      is_trigger[hit_index] = result.IsTrigger();
+      hit_index++;
+    }
+  }
+
+  batch["hit_count"] = hit_index - 1;
+  batch["count"] = count;
+  batch["first"] = first;
+  batch["actor"] = actor;
+  batch["point_x"] = point_x;
+  batch["point_y"] = point_y;
+  batch["normal_x"] = normal_x;
+  batch["normal_y"] = normal_y;
+  batch["fraction"] = fraction;
+  batch["is_trigger"] = is_trigger;
+  return batch;
+}
+
 luabridge::LuaRef Raycaster::generate_hit_result_table(
     const std::vector<RaycastResult>& results) {
   const auto L = App::ECS::getInstance().get_lua_state();
@@ -57,14 +161,18 @@ float SingleRaycastCallback::ReportFixture(b2Fixture* fixture,
                                            float fraction) {
   if (fraction == 0.0f)
     return -1.0f;
-  if (EngineUtils::is_phantom_fixture(fixture))
+  if (EngineUtils::is_phantom_fixture(fixture) or
+      (fixture->GetFilterData().categoryBits & mask) == 0)
     return -1.0f;
 
-  if (fixture->GetUserData().pointer) {
-    result.SetActor(reinterpret_cast<Actor*>(fixture->GetUserData().pointer));
+  // nudge the hit point inside the fixture for merged static geometry
+  if (Actor* actor = StaticGeometry::resolve_actor(
+          fixture, point - RAYCAST_RESOLVE_DEPTH * normal)) {
+    result.SetActor(actor);
     result.SetPoint(point);
     result.SetNormal(normal);
     result.SetTrigger(fixture->IsSensor());
+    result.SetFraction(fraction);
     hit = true;
     return fraction;
   }
@@ -78,15 +186,18 @@ float MultipleRaycastCallback::ReportFixture(b2Fixture* fixture,
   if (fraction == 0.0f)
     return -1.0f;
 
-  if (EngineUtils::is_phantom_fixture(fixture))
+  if (EngineUtils::is_phantom_fixture(fixture) or
+      (fixture->GetFilterData().categoryBits & mask) == 0)
     return -1.0f;
 
-  if (fixture->GetUserData().pointer) {
+  if (Actor* actor = StaticGeometry::resolve_actor(
+          fixture, point - RAYCAST_RESOLVE_DEPTH * normal)) {
     RaycastResult result;
-    result.SetActor(reinterpret_cast<Actor*>(fixture->GetUserData().pointer));
+    result.SetActor(actor);
     result.SetPoint(point);
     result.SetNormal(normal);
     result.SetTrigger(fixture->IsSensor());
+    result.SetFraction(fraction);
     results.push_back(result);
   }
 
@@ -95,6 +206,6 @@ float MultipleRaycastCallback::ReportFixture(b2Fixture* fixture,
 void MultipleRaycastCallback::sort_results() {
   std::sort(results.begin(), results.end(),
             [](const RaycastResult& a, const RaycastResult& b) {
-              return a.GetPoint().Length() < b.GetPoint().Length();
+              return a.GetFraction() < b.GetFraction();
             });
 }
@@ -21,6 +21,7 @@
 class SingleRaycastCallback : public b2RayCastCallback {
  public:
   SingleRaycastCallback() = default;
+  explicit SingleRaycastCallback(uint16 mask) : mask(mask) {}
 
   float ReportFixture(b2Fixture* fixture,
                       const b2Vec2& point,
@@ -29,11 +30,13 @@ class SingleRaycastCallback : public b2RayCastCallback {
 
   bool hit = false;
   RaycastResult result;
+  uint16 mask = 0xFFFF;
 };
 
 class MultipleRaycastCallback : public b2RayCastCallback {
  public:
   MultipleRaycastCallback() = default;
+  explicit MultipleRaycastCallback(uint16 mask) : mask(mask) {}
 
   float ReportFixture(b2Fixture* fixture,
                       const b2Vec2& point,
@@ -42,16 +45,32 @@ class MultipleRaycastCallback : public b2RayCastCallback {
   void sort_results();
 
   std::vector<RaycastResult> results;
+  uint16 mask = 0xFFFF;
 };
 
+constexpr size_t RAYCAST_BATCH_MIN_RAYS_PER_JOB = 32;
+constexpr float RAYCAST_RESOLVE_DEPTH = 0.01f;
+
 class Raycaster {
  public:
+  // layers is optional, see PhysicsQuery::resolve_mask
   static luabridge::LuaRef LuaRaycast(const b2Vec2& pos,
                                       const b2Vec2& dir,
-                                      float distance);
+                                      float distance,
+                                      const luabridge::LuaRef& layers);
   static luabridge::LuaRef LuaRaycastAll(const b2Vec2& pos,
                                          const b2Vec2& dir,
-                                         float distance);
+                                         float distance,
+                                         const luabridge::LuaRef& layers);
+  // Casts every ray in one call, spread over the job system. Hits come back
+  // sorted by fraction in flat arrays instead of one HitResult per hit.
+  static luabridge::LuaRef LuaRaycastBatch(const luabridge::LuaRef& origins,
+                                           const luabridge::LuaRef& dirs,
+                                           const luabridge::LuaRef& distances,
+                                           bool closest_only,
+                                           const luabridge::LuaRef& layers);
+  static luabridge::LuaRef generate_hit_batch_table(
+      const std::vector<MultipleRaycastCallback>& callbacks);
   static luabridge::LuaRef generate_hit_result_table(
       const std::vector<RaycastResult>& results);
   [[maybe_unused]] static std::vector<luabridge::LuaRef> multiple_raycast_results;
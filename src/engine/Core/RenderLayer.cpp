@@ -0,0 +1,94 @@
+#include "RenderLayer.h"
+
+#include <cmath>
+
+bool RenderLayer::parse_mode(const std::string& name, Mode& mode) {
+  if (name == "dynamic")
+    mode = Mode::DYNAMIC;
+  else if (name == "static")
+    mode = Mode::STATIC;
+  else if (name == "on_change")
+    mode = Mode::ON_CHANGE;
+  else
+    return false;
+  return true;
+}
+
+LayerCache::Submission LayerCache::describe(const RenderQueue& queue,
+                                            const RenderLayer::Mode mode,
+                                            const uint32_t generation,
+                                            const View& view) {
+  Submission submission;
+  // walks every command, only worth it when it decides the redraw
+  if (mode == RenderLayer::Mode::ON_CHANGE)
+    submission.content = queue.content_hash();
+  submission.empty = queue.empty();
+  submission.generation = generation;
+  submission.view = view;
+  for (size_t i = 0; i < queue.size(); i++) {
+    const RenderCommand& command = queue.get_command(i);
+    if (command.type == IMGType::Scene)
+      submission.has_scene = true;
+    else
+      submission.has_ui = true;
+    if (command.texture == nullptr)
+      submission.complete = false;
+  }
+  return submission;
+}
+
+LayerCache::Action LayerCache::decide(const RenderLayer::Mode mode,
+                                      const Submission& now,
+                                      const float max_drift_x,
+                                      const float max_drift_y) {
+  if (mode == RenderLayer::Mode::DYNAMIC)
+    return now.empty ? Action::SKIP : Action::DRAW;
+
+  const bool same_generation = valid and drawn.generation == now.generation;
+  // a static layer only has to be drawn once, later frames may skip it
+  if (now.empty) {
+    if (mode != RenderLayer::Mode::STATIC or not same_generation)
+      return Action::SKIP;
+    if (covers(now.view, max_drift_x, max_drift_y))
+      return Action::COMPOSITE;
+    // nothing to draw it again from, so the next submission has to
+    invalidate();
+    return Action::SKIP;
+  }
+
+  bool current = same_generation and covers(now.view, max_drift_x, max_drift_y);
+  if (mode == RenderLayer::Mode::ON_CHANGE and drawn.content != now.content)
+    current = false;
+  if (current)
+    return Action::COMPOSITE;
+  // a missing image would be baked in, wait until they're all loaded
+  return now.complete ? Action::REDRAW : Action::DRAW;
+}
+
+bool LayerCache::covers(const View& view,
+                        const float max_drift_x,
+                        const float max_drift_y) const {
+  if (not drawn.has_scene)
+    return true;
+  if (view.zoom != drawn.view.zoom)
+    return false;
+  const float dx = std::abs(view.x - drawn.view.x);
+  const float dy = std::abs(view.y - drawn.view.y);
+  // UI draws don't scroll, so a layer with both can't be shifted at all
+  if (drawn.has_ui)
+    return dx == 0.0f and dy == 0.0f;
+  return dx <= max_drift_x and dy <= max_drift_y;
+}
+
+void LayerCache::store(const Submission& submission) {
+  drawn = submission;
+  valid = true;
+}
+
+SDL_FPoint LayerCache::drift(const View& now, const float unit_dist) const {
+  if (not drawn.has_scene)
+    return {0.0f, 0.0f};
+  // whole unzoomed pixels, the same snapping render_scene_image does
+  return {std::round((drawn.view.x - now.x) * unit_dist) * now.zoom,
+          std::round((drawn.view.y - now.y) * unit_dist) * now.zoom};
+}
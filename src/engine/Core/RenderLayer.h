@@ -0,0 +1,103 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_RENDERLAYER_H_
+#define PULSAR_SRC_ENGINE_CORE_RENDERLAYER_H_
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <string>
+
+#include "RenderQueue.h"
+
+// A named group of Image.Draw* calls (Image.BeginLayer / EndLayer) with its
+// own camera and place in the frame. Layers draw back to front by order;
+// everything drawn outside a layer sits at order 0, before layers that share
+// it. Text and pixels stay on top of all of them.
+struct RenderLayer {
+  enum class Mode {
+    DYNAMIC,    // drawn from scratch every frame
+    STATIC,     // drawn once into a texture, until Image.InvalidateLayer
+    ON_CHANGE,  // drawn into a texture again whenever its draws change
+  };
+
+  std::string name;
+  int order = 0;
+  // how far the layer moves with the camera, 0 is pinned to the screen,
+  // below 1 trails behind like a distant background
+  float parallax_x = 1.0f;
+  float parallax_y = 1.0f;
+  // added to the layer's camera, world units
+  float offset_x = 0.0f;
+  float offset_y = 0.0f;
+  Mode mode = Mode::DYNAMIC;
+  // bumped by Image.InvalidateLayer and scene changes
+  uint32_t generation = 0;
+
+  static bool parse_mode(const std::string& name, Mode& mode);
+};
+
+// The texture a STATIC / ON_CHANGE layer was last drawn into and what it was
+// drawn from, main thread only. Scene layers get drawn with a margin around
+// the screen so the camera can scroll a bit before the texture runs out and
+// has to be drawn again; until then it's copied in shifted by the scroll.
+class LayerCache {
+ public:
+  struct View {
+    float x = 0.0f;
+    float y = 0.0f;
+    float zoom = 1.0f;
+  };
+  // one frame's worth of a layer's draws
+  struct Submission {
+    uint64_t content = 0;  // RenderQueue::content_hash, ON_CHANGE only
+    bool empty = true;
+    bool has_scene = false;
+    bool has_ui = false;
+    bool complete = true;  // every image has its texture
+    uint32_t generation = 0;
+    View view;
+  };
+  enum class Action {
+    SKIP,       // nothing to draw
+    DRAW,       // straight to the screen, no caching
+    REDRAW,     // into the texture, then composite it
+    COMPOSITE,  // the texture as it is
+  };
+
+  static Submission describe(const RenderQueue& queue,
+                             RenderLayer::Mode mode,
+                             uint32_t generation,
+                             const View& view);
+
+  // margin_x / margin_y in world units, how far the view may drift from
+  // the one the texture was drawn at. A static layer that stopped
+  // submitting and got scrolled past its margin drops the texture, it
+  // shows up again once it's drawn again.
+  [[nodiscard]] Action decide(RenderLayer::Mode mode,
+                              const Submission& now,
+                              float margin_x,
+                              float margin_y);
+  // after drawing the submission into the texture
+  void store(const Submission& submission);
+  void invalidate() { valid = false; }
+
+  // screen pixels to move the texture by for the view it's shown at
+  [[nodiscard]] SDL_FPoint drift(const View& now, float unit_dist) const;
+  [[nodiscard]] bool is_valid() const { return valid; }
+  [[nodiscard]] bool has_scene() const { return drawn.has_scene; }
+
+  SDL_Texture* texture = nullptr;
+  int width = 0;
+  int height = 0;
+  // transparent pixels around the screen on each side
+  int margin_x = 0;
+  int margin_y = 0;
+
+ private:
+  [[nodiscard]] bool covers(const View& view,
+                            float margin_x,
+                            float margin_y) const;
+
+  bool valid = false;
+  Submission drawn;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_RENDERLAYER_H_
@@ -0,0 +1,163 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+uint64_t RenderQueue::make_key(IMGType type,
+                               int render_order,
+                               uint32_t texture_id,
+                               uint32_t index) {
+  constexpr int64_t order_bias = int64_t{1} << (RENDER_ORDER_BITS - 1);
+  constexpr int64_t order_max = (int64_t{1} << RENDER_ORDER_BITS) - 1;
+  // signed order to unsigned, clamped to what fits
+  const auto order = static_cast<uint64_t>(
+      std::clamp<int64_t>(render_order + order_bias, 0, order_max));
+  constexpr uint64_t texture_mask = (uint64_t{1} << TEXTURE_BITS) - 1;
+  constexpr uint64_t index_mask = (uint64_t{1} << INDEX_BITS) - 1;
+
+  uint64_t key = static_cast<uint64_t>(type);
+  key = (key << RENDER_ORDER_BITS) | order;
+  key = (key << TEXTURE_BITS) | (texture_id & texture_mask);
+  key = (key << INDEX_BITS) | std::min<uint64_t>(index, index_mask);
+  return key;
+}
+
+void RenderQueue::push(const RenderCommand& command,
+                       int render_order,
+                       float bound_x,
+                       float bound_y,
+                       float bound_radius) {
+  const uint32_t texture_id =
+      batch_by_texture ? get_texture_id(command.texture) : 0;
+  const auto index = static_cast<uint32_t>(commands.size());
+  entries.push_back(
+      {make_key(command.type, render_order, texture_id, index), index});
+  commands.push_back(command);
+  bounds_x.push_back(bound_x);
+  bounds_y.push_back(bound_y);
+  bounds_radius.push_back(bound_radius);
+}
+
+namespace {
+// splitmix64's finalizer
+uint64_t mix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ull;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+uint64_t bits(float value) {
+  uint32_t out;
+  std::memcpy(&out, &value, sizeof(out));
+  return out;
+}
+}  // namespace
+
+// Each entry hashes on its own and the results are summed, so the order
+// entries sit in doesn't matter; the submission index in the key keeps
+// draw order in the hash. Texture ids are per queue, hash the pointer.
+uint64_t RenderQueue::content_hash() const {
+  constexpr uint64_t texture_mask = ((uint64_t{1} << TEXTURE_BITS) - 1)
+                                    << INDEX_BITS;
+  uint64_t hash = mix(commands.size());
+  for (const Entry& entry : entries) {
+    const RenderCommand& command = commands[entry.index];
+    uint64_t h = mix(entry.key & ~texture_mask);
+    h = mix(h ^ reinterpret_cast<uintptr_t>(command.texture));
+    h = mix(h ^ (bits(command.uv.x) << 32 | bits(command.uv.y)));
+    h = mix(h ^ (bits(command.uv.w) << 32 | bits(command.uv.h)));
+    h = mix(h ^ (static_cast<uint64_t>(static_cast<uint32_t>(command.size.x))
+                     << 32 |
+                 static_cast<uint32_t>(command.size.y)));
+    h = mix(h ^ (bits(command.x) << 32 | bits(command.y)));
+    h = mix(h ^ (bits(command.pivot_x) << 32 | bits(command.pivot_y)));
+    h = mix(h ^ (bits(command.scale_x) << 32 | bits(command.scale_y)));
+    h = mix(h ^ (bits(command.rotation_degrees) << 32 |
+                 static_cast<uint64_t>(command.color.r) << 24 |
+                 static_cast<uint64_t>(command.color.g) << 16 |
+                 static_cast<uint64_t>(command.color.b) << 8 |
+                 command.color.a));
+    hash += h;
+  }
+  return hash;
+}
+
+// No branches or early outs so the compiler can vectorize it, an infinite
+// radius passes both tests.
+void RenderQueue::cull(float camera_x,
+                       float camera_y,
+                       float half_width,
+                       float half_height) {
+  const size_t count = commands.size();
+  visible.resize(count);
+  const float* xs = bounds_x.data();
+  const float* ys = bounds_y.data();
+  const float* radii = bounds_radius.data();
+  uint8_t* out = visible.data();
+  size_t visible_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    const bool inside_x = std::abs(xs[i] - camera_x) <= half_width + radii[i];
+    const bool inside_y = std::abs(ys[i] - camera_y) <= half_height + radii[i];
+    out[i] = static_cast<uint8_t>(inside_x & inside_y);
+    visible_count += out[i];
+  }
+  culled_count = count - visible_count;
+  culled = true;
+}
+
+// LSD radix sort a byte at a time, stable, skipping bytes every key shares.
+// Past 2^22 draws the index saturates and stability keeps submission order.
+void RenderQueue::sort() {
+  if (culled) {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [this](const Entry& entry) {
+                                   return visible[entry.index] == 0;
+                                 }),
+                  entries.end());
+  }
+  const size_t count = entries.size();
+  scratch.resize(count);
+  for (int shift = 0; shift < 64; shift += 8) {
+    std::array<size_t, 256> offsets{};
+    for (const Entry& entry : entries)
+      offsets[(entry.key >> shift) & 0xFF]++;
+    if (std::find(offsets.begin(), offsets.end(), count) != offsets.end())
+      continue;
+    size_t total = 0;
+    for (size_t& offset : offsets) {
+      const size_t bucket = offset;
+      offset = total;
+      total += bucket;
+    }
+    for (const Entry& entry : entries)
+      scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+    entries.swap(scratch);
+  }
+
+  sorted.clear();
+  for (const Entry& entry : entries)
+    sorted.push_back(&commands[entry.index]);
+}
+
+void RenderQueue::clear() {
+  commands.clear();
+  bounds_x.clear();
+  bounds_y.clear();
+  bounds_radius.clear();
+  entries.clear();
+  sorted.clear();
+  culled = false;
+  culled_count = 0;
+}
+
+uint32_t RenderQueue::get_texture_id(SDL_Texture* texture) {
+  if (texture == nullptr)
+    return 0;
+  const auto [it, inserted] = texture_ids.try_emplace(texture, next_texture_id);
+  if (inserted)
+    next_texture_id++;
+  return it->second;
+}
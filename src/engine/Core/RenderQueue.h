@@ -0,0 +1,117 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_RENDERQUEUE_H_
+#define PULSAR_SRC_ENGINE_CORE_RENDERQUEUE_H_
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "EngineUtils.h"
+
+// One Image.Draw* call with its image already resolved to a texture, plain
+// data so a frame's worth sits in one flat buffer.
+struct RenderCommand {
+  IMGType type;
+  SDL_Texture* texture;  // null for pixels
+  SDL_FRect uv;
+  SDL_Point size;
+  float x, y;
+  float pivot_x = -1.0f, pivot_y = -1.0f;
+  float rotation_degrees = 0.0f, scale_x = 1.0f, scale_y = 1.0f;
+  SDL_Color color = {255, 255, 255, 255};
+};
+
+// The frame's draws plus a 64 bit sort key each, from the top bit down:
+//   type (2) | render_order (24) | texture (16) | submission index (22)
+// An LSD radix sort on the keys gives the same order the old stable sort on
+// (type, render_order) did. With batch_by_texture, draws of equal
+// render_order are also grouped by texture so the sprite batch gets longer
+// runs. That can change which of two overlapping equal order sprites ends up
+// on top, so it is opt in. Buffers keep their capacity, a steady frame
+// doesn't allocate.
+// Scene draws also carry a world space bounding circle, kept apart from the
+// commands so cull() is one tight loop over three float arrays.
+class RenderQueue {
+ public:
+  static constexpr int RENDER_ORDER_BITS = 24;
+  static constexpr int TEXTURE_BITS = 16;
+  static constexpr int INDEX_BITS = 22;
+
+  static constexpr float ALWAYS_VISIBLE =
+      std::numeric_limits<float>::infinity();
+
+  // bound_x/y and bound_radius in world units, UI and pixels leave them be
+  void push(const RenderCommand& command,
+            int render_order,
+            float bound_x = 0.0f,
+            float bound_y = 0.0f,
+            float bound_radius = ALWAYS_VISIBLE);
+  // drops everything whose bounds miss the camera rect, before sort()
+  void cull(float camera_x,
+            float camera_y,
+            float half_width,
+            float half_height);
+  // sorts, afterwards get_sorted() is in draw order
+  void sort();
+  void clear();
+
+  [[nodiscard]] const std::vector<const RenderCommand*>& get_sorted() const {
+    return sorted;
+  }
+  // for fixing up a command recorded before its image was loaded
+  RenderCommand& get_command(size_t index) { return commands[index]; }
+  [[nodiscard]] const RenderCommand& get_command(size_t index) const {
+    return commands[index];
+  }
+  void set_bound(size_t index, float x, float y, float radius) {
+    bounds_x[index] = x;
+    bounds_y[index] = y;
+    bounds_radius[index] = radius;
+  }
+
+  [[nodiscard]] size_t size() const { return commands.size(); }
+  [[nodiscard]] bool empty() const { return commands.empty(); }
+  [[nodiscard]] size_t get_culled_count() const { return culled_count; }
+  // Same for two queues that would draw the same thing under the same
+  // camera: every command, its render order and its place in the
+  // submission order. Doesn't care whether sort() ran, but call it before
+  // cull(), which drops entries.
+  [[nodiscard]] uint64_t content_hash() const;
+
+  void set_batch_by_texture(bool enabled) { batch_by_texture = enabled; }
+  [[nodiscard]] bool get_batch_by_texture() const { return batch_by_texture; }
+
+  static uint64_t make_key(IMGType type,
+                           int render_order,
+                           uint32_t texture_id,
+                           uint32_t index);
+
+ private:
+  struct Entry {
+    uint64_t key;
+    uint32_t index;
+  };
+
+  uint32_t get_texture_id(SDL_Texture* texture);
+
+  bool batch_by_texture = false;
+  std::vector<RenderCommand> commands;
+  std::vector<float> bounds_x;
+  std::vector<float> bounds_y;
+  std::vector<float> bounds_radius;
+  std::vector<uint8_t> visible;
+  bool culled = false;
+  size_t culled_count = 0;
+  std::vector<Entry> entries;
+  std::vector<Entry> scratch;
+  std::vector<const RenderCommand*> sorted;
+  // small ids handed out the first time a texture is drawn, only used for
+  // grouping so wrapping around after 65536 textures is harmless
+  std::unordered_map<SDL_Texture*, uint32_t> texture_ids;
+  uint32_t next_texture_id = 1;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_RENDERQUEUE_H_
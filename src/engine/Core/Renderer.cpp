@@ -5,18 +5,35 @@
 #include "Renderer.h"
 
 #include "SDL2_image/SDL_image.h"
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <limits>
 #include "EngineUtils.h"
 
 #include "Actor.h"
 #include "CameraManager.h"
+#include "ECS.h"
 #include "Engine.h"
+#include "GameThread.h"
+#include "TextureAtlas.h"
+#include "TextureLoader.h"
 
 bool DEBUG_MODE = false;
 
-std::vector<TextRenderRequest> Renderer::text_render_requests;
-std::deque<IMGRenderRequest> Renderer::img_render_requests;
-std::unordered_map<std::string, SDL_Texture*> Renderer::textures;
+std::array<RenderFrame, 2> Renderer::frames;
+size_t Renderer::recording_frame = 0;
+size_t Renderer::presenting_frame = 0;
+std::unordered_map<std::string, uint32_t> Renderer::image_ids;
+std::vector<std::string> Renderer::image_names;
+std::vector<Renderer::Sprite> Renderer::image_sprites;
+std::vector<uint64_t> Renderer::image_last_used;
+std::vector<uint32_t> Renderer::drawn_images;
+uint64_t Renderer::frame_index = 0;
+std::vector<RenderLayer> Renderer::layers;
+std::unordered_map<std::string, uint32_t> Renderer::layer_ids;
+uint32_t Renderer::current_layer = RenderFrame::NO_LAYER;
+TextureCache Renderer::textures;
 
 void Renderer::initialize(const rapidjson::Document& game_config) {
   const std::string game_title =
@@ -57,9 +74,37 @@ void Renderer::initialize(const rapidjson::Document& game_config) {
 
     if (rendering_config.HasMember("cam_ease_factor"))
       CAMERA_EASE_FACTOR = rendering_config["cam_ease_factor"].GetFloat();
+
+    // see RenderQueue, changes the order of overlapping equal order sprites
+    if (rendering_config.HasMember("batch_by_texture")) {
+      for (auto& frame : frames)
+        frame.queue.set_batch_by_texture(
+            rendering_config["batch_by_texture"].GetBool());
+    }
+
+    if (rendering_config.HasMember("texture_upload_budget_kb"))
+      texture_upload_budget =
+          static_cast<size_t>(
+              rendering_config["texture_upload_budget_kb"].GetInt()) *
+          1024;
+
+    // see TextureCache, 0 (the default) keeps everything a scene may use
+    if (rendering_config.HasMember("texture_budget_mb"))
+      textures.set_budget(
+          static_cast<size_t>(rendering_config["texture_budget_mb"].GetInt()) *
+          1024 * 1024);
+
+    // see GameThread
+    if (rendering_config.HasMember("threaded_game_loop"))
+      threaded_game_loop = rendering_config["threaded_game_loop"].GetBool();
+
+    // see FramePacer, 0 leaves it to vsync
+    if (rendering_config.HasMember("target_frame_rate"))
+      target_frame_rate = rendering_config["target_frame_rate"].GetInt();
   }
 
-  const auto g_settings = App::Window::Settings{game_title, WINDOW_WIDTH, WINDOW_HEIGHT, false};
+  const auto g_settings =
+      App::Window::Settings{game_title, WINDOW_WIDTH, WINDOW_HEIGHT, false, headless};
   m_window = std::make_unique<App::Window>(g_settings);
   m_window->set_id();
   
@@ -69,6 +114,12 @@ void Renderer::initialize(const rapidjson::Document& game_config) {
 
   set_sdl_renderer(m_window->get_native_renderer());
   set_game_window(m_window->get_native_window());
+  // headless runs are for measuring, so never hold them back
+  FramePacer::getInstance().configure(get_sdl_renderer(), get_game_window(),
+                                      headless ? 0 : target_frame_rate);
+  for (auto& frame : frames)
+    frame.pixels.resize(WINDOW_WIDTH, WINDOW_HEIGHT);
+  TextureAtlas::getInstance().load(get_sdl_renderer());
 }
 
 void Renderer::render_HUD(const int health, const int score) {
@@ -77,7 +128,7 @@ void Renderer::render_HUD(const int health, const int score) {
   const int y = 25;
   for (int i = 0; i < health; i++) {
     SDL_Rect render_rect = {x + i * (w + 5), y, w, h};
-    SDL_RenderCopy(get_sdl_renderer(), textures[HEALTH_ICON], nullptr,
+    SDL_RenderCopy(get_sdl_renderer(), get_or_create_texture(HEALTH_ICON), nullptr,
                    &render_rect);
   }
   render_text("score : " + std::to_string(score), 5, 5);
@@ -95,7 +146,9 @@ void Renderer::load_intro_images(const rapidjson::Document& game_config) {
       if (std::filesystem::exists(img_path)) {
         SDL_Texture* image_texture =
             IMG_LoadTexture(get_sdl_renderer(), img_path.c_str());
-        textures[name] = image_texture;
+        add_texture(name, image_texture);
+        // shown before any scene, nothing else would hold them
+        textures.acquire(name);
         intro_images.emplace_back(name);
       } else {
         std::cout << "error: missing image " << name;
@@ -139,7 +192,7 @@ void Renderer::load_intro_texts(const rapidjson::Document& game_config) {
 }
 
 void Renderer::render_cached_image(const std::string& image_name) {
-  SDL_Texture* image_texture = textures[image_name];
+  SDL_Texture* image_texture = textures.find(image_name);
   SDL_RenderCopy(get_sdl_renderer(), image_texture, nullptr, nullptr);
 }
 
@@ -152,7 +205,7 @@ void Renderer::LuaRenderText(const std::string& text,
                              const int g,
                              const int b,
                              const int a) {
-  text_render_requests.push_back(
+  frames[recording_frame].texts.push_back(
       {text,
        font_size,
        font_name,
@@ -161,10 +214,76 @@ void Renderer::LuaRenderText(const std::string& text,
        x,
        y});
 }
+// Lua hands colours over as floats, floored into 0..255 bytes.
+static Uint8 to_channel(float value) {
+  return static_cast<Uint8>(static_cast<int>(std::floor(value)));
+}
+uint32_t Renderer::fill_image(RenderCommand& command,
+                              const std::string& image_name) {
+  const auto next_id = static_cast<uint32_t>(image_names.size());
+  const auto [it, inserted] = image_ids.try_emplace(image_name, next_id);
+  if (inserted) {
+    image_names.push_back(image_name);
+    image_last_used.push_back(std::numeric_limits<uint64_t>::max());
+  }
+  const uint32_t id = it->second;
+  if (image_last_used[id] != frame_index) {
+    image_last_used[id] = frame_index;
+    drawn_images.push_back(id);
+  }
+  if (id >= image_sprites.size() or image_sprites[id].evicted) {
+    // loading means SDL, that waits for swap_frames on the main thread
+    if (GameThread::getInstance().on_game_thread())
+      return id;
+    resolve_image(id);
+  }
+  apply_sprite(command, image_sprites[id]);
+  return NO_PENDING_IMAGE;
+}
+void Renderer::resolve_image(uint32_t id) {
+  if (id >= image_sprites.size())
+    resolve_images();
+  else if (image_sprites[id].evicted)
+    image_sprites[id] = getInstance().resolve_sprite(image_names[id]);
+}
+void Renderer::resolve_images() {
+  auto& renderer = getInstance();
+  while (image_sprites.size() < image_names.size())
+    image_sprites.push_back(
+        renderer.resolve_sprite(image_names[image_sprites.size()]));
+}
+void Renderer::apply_sprite(RenderCommand& command, const Sprite& sprite) {
+  command.texture = sprite.texture;
+  command.uv = sprite.uv;
+  command.size = sprite.size;
+}
+void Renderer::submit(const RenderCommand& command,
+                      int render_order,
+                      uint32_t pending_image) {
+  RenderFrame& frame = frames[recording_frame];
+  if (current_layer != RenderFrame::NO_LAYER and
+      current_layer >= frame.layer_queues.size()) {
+    frame.layer_queues.resize(current_layer + 1);
+    for (auto& layer_queue : frame.layer_queues)
+      layer_queue.set_batch_by_texture(frame.queue.get_batch_by_texture());
+  }
+  RenderQueue& queue = frame.get_queue(current_layer);
+  if (pending_image != NO_PENDING_IMAGE)
+    frame.pending_images.push_back(
+        {queue.size(), pending_image, current_layer});
+  // pending scene draws get their bounds once the size is known
+  if (command.type == IMGType::Scene and pending_image == NO_PENDING_IMAGE)
+    queue.push(command, render_order, command.x, command.y,
+               scene_bound_radius(command));
+  else
+    queue.push(command, render_order);
+}
 void Renderer::LuaDrawUI(std::string image_name, float x, float y) {
-  cache_texture(image_name);
-  const IMGRenderRequest request{IMGType::UI, std::move(image_name), x, y};
-  img_render_requests.push_back(request);
+  RenderCommand command{};
+  command.type = IMGType::UI;
+  command.x = x;
+  command.y = y;
+  submit(command, 0, fill_image(command, image_name));
 }
 void Renderer::LuaDrawUIEx(std::string image_name,
                            float x,
@@ -174,19 +293,19 @@ void Renderer::LuaDrawUIEx(std::string image_name,
                            float b,
                            float a,
                            int render_order) {
-  cache_texture(image_name);
-  IMGRenderRequest request{IMGType::UI, std::move(image_name), x, y,
-                           render_order};
-  request.r = static_cast<int>(std::floor(r));
-  request.g = static_cast<int>(std::floor(g));
-  request.b = static_cast<int>(std::floor(b));
-  request.a = static_cast<int>(std::floor(a));
-  img_render_requests.push_back(request);
+  RenderCommand command{};
+  command.type = IMGType::UI;
+  command.x = x;
+  command.y = y;
+  command.color = {to_channel(r), to_channel(g), to_channel(b), to_channel(a)};
+  submit(command, render_order, fill_image(command, image_name));
 }
 void Renderer::LuaDraw(std::string image_name, float x, float y) {
-  cache_texture(image_name);
-  const IMGRenderRequest request{IMGType::Scene, std::move(image_name), x, y};
-  img_render_requests.push_back(request);
+  RenderCommand command{};
+  command.type = IMGType::Scene;
+  command.x = x;
+  command.y = y;
+  submit(command, 0, fill_image(command, image_name));
 }
 void Renderer::LuaDrawEx(std::string image_name,
                          float x,
@@ -201,19 +320,33 @@ void Renderer::LuaDrawEx(std::string image_name,
                          float b,
                          float a,
                          int render_order) {
-  cache_texture(image_name);
-  IMGRenderRequest request{IMGType::Scene, std::move(image_name), x, y,
-                           render_order};
-  request.rotation_degrees = static_cast<int>(rotation_degrees);
-  request.scale_x = scale_x;
-  request.scale_y = scale_y;
-  request.pivot_x = pivot_x;
-  request.pivot_y = pivot_y;
-  request.r = static_cast<int>(std::floor(r));
-  request.g = static_cast<int>(std::floor(g));
-  request.b = static_cast<int>(std::floor(b));
-  request.a = static_cast<int>(std::floor(a));
-  img_render_requests.push_back(request);
+  RenderCommand command{};
+  command.type = IMGType::Scene;
+  command.x = x;
+  command.y = y;
+  command.rotation_degrees = static_cast<float>(static_cast<int>(rotation_degrees));
+  command.scale_x = scale_x;
+  command.scale_y = scale_y;
+  command.pivot_x = pivot_x;
+  command.pivot_y = pivot_y;
+  command.color = {to_channel(r), to_channel(g), to_channel(b), to_channel(a)};
+  submit(command, render_order, fill_image(command, image_name));
+}
+// Circle around the pivot (the draw position) that holds the rect however it
+// is rotated: pivot to the far corner, plus a pixel for the int snapping.
+float Renderer::scene_bound_radius(const RenderCommand& command) {
+  const auto w = static_cast<float>(command.size.x);
+  const auto h = static_cast<float>(command.size.y);
+  const float pivot_x = command.pivot_x == -1.0f
+                            ? w * 0.5f
+                            : command.pivot_x * w * command.scale_x;
+  const float pivot_y = command.pivot_y == -1.0f
+                            ? h * 0.5f
+                            : command.pivot_y * h * command.scale_y;
+  const float reach_x = std::abs(pivot_x) + w * std::abs(command.scale_x);
+  const float reach_y = std::abs(pivot_y) + h * std::abs(command.scale_y);
+  return (std::sqrt(reach_x * reach_x + reach_y * reach_y) + 1.0f) /
+         getInstance().UNIT_DIST;
 }
 void Renderer::LuaDrawPixel(float x,
                             float y,
@@ -221,21 +354,57 @@ void Renderer::LuaDrawPixel(float x,
                             float g,
                             float b,
                             float a) {
-  IMGRenderRequest request{IMGType::Pixel, "", x, y};
-  request.r = static_cast<int>(std::floor(r));
-  request.g = static_cast<int>(std::floor(g));
-  request.b = static_cast<int>(std::floor(b));
-  request.a = static_cast<int>(std::floor(a));
-  img_render_requests.push_back(request);
-}
-void Renderer::render_scene_image(const IMGRenderRequest& request) const {
-  SDL_RenderSetScale(get_sdl_renderer(), CameraManager::zoom_factor,
-                     CameraManager::zoom_factor);
-  const auto texture = get_or_create_texture(request.image_name);
-  SDL_Rect render_rect = {0, 0, 0, 0};
-  SDL_QueryTexture(texture, nullptr, nullptr, &render_rect.w, &render_rect.h);
-  const int w = render_rect.w;
-  const int h = render_rect.h;
+  frames[recording_frame].pixels.draw(
+      static_cast<int>(x), static_cast<int>(y),
+      {to_channel(r), to_channel(g), to_channel(b), to_channel(a)});
+}
+// Straight off the Lua stack, a LuaRef per element would cost more than the
+// blend itself.
+void Renderer::LuaDrawPixels(const luabridge::LuaRef& positions,
+                             const luabridge::LuaRef& colors) {
+  if (not positions.isTable() or not colors.isTable())
+    return;
+  lua_State* L = positions.state();
+  positions.push();
+  colors.push();
+  const int positions_index = lua_absindex(L, -2);
+  const int colors_index = lua_absindex(L, -1);
+  const auto count =
+      static_cast<lua_Integer>(lua_rawlen(L, positions_index) / 2);
+  const bool one_color = lua_rawlen(L, colors_index) < 8;
+
+  auto number_at = [L](int table, lua_Integer i) {
+    lua_rawgeti(L, table, i);
+    const lua_Number value = lua_tonumber(L, -1);
+    lua_pop(L, 1);
+    return static_cast<float>(value);
+  };
+  auto color_at = [&](lua_Integer first) -> SDL_Color {
+    return {to_channel(number_at(colors_index, first)),
+            to_channel(number_at(colors_index, first + 1)),
+            to_channel(number_at(colors_index, first + 2)),
+            to_channel(number_at(colors_index, first + 3))};
+  };
+
+  PixelLayer& layer = frames[recording_frame].pixels;
+  const SDL_Color shared = one_color ? color_at(1) : SDL_Color{};
+  for (lua_Integer i = 0; i < count; i++) {
+    const int x = static_cast<int>(number_at(positions_index, 2 * i + 1));
+    const int y = static_cast<int>(number_at(positions_index, 2 * i + 2));
+    layer.draw(x, y, one_color ? shared : color_at(4 * i + 1));
+  }
+  lua_pop(L, 2);
+}
+// Same placement SDL_RenderCopyEx did under SDL_RenderSetScale(zoom): the
+// rect is laid out in unzoomed pixels, rotated clockwise about the pivot and
+// only then scaled by the zoom.
+void Renderer::render_scene_image(const RenderCommand& request,
+                                  const RenderFrame::Camera& camera,
+                                  const SDL_FPoint origin) {
+  if (request.texture == nullptr)
+    return;
+  const int w = request.size.x;
+  const int h = request.size.y;
   float pivot_x, pivot_y;
   if (request.pivot_x == -1.0f)
     pivot_x = static_cast<int>(w * 0.5);
@@ -246,46 +415,106 @@ void Renderer::render_scene_image(const IMGRenderRequest& request) const {
   else
     pivot_y = static_cast<int>(request.pivot_y * h * request.scale_y);
 
-  render_rect.x = static_cast<int>(
-      WINDOW_WIDTH / 2 / CameraManager::zoom_factor +
-      (request.x - CameraManager::cam_x_pos) * UNIT_DIST - pivot_x);
-  render_rect.y = static_cast<int>(
-      WINDOW_HEIGHT / 2 / CameraManager::zoom_factor +
-      (request.y - CameraManager::cam_y_pos) * UNIT_DIST - pivot_y);
-  render_rect.w = static_cast<int>(w * fabs(request.scale_x));
-  render_rect.h = static_cast<int>(h * fabs(request.scale_y));
-
-  SDL_SetTextureColorMod(texture, request.r, request.g, request.b);
-  SDL_SetTextureAlphaMod(texture, request.a);
-  const SDL_Point pivot = {static_cast<int>(pivot_x),
-                           static_cast<int>(pivot_y)};
-  SDL_RenderCopyEx(get_sdl_renderer(), texture, nullptr,
-                              &render_rect, request.rotation_degrees, &pivot,
-                              SDL_FLIP_NONE);
-  SDL_RenderSetScale(get_sdl_renderer(), DEFAULT_ZOOM_FACTOR,
-                     DEFAULT_ZOOM_FACTOR);
-  SDL_SetTextureColorMod(texture, 255, 255, 255);
-  SDL_SetTextureAlphaMod(texture, 255);
-}
-void Renderer::render_UI_image(const IMGRenderRequest& request) const {
-  const auto texture = get_or_create_texture(request.image_name);
-  SDL_Rect render_rect = {static_cast<int>(request.x),
-                          static_cast<int>(request.y), 0, 0};
-  SDL_QueryTexture(texture, nullptr, nullptr, &render_rect.w, &render_rect.h);
-  SDL_SetTextureColorMod(texture, request.r, request.g, request.b);
-  SDL_SetTextureAlphaMod(texture, request.a);
-  SDL_RenderCopy(get_sdl_renderer(), texture, nullptr, &render_rect);
-  SDL_SetTextureColorMod(texture, 255, 255, 255);
-  SDL_SetTextureAlphaMod(texture, 255);
-}
-void Renderer::render_pixel(const IMGRenderRequest& request) const {
-  SDL_SetRenderDrawColor(get_sdl_renderer(), request.r, request.g, request.b,
-                         request.a);
-  SDL_SetRenderDrawBlendMode(get_sdl_renderer(), SDL_BLENDMODE_BLEND);
-  SDL_RenderDrawPoint(get_sdl_renderer(), static_cast<int>(request.x),
-                      static_cast<int>(request.y));
-  SDL_SetRenderDrawColor(get_sdl_renderer(), 255, 255, 255, 255);
-  SDL_SetRenderDrawBlendMode(get_sdl_renderer(), SDL_BLENDMODE_NONE);
+  const float zoom = camera.zoom;
+  const auto rect_x = static_cast<float>(static_cast<int>(
+      WINDOW_WIDTH / 2 / zoom + (request.x - camera.x) * UNIT_DIST - pivot_x));
+  const auto rect_y = static_cast<float>(static_cast<int>(
+      WINDOW_HEIGHT / 2 / zoom + (request.y - camera.y) * UNIT_DIST - pivot_y));
+  const auto rect_w =
+      static_cast<float>(static_cast<int>(w * fabs(request.scale_x)));
+  const auto rect_h =
+      static_cast<float>(static_cast<int>(h * fabs(request.scale_y)));
+
+  const float center_x = rect_x + pivot_x;
+  const float center_y = rect_y + pivot_y;
+  const float radians = glm::radians(request.rotation_degrees);
+  const float cos_r = std::cos(radians);
+  const float sin_r = std::sin(radians);
+  const float local[4][2] = {{rect_x, rect_y},
+                             {rect_x + rect_w, rect_y},
+                             {rect_x + rect_w, rect_y + rect_h},
+                             {rect_x, rect_y + rect_h}};
+  SDL_FPoint corners[4];
+  for (int i = 0; i < 4; i++) {
+    const float dx = local[i][0] - center_x;
+    const float dy = local[i][1] - center_y;
+    corners[i] = {(center_x + dx * cos_r - dy * sin_r) * zoom + origin.x,
+                  (center_y + dx * sin_r + dy * cos_r) * zoom + origin.y};
+  }
+
+  sprite_batch.add(request.texture, corners, request.uv, request.color);
+}
+void Renderer::render_UI_image(const RenderCommand& request,
+                               const SDL_FPoint origin) {
+  if (request.texture == nullptr)
+    return;
+  const auto x = static_cast<float>(static_cast<int>(request.x)) + origin.x;
+  const auto y = static_cast<float>(static_cast<int>(request.y)) + origin.y;
+  const auto w = static_cast<float>(request.size.x);
+  const auto h = static_cast<float>(request.size.y);
+  const SDL_FPoint corners[4] = {
+      {x, y}, {x + w, y}, {x + w, y + h}, {x, y + h}};
+  sprite_batch.add(request.texture, corners, request.uv, request.color);
+}
+// A texture still loading comes back null and zero sized, nothing is drawn
+// for it until upload_loaded_textures swaps the real one in.
+Renderer::Sprite Renderer::resolve_sprite(const std::string& image_name) {
+  if (const auto* region = TextureAtlas::getInstance().find(image_name))
+    return {region->texture, region->uv, {region->width, region->height}};
+  SDL_Texture* texture = textures.find(image_name);
+  if (texture == nullptr) {
+    request_texture_load(image_name);
+    return {nullptr, {0.0f, 0.0f, 1.0f, 1.0f}, {0, 0}};
+  }
+  return {texture, {0.0f, 0.0f, 1.0f, 1.0f},
+          sprite_batch.get_texture_size(texture)};
+}
+bool Renderer::set_premultiplied_blend(SDL_Texture* texture) {
+  const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+      SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+      SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE,
+      SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+  if (SDL_SetTextureBlendMode(texture, premultiplied) == 0)
+    return true;
+  SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+  return false;
+}
+void Renderer::render_pixel_layer(const PixelLayer& layer) {
+  if (layer.empty())
+    return;
+  if (pixel_texture == nullptr) {
+    pixel_texture = SDL_CreateTexture(
+        get_sdl_renderer(), PixelLayer::FORMAT, SDL_TEXTUREACCESS_STREAMING,
+        layer.get_width(), layer.get_height());
+    if (pixel_texture == nullptr) {
+      std::cerr << "Error creating pixel layer: " << SDL_GetError()
+                << std::endl;
+      return;
+    }
+    pixel_texture_premultiplied = set_premultiplied_blend(pixel_texture);
+  }
+
+  // the rest of the texture still holds older frames, only this part is drawn
+  const SDL_Rect dirty = layer.get_dirty_rect();
+  void* locked = nullptr;
+  int pitch = 0;
+  if (SDL_LockTexture(pixel_texture, &dirty, &locked, &pitch) != 0)
+    return;
+  const size_t row_bytes = static_cast<size_t>(dirty.w) * sizeof(uint32_t);
+  auto* out = static_cast<Uint8*>(locked);
+  for (int y = dirty.y; y < dirty.y + dirty.h; y++, out += pitch) {
+    const uint32_t* row = layer.get_row(y) + dirty.x;
+    if (pixel_texture_premultiplied) {
+      std::memcpy(out, row, row_bytes);
+      continue;
+    }
+    unpremultiplied_row.resize(dirty.w);
+    for (int x = 0; x < dirty.w; x++)
+      unpremultiplied_row[x] = PixelLayer::unpremultiply(row[x]);
+    std::memcpy(out, unpremultiplied_row.data(), row_bytes);
+  }
+  SDL_UnlockTexture(pixel_texture);
+  SDL_RenderCopy(get_sdl_renderer(), pixel_texture, &dirty, &dirty);
 }
 
 void Renderer::render_dialogues(
@@ -299,67 +528,554 @@ void Renderer::render_dialogues(
 
 void Renderer::render_text(const std::string& text, const int x, const int y) {
   // arial for now wouldnt really work but helps make it backwards compatible
-  text_render_requests.push_back(
+  frames[recording_frame].texts.push_back(
       {text, DEFAULT_TEXT_SIZE, "arial", DEFAULT_TEXT_COLOR, x, y});
 }
 
-void Renderer::service_text_render_requests() {
-  for (const auto& [text, size, font, color, x, y] : text_render_requests) {
-    TTF_Font* ttf_font = nullptr;
-    if (font_cache.count(font) > 0 and font_cache[font].count(size) > 0) {
-      ttf_font = font_cache[font][size];
-    } else {
-      const std::string font_path = FONTS_PATH + font + ".ttf";
-      if (std::filesystem::exists(font_path)) {
-        ttf_font =
-            TTF_OpenFont((font_path).c_str(), size);
-        font_cache[font][size] = ttf_font;
-      } else {
-        std::cout << "error: font " << font << " missing";
-        std::exit(0);
-      }
+// Queues text onto sprite_batch, the caller flushes.
+void Renderer::service_text_render_requests(
+    std::vector<TextRenderRequest>& texts) {
+  for (const auto& request : texts) {
+    const TextLayout& layout = get_text_layout(request);
+    const auto x = static_cast<float>(request.x);
+    const auto y = static_cast<float>(request.y);
+    for (const auto& quad : layout.quads) {
+      const float left = x + quad.dst.x;
+      const float top = y + quad.dst.y;
+      const SDL_FPoint corners[4] = {{left, top},
+                                     {left + quad.dst.w, top},
+                                     {left + quad.dst.w, top + quad.dst.h},
+                                     {left, top + quad.dst.h}};
+      sprite_batch.add(quad.texture, corners, quad.uv, request.color);
+    }
+  }
+  texts.clear();
+}
+
+TTF_Font* Renderer::get_font(const std::string& font, int size) {
+  auto& sizes = font_cache[font];
+  const auto it = sizes.find(size);
+  if (it != sizes.end())
+    return it->second;
+  const std::string font_path = FONTS_PATH + font + ".ttf";
+  if (not std::filesystem::exists(font_path)) {
+    std::cout << "error: font " << font << " missing";
+    GameThread::quit(0);
+  }
+  TTF_Font* ttf_font = TTF_OpenFont(font_path.c_str(), size);
+  sizes[size] = ttf_font;
+  return ttf_font;
+}
+
+// Pen walk over the string's glyphs, Latin-1 like TTF_RenderText_Solid was.
+const TextLayout& Renderer::get_text_layout(const TextRenderRequest& request) {
+  const std::string key =
+      TextLayoutCache::make_key(request.font_name, request.size, request.text);
+  if (const TextLayout* cached = text_layouts.find(key))
+    return *cached;
+
+  auto& atlas = glyph_atlases[request.font_name][request.size];
+  if (not atlas)
+    atlas = std::make_unique<GlyphAtlas>(
+        get_font(request.font_name, request.size));
+
+  TextLayout layout;
+  layout.height = atlas->get_height();
+  int pen_x = 0;
+  Uint16 previous = 0;
+  for (const char c : request.text) {
+    const auto ch = static_cast<Uint16>(static_cast<unsigned char>(c));
+    if (previous != 0)
+      pen_x += atlas->get_kerning(previous, ch);
+    const GlyphAtlas::Glyph& glyph = atlas->get(get_sdl_renderer(), ch);
+    if (glyph.texture != nullptr) {
+      layout.quads.push_back(
+          {glyph.texture,
+           {static_cast<float>(pen_x + glyph.offset_x), 0.0f,
+            static_cast<float>(glyph.width), static_cast<float>(glyph.height)},
+           glyph.uv});
     }
-    SDL_Surface* surface = TTF_RenderText_Solid(ttf_font, text.c_str(), color);
-    SDL_Texture* texture =
-        SDL_CreateTextureFromSurface(get_sdl_renderer(), surface);
-    SDL_Rect text_rect = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(get_sdl_renderer(), texture, nullptr, &text_rect);
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
+    pen_x += glyph.advance;
+    previous = ch;
   }
-  text_render_requests.clear();
+  layout.width = pen_x;
+  return text_layouts.insert(key, std::move(layout));
+}
+
+RenderFrame::Camera Renderer::capture_camera() {
+  return {CameraManager::cam_x_pos, CameraManager::cam_y_pos,
+          CameraManager::zoom_factor};
 }
 
 void Renderer::end_of_frame_render() {
-  std::stable_sort(img_render_requests.begin(), img_render_requests.end(),
-                   [](const IMGRenderRequest& a, const IMGRenderRequest& b) {
-                     if (a.type != b.type)
-                       return a.type < b.type;
-                     return a.render_order < b.render_order;
+  RenderFrame& frame = frames[presenting_frame];
+  if (not frame.camera_captured)
+    frame.camera = capture_camera();
+  if (not threaded_game_loop) {
+    upload_loaded_textures();
+    manage_textures();
+  }
+  // the recorded copy only matters while the game thread can change layers
+  const std::vector<RenderLayer>& frame_layers =
+      threaded_game_loop ? frame.layers : layers;
+  if (frame.layer_queues.size() < frame_layers.size())
+    frame.layer_queues.resize(frame_layers.size());
+  if (layer_caches.size() < frame_layers.size())
+    layer_caches.resize(frame_layers.size());
+
+  frame_stats.draws = frame.queue.size();
+  frame_stats.culled = 0;
+  frame_stats.layers_cached = 0;
+  frame_stats.layers_redrawn = 0;
+  sprite_batch.begin(get_sdl_renderer());
+
+  // back to front, the unlayered draws go ahead of layers at order 0
+  layer_draw_order.clear();
+  for (uint32_t id = 0; id < frame_layers.size(); id++)
+    layer_draw_order.push_back(id);
+  std::stable_sort(layer_draw_order.begin(), layer_draw_order.end(),
+                   [&frame_layers](uint32_t a, uint32_t b) {
+                     return frame_layers[a].order < frame_layers[b].order;
                    });
-  for (const auto& request : img_render_requests) {
+  bool drew_unlayered = false;
+  for (const uint32_t id : layer_draw_order) {
+    if (not drew_unlayered and frame_layers[id].order >= 0) {
+      draw_queue(frame.queue, frame.camera);
+      drew_unlayered = true;
+    }
+    frame_stats.draws += frame.layer_queues[id].size();
+    draw_layer(frame, id, frame_layers[id]);
+  }
+  if (not drew_unlayered)
+    draw_queue(frame.queue, frame.camera);
+
+  if (not frame.texts.empty())
+    service_text_render_requests(frame.texts);
+  sprite_batch.flush();
+  // pixels went on top of everything before too
+  render_pixel_layer(frame.pixels);
+  frame_stats.pixels = frame.pixels.get_drawn_count();
+
+  frame_stats.sprites = sprite_batch.get_sprite_count();
+  frame_stats.draw_calls = sprite_batch.get_draw_calls();
+  frame_stats.text_layout_hits = text_layouts.get_hits();
+  frame_stats.text_layout_misses = text_layouts.get_misses();
+  // the game thread may be reading stats right now, swap_frames publishes
+  if (not threaded_game_loop) {
+    stats = frame_stats;
+    frame_index++;
+    current_layer = RenderFrame::NO_LAYER;
+  }
+  frame.clear();
+}
+
+void Renderer::draw_queue(RenderQueue& queue,
+                          const RenderFrame::Camera& camera,
+                          const SDL_FPoint origin,
+                          const SDL_FPoint margin) {
+  // camera rect in world units, same mapping as render_scene_image
+  const float view_scale = UNIT_DIST * camera.zoom;
+  queue.cull(camera.x, camera.y,
+             (static_cast<float>(WINDOW_WIDTH) * 0.5f + margin.x) / view_scale,
+             (static_cast<float>(WINDOW_HEIGHT) * 0.5f + margin.y) / view_scale);
+  queue.sort();
+  for (const RenderCommand* command : queue.get_sorted()) {
+    const RenderCommand& request = *command;
     switch (request.type) {
       case IMGType::Scene:
-        render_scene_image(request);
+        render_scene_image(request, camera, origin);
         break;
       case IMGType::UI:
-        render_UI_image(request);
+        render_UI_image(request, origin);
         break;
       case IMGType::Pixel:
-        if (not text_render_requests.empty())
-          service_text_render_requests();
-        render_pixel(request);
+        // not queued anymore, frame.pixels is drawn after everything
         break;
     }
   }
-  if (not text_render_requests.empty())
-    service_text_render_requests();
-  img_render_requests.clear();
+  frame_stats.culled += queue.get_culled_count();
+}
+
+RenderFrame::Camera Renderer::layer_camera(const RenderLayer& layer,
+                                           const RenderFrame::Camera& camera) {
+  return {camera.x * layer.parallax_x + layer.offset_x,
+          camera.y * layer.parallax_y + layer.offset_y, camera.zoom};
 }
 
-void Renderer::cache_texture(const std::string& image_name) {
-  if (textures.count(image_name) > 0)
+void Renderer::draw_layer(RenderFrame& frame,
+                          const uint32_t id,
+                          const RenderLayer& layer) {
+  RenderQueue& queue = frame.layer_queues[id];
+  const RenderFrame::Camera camera = layer_camera(layer, frame.camera);
+  LayerCache& cache = layer_caches[id];
+
+  if (not layer_targets_supported.has_value())
+    layer_targets_supported =
+        SDL_RenderTargetSupported(get_sdl_renderer()) == SDL_TRUE;
+  const RenderLayer::Mode mode = *layer_targets_supported
+                                     ? layer.mode
+                                     : RenderLayer::Mode::DYNAMIC;
+  const LayerCache::View view{camera.x, camera.y, camera.zoom};
+  const auto submission = LayerCache::describe(queue, mode, layer.generation, view);
+  const float view_scale = UNIT_DIST * camera.zoom;
+
+  switch (cache.decide(mode, submission,
+                       static_cast<float>(cache.margin_x) / view_scale,
+                       static_cast<float>(cache.margin_y) / view_scale)) {
+    case LayerCache::Action::SKIP:
+      return;
+    case LayerCache::Action::DRAW:
+      draw_queue(queue, camera);
+      return;
+    case LayerCache::Action::REDRAW:
+      if (not redraw_layer(cache, queue, camera, submission)) {
+        draw_queue(queue, camera);
+        return;
+      }
+      frame_stats.layers_redrawn++;
+      break;
+    case LayerCache::Action::COMPOSITE:
+      frame_stats.layers_cached++;
+      break;
+  }
+
+  // keeps the quads before it underneath
+  sprite_batch.flush();
+  const SDL_FPoint drift = cache.drift(view, UNIT_DIST);
+  const SDL_FRect destination = {
+      drift.x - static_cast<float>(cache.margin_x),
+      drift.y - static_cast<float>(cache.margin_y),
+      static_cast<float>(cache.width), static_cast<float>(cache.height)};
+  SDL_RenderCopyF(get_sdl_renderer(), cache.texture, nullptr, &destination);
+}
+
+// Blending each draw onto transparent black leaves the texture holding
+// premultiplied colour, so it's composited with the premultiplied blend.
+bool Renderer::redraw_layer(LayerCache& cache,
+                            RenderQueue& queue,
+                            const RenderFrame::Camera& camera,
+                            const LayerCache::Submission& submission) {
+  SDL_Renderer* renderer = get_sdl_renderer();
+  const int margin_x =
+      submission.has_scene
+          ? static_cast<int>(static_cast<float>(WINDOW_WIDTH) * LAYER_MARGIN)
+          : 0;
+  const int margin_y =
+      submission.has_scene
+          ? static_cast<int>(static_cast<float>(WINDOW_HEIGHT) * LAYER_MARGIN)
+          : 0;
+  const int width = WINDOW_WIDTH + 2 * margin_x;
+  const int height = WINDOW_HEIGHT + 2 * margin_y;
+  if (cache.texture == nullptr or cache.width != width or
+      cache.height != height) {
+    if (cache.texture != nullptr)
+      SDL_DestroyTexture(cache.texture);
+    cache.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                      SDL_TEXTUREACCESS_TARGET, width, height);
+    cache.width = width;
+    cache.height = height;
+    if (cache.texture == nullptr) {
+      cache.invalidate();
+      return false;
+    }
+    set_premultiplied_blend(cache.texture);
+  }
+
+  sprite_batch.flush();
+  SDL_Texture* previous_target = SDL_GetRenderTarget(renderer);
+  if (SDL_SetRenderTarget(renderer, cache.texture) != 0) {
+    cache.invalidate();
+    return false;
+  }
+  Uint8 r, g, b, a;
+  SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+  SDL_RenderClear(renderer);
+  SDL_SetRenderDrawColor(renderer, r, g, b, a);
+
+  const SDL_FPoint margin = {static_cast<float>(margin_x),
+                             static_cast<float>(margin_y)};
+  draw_queue(queue, camera, margin, margin);
+  sprite_batch.flush();
+  SDL_SetRenderTarget(renderer, previous_target);
+
+  cache.margin_x = margin_x;
+  cache.margin_y = margin_y;
+  cache.store(submission);
+  return true;
+}
+
+void Renderer::drop_layer_caches() {
+  for (auto& cache : layer_caches)
+    cache.invalidate();
+}
+
+uint32_t Renderer::find_or_add_layer(const std::string& layer_name) {
+  const auto next_id = static_cast<uint32_t>(layers.size());
+  const auto [it, inserted] = layer_ids.try_emplace(layer_name, next_id);
+  if (inserted) {
+    RenderLayer layer;
+    layer.name = layer_name;
+    layers.push_back(layer);
+  }
+  return it->second;
+}
+
+void Renderer::LuaSetLayer(const std::string& layer_name,
+                           const int order,
+                           const float parallax_x,
+                           const float parallax_y,
+                           const std::string& mode) {
+  RenderLayer& layer = layers[find_or_add_layer(layer_name)];
+  RenderLayer::Mode parsed = layer.mode;
+  if (not RenderLayer::parse_mode(mode, parsed)) {
+    std::cout << "error: unknown layer mode " << mode;
+    GameThread::quit(0);
+  }
+  if (layer.order != order or layer.parallax_x != parallax_x or
+      layer.parallax_y != parallax_y or layer.mode != parsed)
+    layer.generation++;
+  layer.order = order;
+  layer.parallax_x = parallax_x;
+  layer.parallax_y = parallax_y;
+  layer.mode = parsed;
+}
+
+// moves the layer's camera, cached layers only redraw once it's scrolled
+// past their margin
+void Renderer::LuaSetLayerOffset(const std::string& layer_name,
+                                 const float x,
+                                 const float y) {
+  RenderLayer& layer = layers[find_or_add_layer(layer_name)];
+  layer.offset_x = x;
+  layer.offset_y = y;
+}
+
+void Renderer::LuaBeginLayer(const std::string& layer_name) {
+  current_layer = find_or_add_layer(layer_name);
+}
+
+void Renderer::LuaEndLayer() {
+  current_layer = RenderFrame::NO_LAYER;
+}
+
+void Renderer::LuaInvalidateLayer(const std::string& layer_name) {
+  if (const auto it = layer_ids.find(layer_name); it != layer_ids.end())
+    layers[it->second].generation++;
+}
+
+void Renderer::invalidate_layers() {
+  for (auto& layer : layers)
+    layer.generation++;
+  current_layer = RenderFrame::NO_LAYER;
+}
+
+void Renderer::swap_frames() {
+  RenderFrame& recorded = frames[recording_frame];
+  recorded.camera = capture_camera();
+  recorded.camera_captured = true;
+
+  upload_loaded_textures();
+  manage_textures();
+  resolve_images();
+  for (const auto& pending : recorded.pending_images) {
+    resolve_image(pending.image);
+    RenderQueue& queue = recorded.get_queue(pending.layer);
+    RenderCommand& command = queue.get_command(pending.command);
+    apply_sprite(command, image_sprites[pending.image]);
+    if (command.type == IMGType::Scene)
+      queue.set_bound(pending.command, command.x, command.y,
+                      scene_bound_radius(command));
+  }
+  recorded.pending_images.clear();
+  recorded.layers = layers;
+  current_layer = RenderFrame::NO_LAYER;
+
+  stats = frame_stats;
+  frame_index++;
+  presenting_frame = recording_frame;
+  recording_frame = 1 - recording_frame;
+}
+
+luabridge::LuaRef Renderer::LuaGetRenderStats() {
+  const auto& renderer = getInstance();
+  luabridge::LuaRef stats = luabridge::newTable(App::ECS::getInstance().get_lua_state());
+  stats["draws"] = static_cast<int>(renderer.stats.draws);
+  stats["culled"] = static_cast<int>(renderer.stats.culled);
+  stats["sprites"] = static_cast<int>(renderer.stats.sprites);
+  stats["draw_calls"] = static_cast<int>(renderer.stats.draw_calls);
+  stats["text_layout_hits"] =
+      static_cast<int>(renderer.stats.text_layout_hits);
+  stats["text_layout_misses"] =
+      static_cast<int>(renderer.stats.text_layout_misses);
+  stats["texture_uploads"] = static_cast<int>(renderer.stats.texture_uploads);
+  stats["textures_loading"] =
+      static_cast<int>(renderer.stats.textures_loading);
+  stats["textures_resident"] =
+      static_cast<int>(renderer.stats.textures_resident);
+  stats["texture_bytes"] = static_cast<double>(renderer.stats.texture_bytes);
+  stats["textures_evicted"] =
+      static_cast<int>(renderer.stats.textures_evicted);
+  stats["pixels"] = static_cast<int>(renderer.stats.pixels);
+  stats["layers_cached"] = static_cast<int>(renderer.stats.layers_cached);
+  stats["layers_redrawn"] = static_cast<int>(renderer.stats.layers_redrawn);
+  return stats;
+}
+
+// Doesn't touch the texture map, so the game thread can call it too.
+void Renderer::request_texture_load(const std::string& image_name) {
+  const std::string image_path =
+      getInstance().IMAGES_PATH + image_name + ".png";
+  if (not std::filesystem::exists(image_path)) {
+    std::cout << "error: missing image " << image_name;
+    GameThread::quit(0);
+  }
+  TextureLoader::getInstance().request(image_name, image_path);
+}
+
+void Renderer::upload_loaded_textures() {
+  {
+    std::lock_guard lock(preload_fonts_mutex);
+    for (const auto& font_name : preload_fonts)
+      get_font(font_name, PRELOAD_FONT_SIZE);
+    preload_fonts.clear();
+  }
+
+  const size_t budget = upload_all_textures.exchange(false)
+                            ? std::numeric_limits<size_t>::max()
+                            : texture_upload_budget;
+  frame_stats.texture_uploads = TextureLoader::getInstance().upload(
+      get_sdl_renderer(), budget,
+      [this](const std::string& image_name, SDL_Texture* texture) {
+        if (texture == nullptr) {
+          std::cerr << "Error loading texture " << image_name << std::endl;
+          return;
+        }
+        // get_or_create_texture may have got there first
+        if (textures.contains(image_name))
+          SDL_DestroyTexture(texture);
+        else
+          add_texture(image_name, texture);
+        const auto id = image_ids.find(image_name);
+        if (id != image_ids.end() and id->second < image_sprites.size())
+          image_sprites[id->second] = resolve_sprite(image_name);
+      });
+  frame_stats.textures_loading =
+      TextureLoader::getInstance().get_loading_count();
+}
+
+void Renderer::add_texture(const std::string& image_name,
+                           SDL_Texture* texture) {
+  Uint32 format = 0;
+  int w = 0;
+  int h = 0;
+  SDL_QueryTexture(texture, &format, nullptr, &w, &h);
+  const size_t bytes = static_cast<size_t>(w) * static_cast<size_t>(h) *
+                       std::max(1, static_cast<int>(SDL_BYTESPERPIXEL(format)));
+  textures.insert(image_name, texture, bytes, frame_index);
+}
+
+// The next draw of it resolves again, which starts a new load.
+void Renderer::on_texture_evicted(const std::string& image_name,
+                                  SDL_Texture* texture) {
+  SDL_DestroyTexture(texture);
+  TextureLoader::getInstance().forget(image_name);
+  const auto id = image_ids.find(image_name);
+  if (id != image_ids.end() and id->second < image_sprites.size())
+    image_sprites[id->second] = {nullptr, {0.0f, 0.0f, 1.0f, 1.0f}, {0, 0},
+                                 true};
+}
+
+void Renderer::set_scene_textures(const std::set<std::string>& image_names) {
+  std::lock_guard lock(scene_textures_mutex);
+  next_scene_textures = image_names;
+}
+
+// Main thread, with the game thread parked when it is running. Nothing in
+// the frame about to be drawn (frame_index) is freed.
+void Renderer::manage_textures() {
+  std::optional<std::set<std::string>> next;
+  {
+    std::lock_guard lock(scene_textures_mutex);
+    next.swap(next_scene_textures);
+  }
+  for (const uint32_t id : drawn_images)
+    textures.touch(image_names[id], image_last_used[id]);
+  drawn_images.clear();
+
+  if (next) {
+    // acquire first so anything both scenes use never drops to zero
+    for (const auto& image_name : *next)
+      textures.acquire(image_name);
+    for (const auto& image_name : scene_textures)
+      textures.release(image_name);
+    scene_textures = std::move(*next);
+    textures.drop_unreferenced(frame_index, &on_texture_evicted);
+  }
+  textures.trim(frame_index, &on_texture_evicted);
+
+  frame_stats.textures_resident = textures.size();
+  frame_stats.texture_bytes = textures.get_resident_bytes();
+  frame_stats.textures_evicted = textures.get_evicted_count();
+  if (texture_stats_wanted)
+    refresh_texture_stats();
+}
+
+void Renderer::refresh_texture_stats() {
+  texture_stats.clear();
+  textures.for_each([this](const std::string& image_name,
+                           const TextureCache::Entry& entry,
+                           uint32_t references) {
+    texture_stats.push_back(
+        {image_name, entry.bytes, references, entry.last_used});
+  });
+  std::sort(texture_stats.begin(), texture_stats.end(),
+            [](const TextureStats& a, const TextureStats& b) {
+              return a.bytes > b.bytes;
+            });
+}
+
+luabridge::LuaRef Renderer::LuaGetTextureStats() {
+  auto& renderer = getInstance();
+  // the texture cache is the main thread's, let the next swap fill it in
+  renderer.texture_stats_wanted = true;
+  if (not renderer.threaded_game_loop)
+    renderer.refresh_texture_stats();
+  lua_State* lua_state = App::ECS::getInstance().get_lua_state();
+  luabridge::LuaRef rows = luabridge::newTable(lua_state);
+  int index = 1;
+  for (const auto& texture : renderer.texture_stats) {
+    luabridge::LuaRef row = luabridge::newTable(lua_state);
+    row["name"] = texture.name;
+    row["bytes"] = static_cast<double>(texture.bytes);
+    row["references"] = static_cast<int>(texture.references);
+    row["last_used"] = static_cast<double>(texture.last_used);
+    rows[index++] = row;
+  }
+  return rows;
+}
+
+void Renderer::preload_texture(const std::string& image_name) {
+  if (TextureAtlas::getInstance().find(image_name) == nullptr)
+    request_texture_load(image_name);
+}
+
+void Renderer::preload_font(const std::string& font_name) {
+  std::lock_guard lock(preload_fonts_mutex);
+  preload_fonts.push_back(font_name);
+}
+
+void Renderer::LuaPreload(const luabridge::LuaRef& image_names_table) {
+  if (not image_names_table.isTable())
     return;
+  for (luabridge::Iterator it(image_names_table); not it.isNil(); ++it) {
+    const luabridge::LuaRef value = it.value();
+    if (value.isString())
+      preload_texture(value.cast<std::string>());
+  }
+}
+
+void Renderer::load_texture_file(const std::string& image_name) {
   const auto& renderer = getInstance();
   const std::string image_path = renderer.IMAGES_PATH + image_name + ".png";
   if (std::filesystem::exists(image_path)) {
@@ -368,25 +1084,29 @@ void Renderer::cache_texture(const std::string& image_name) {
     if (image_texture == nullptr) {
       std::cerr << "Error loading texture " << image_name << ": " << IMG_GetError() << std::endl;
     } else {
-      textures[image_name] = image_texture;
+      add_texture(image_name, image_texture);
     }
   } else {
     std::cout << "error: missing image " << image_name;
-    std::exit(0);
+    GameThread::quit(0);
   }
 }
 
+// Standalone texture, loaded even for atlas images since the caller wants
+// something it can hand to SDL_RenderCopy whole.
 SDL_Texture* Renderer::get_or_create_texture(const std::string& image_name) {
-  if (textures.count(image_name) > 0)
-    return textures.at(image_name);
-  cache_texture(image_name);
+  if (not textures.contains(image_name))
+    load_texture_file(image_name);
   //    std::cout << "[SUS] SPRITE " << image_name << " NOT PREVIOUSLY
   //    CACHED!\n";
-  return textures.at(image_name);
+  textures.touch(image_name, frame_index);
+  return textures.find(image_name);
 }
 
 std::pair<int, int> Renderer::get_image_dimensions(
     const std::string& image_name) {
+  if (const auto* region = TextureAtlas::getInstance().find(image_name))
+    return {region->width, region->height};
   SDL_Texture* image_texture = get_or_create_texture(image_name);
   int w, h;
   SDL_QueryTexture(image_texture, nullptr, nullptr, &w, &h);
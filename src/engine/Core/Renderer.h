@@ -17,14 +17,54 @@
 // clang-format on
 
 #include <rapidjson/document.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <unordered_map>
 #include <utility>
 
 #include "Actor.h"
 #include "EngineUtils.h"
+#include "FramePacer.h"
 #include "Helper.h"
+#include "GlyphAtlas.h"
+#include "PixelLayer.h"
+#include "RenderLayer.h"
+#include "RenderQueue.h"
+#include "SpriteBatch.h"
+#include "TextLayoutCache.h"
+#include "TextureCache.h"
+
+#include <memory>
+
+// last frame's numbers, Image.GetStats
+struct RenderStats {
+  size_t draws = 0;   // Image.Draw* calls
+  size_t culled = 0;  // of those, dropped for being off camera
+  size_t sprites = 0; // quads batched, text glyphs included
+  size_t draw_calls = 0;
+  size_t text_layout_hits = 0;
+  size_t text_layout_misses = 0;
+  size_t texture_uploads = 0;
+  size_t textures_loading = 0;  // decoding or waiting for upload budget
+  size_t textures_resident = 0;
+  size_t texture_bytes = 0;
+  size_t textures_evicted = 0;  // since startup
+  size_t pixels = 0;            // Image.DrawPixel(s) that landed on screen
+  size_t layers_cached = 0;     // copied in from their texture as they were
+  size_t layers_redrawn = 0;    // drawn into their texture again
+};
 
-#include <deque>
+// one row of Image.GetTextureStats
+struct TextureStats {
+  std::string name;
+  size_t bytes;
+  uint32_t references;
+  uint64_t last_used;
+};
 
 struct TextRenderRequest {
   std::string text;
@@ -34,8 +74,60 @@ struct TextRenderRequest {
   int x, y;
 };
 
+// Everything one frame draws. With the threaded game loop the game thread
+// records into one while the main thread draws the other (see GameThread),
+// otherwise the same one is recorded and drawn.
+struct RenderFrame {
+  struct Camera {
+    float x = 0.0f;
+    float y = 0.0f;
+    float zoom = 1.0f;
+  };
+  static constexpr uint32_t NO_LAYER = UINT32_MAX;
+  // recorded before the image was ever loaded, fixed up by swap_frames
+  struct PendingImage {
+    size_t command;
+    uint32_t image;
+    uint32_t layer;
+  };
+
+  // draws outside any layer
+  RenderQueue queue;
+  // Image.BeginLayer draws, by layer id
+  std::vector<RenderQueue> layer_queues;
+  // the layers' settings as they were when this frame was recorded
+  std::vector<RenderLayer> layers;
+  std::vector<TextRenderRequest> texts;
+  PixelLayer pixels;
+  std::vector<PendingImage> pending_images;
+  Camera camera;
+  bool camera_captured = false;
+
+  RenderQueue& get_queue(uint32_t layer) {
+    return layer == NO_LAYER ? queue : layer_queues[layer];
+  }
+
+  void clear() {
+    queue.clear();
+    for (auto& layer_queue : layer_queues)
+      layer_queue.clear();
+    texts.clear();
+    pixels.clear();
+    pending_images.clear();
+    camera_captured = false;
+  }
+};
+
 class Renderer {
-  static std::unordered_map<std::string, SDL_Texture*> textures;
+  // where to sample an image from, its atlas page when it was packed
+  struct Sprite {
+    SDL_Texture* texture;
+    SDL_FRect uv;
+    SDL_Point size;
+    bool evicted = false;  // resolve again before drawing
+  };
+
+  static TextureCache textures;
   Renderer(){};
   int WINDOW_WIDTH = 640;
   int WINDOW_HEIGHT = 360;
@@ -51,8 +143,66 @@ class Renderer {
   std::vector<std::string> intro_texts;
   std::unordered_map<std::string, std::unordered_map<int, TTF_Font*>>
       font_cache;
-  static std::vector<TextRenderRequest> text_render_requests;
-  static std::deque<IMGRenderRequest> img_render_requests;
+  // same keys as font_cache, made when text first uses the font
+  std::unordered_map<std::string,
+                     std::unordered_map<int, std::unique_ptr<GlyphAtlas>>>
+      glyph_atlases;
+  static constexpr size_t TEXT_LAYOUT_CACHE_SIZE = 256;
+  TextLayoutCache text_layouts{TEXT_LAYOUT_CACHE_SIZE};
+  static std::array<RenderFrame, 2> frames;
+  static size_t recording_frame;
+  static size_t presenting_frame;
+  bool threaded_game_loop = false;
+  bool headless = false;
+  int target_frame_rate = FramePacer::DEFAULT_TARGET_RATE;
+  // pixel bytes TextureLoader may turn into textures per frame
+  size_t texture_upload_budget = 4096 * 1024;
+  // streaming, see render_pixel_layer. Straight alpha when the renderer
+  // can't do the premultiplied blend mode.
+  SDL_Texture* pixel_texture = nullptr;
+  bool pixel_texture_premultiplied = true;
+  std::vector<uint32_t> unpremultiplied_row;
+  // set by a scene preload, its images shouldn't trickle in
+  std::atomic<bool> upload_all_textures{false};
+  // fonts a scene asked for, opened on the main thread at the default size
+  static constexpr int PRELOAD_FONT_SIZE = 16;
+  std::mutex preload_fonts_mutex;
+  std::vector<std::string> preload_fonts;
+
+  // Image.Draw* names interned to ids. The game side interns, sprites are
+  // only ever appended on the main thread while the game thread is parked,
+  // so recording never has to touch SDL or the texture map.
+  static std::unordered_map<std::string, uint32_t> image_ids;
+  static std::vector<std::string> image_names;
+  static std::vector<Sprite> image_sprites;
+  // frame each image id was last recorded in, game side like image_names
+  static std::vector<uint64_t> image_last_used;
+  // ids recorded since the last manage_textures, each once per frame, so
+  // only those get touched instead of every name ever interned
+  static std::vector<uint32_t> drawn_images;
+  // counts recorded frames, only advanced on the main thread
+  static uint64_t frame_index;
+
+  // named layers, game side like image_names; each frame records a copy
+  static std::vector<RenderLayer> layers;
+  static std::unordered_map<std::string, uint32_t> layer_ids;
+  // where Image.Draw* goes, reset every frame in case EndLayer was missed
+  static uint32_t current_layer;
+  // by layer id, main thread. Cached scene layers are drawn this much of
+  // the window wider on each side, so the camera can scroll that far before
+  // the texture has to be drawn again.
+  static constexpr float LAYER_MARGIN = 0.5f;
+  std::vector<LayerCache> layer_caches;
+  std::vector<uint32_t> layer_draw_order;
+  std::optional<bool> layer_targets_supported;
+
+  // names the current scene holds a reference to, see set_scene_textures
+  std::set<std::string> scene_textures;
+  std::mutex scene_textures_mutex;
+  std::optional<std::set<std::string>> next_scene_textures;
+  // Image.GetTextureStats, refreshed each frame once asked for
+  std::atomic<bool> texture_stats_wanted{false};
+  std::vector<TextureStats> texture_stats;
 
   bool showed_intro = false;
   // const std::string IMAGES_PATH = "resources/images/";
@@ -78,11 +228,18 @@ class Renderer {
   void cleanup();
 
   ~Renderer() {
-    for (auto& texture : textures) {
-      SDL_DestroyTexture(texture.second);
-    }
-    textures.clear();
-
+    if (pixel_texture != nullptr)
+      SDL_DestroyTexture(pixel_texture);
+    for (auto& cache : layer_caches)
+      if (cache.texture != nullptr)
+        SDL_DestroyTexture(cache.texture);
+    textures.clear([](const std::string&, SDL_Texture* texture) {
+      SDL_DestroyTexture(texture);
+    });
+
+    // layouts point into the glyph atlases
+    text_layouts.clear();
+    glyph_atlases.clear();
     for (auto& font : font_cache) {
       for (auto& font_size : font.second) {
         TTF_CloseFont(font_size.second);
@@ -95,8 +252,10 @@ class Renderer {
   }
 
   void reset() {
-    img_render_requests.clear();
-    text_render_requests.clear();
+    for (auto& frame : frames)
+      frame.clear();
+    recording_frame = 0;
+    presenting_frame = 0;
   }
 
   [[nodiscard]] float get_zoom_factor() const { return ZOOM_FACTOR; }
@@ -130,6 +289,16 @@ class Renderer {
 
   [[nodiscard]] size_t get_image_count() const { return intro_images.size(); }
   [[nodiscard]] size_t get_text_count() const { return intro_texts.size(); }
+  [[nodiscard]] const TextLayoutCache& get_text_layout_cache() const {
+    return text_layouts;
+  }
+  [[nodiscard]] const RenderStats& get_render_stats() const { return stats; }
+  [[nodiscard]] bool is_game_loop_threaded() const {
+    return threaded_game_loop;
+  }
+  // before initialize, see App::Window::Settings::is_headless
+  void set_headless(bool value) { headless = value; }
+  [[nodiscard]] bool is_headless() const { return headless; }
   void render_cached_image(const std::string& image_name);
 
   void render_text(const std::string& text, const int x, const int y);
@@ -142,7 +311,10 @@ class Renderer {
   void render_HUD(int health, int score);
   static SDL_RendererFlip get_renderer_flip(const bool horizontal_flip,
                                             const bool vertical_flip);
-  void service_text_render_requests();
+  // queues text onto sprite_batch and empties texts
+  void service_text_render_requests(std::vector<TextRenderRequest>& texts);
+  TTF_Font* get_font(const std::string& font, int size);
+  const TextLayout& get_text_layout(const TextRenderRequest& request);
   void set_showed_intro(const std::optional<bool> status = std::nullopt) {
     if (status.has_value())
       showed_intro = status.value();
@@ -156,9 +328,26 @@ class Renderer {
                           int windowHeight,
                           float zoomFactor);
 
-  static void cache_texture(const std::string& image_name);
+  // starts an async load, see TextureLoader
+  static void request_texture_load(const std::string& image_name);
+  void upload_loaded_textures();
+  // Any thread, see SceneManifest. Textures requested before the next frame
+  // all go up then, regardless of the upload budget.
+  static void preload_texture(const std::string& image_name);
+  void preload_font(const std::string& font_name);
+  void upload_all_textures_next_frame() { upload_all_textures = true; }
+  // Any thread. The scene holds these from the next frame on, and whatever
+  // the previous scene held but this one doesn't can be freed.
+  void set_scene_textures(const std::set<std::string>& image_names);
+  // main thread, after upload_loaded_textures: references, eviction, stats
+  void manage_textures();
+  void refresh_texture_stats();
+  static void add_texture(const std::string& image_name, SDL_Texture* texture);
+  static void on_texture_evicted(const std::string& image_name,
+                                 SDL_Texture* texture);
   [[nodiscard]] static SDL_Texture* get_or_create_texture(
       const std::string& image_name);
+  static void load_texture_file(const std::string& image_name);
 
   [[nodiscard]] static std::pair<int, int> get_image_dimensions(
       const std::string& image_name);
@@ -171,6 +360,9 @@ class Renderer {
   const int EPS = 50;
 
   void end_of_frame_render();
+  // Threaded game loop only, with the game thread parked: the frame just
+  // recorded becomes the one end_of_frame_render draws.
+  void swap_frames();
 
   // HW 7 lua specific exposition ?
   static void log_error(const std::string& actor_name,
@@ -207,16 +399,83 @@ class Renderer {
                         float b,
                         float a,
                         int render_order);
+  [[nodiscard]] static luabridge::LuaRef LuaGetRenderStats();
+  // resident textures, biggest first. A frame old with the threaded game loop.
+  [[nodiscard]] static luabridge::LuaRef LuaGetTextureStats();
+  // decodes ahead of time so the first draw doesn't wait on it
+  static void LuaPreload(const luabridge::LuaRef& image_names_table);
   static void LuaDrawPixel(float x,
                            float y,
                            float r,
                            float g,
                            float b,
                            float a);
-
-  void render_scene_image(const IMGRenderRequest& request) const;
-  void render_UI_image(const IMGRenderRequest& request) const;
-  void render_pixel(const IMGRenderRequest& request) const;
+  // positions is {x1, y1, x2, y2, ...}, colors either one {r, g, b, a} for
+  // all of them or four entries per pixel
+  static void LuaDrawPixels(const luabridge::LuaRef& positions,
+                            const luabridge::LuaRef& colors);
+  // mode is "dynamic", "static" or "on_change", see RenderLayer
+  static void LuaSetLayer(const std::string& layer_name,
+                          int order,
+                          float parallax_x,
+                          float parallax_y,
+                          const std::string& mode);
+  static void LuaSetLayerOffset(const std::string& layer_name,
+                                float x,
+                                float y);
+  static void LuaBeginLayer(const std::string& layer_name);
+  static void LuaEndLayer();
+  static void LuaInvalidateLayer(const std::string& layer_name);
+  // game side, every cached layer gets drawn again (scene changes)
+  static void invalidate_layers();
+  // main thread, the render targets lost what was in them
+  void drop_layer_caches();
+
+  // both only queue a quad on sprite_batch, origin shifts it on the target
+  void render_scene_image(const RenderCommand& request,
+                          const RenderFrame::Camera& camera,
+                          SDL_FPoint origin = {0.0f, 0.0f});
+  void render_UI_image(const RenderCommand& request,
+                       SDL_FPoint origin = {0.0f, 0.0f});
+  // culls, sorts and queues everything; margin widens the cull rect
+  void draw_queue(RenderQueue& queue,
+                  const RenderFrame::Camera& camera,
+                  SDL_FPoint origin = {0.0f, 0.0f},
+                  SDL_FPoint margin = {0.0f, 0.0f});
+  void draw_layer(RenderFrame& frame, uint32_t id, const RenderLayer& layer);
+  // false when there's no render target to draw it into
+  bool redraw_layer(LayerCache& cache,
+                    RenderQueue& queue,
+                    const RenderFrame::Camera& camera,
+                    const LayerCache::Submission& submission);
+  [[nodiscard]] static RenderFrame::Camera layer_camera(
+      const RenderLayer& layer,
+      const RenderFrame::Camera& camera);
+  static uint32_t find_or_add_layer(const std::string& layer_name);
+  // ONE, ONE_MINUS_SRC_ALPHA on texture, BLEND when the renderer can't
+  static bool set_premultiplied_blend(SDL_Texture* texture);
+  // uploads the drawn part of the layer and draws it in one copy
+  void render_pixel_layer(const PixelLayer& layer);
+
+  Sprite resolve_sprite(const std::string& image_name);
+  static void resolve_images();
+  // one image, including one evicted since it was resolved
+  static void resolve_image(uint32_t id);
+  static void apply_sprite(RenderCommand& command, const Sprite& sprite);
+  [[nodiscard]] static float scene_bound_radius(const RenderCommand& command);
+  static constexpr uint32_t NO_PENDING_IMAGE = UINT32_MAX;
+  // fills in texture, uv and size, or returns the image id to fix up later
+  static uint32_t fill_image(RenderCommand& command,
+                             const std::string& image_name);
+  static void submit(const RenderCommand& command,
+                     int render_order,
+                     uint32_t pending_image);
+  static RenderFrame::Camera capture_camera();
+
+  SpriteBatch sprite_batch;
+  // written by end_of_frame_render, published to stats when it is safe
+  RenderStats frame_stats;
+  RenderStats stats;
 };
 
 #endif  // PULSAR_SRC_ENGINE_CORE_RENDERER_H_
@@ -3,17 +3,24 @@
 //
 
 #include "Rigidbody.h"
+#include <algorithm>
 #include <cmath>
 
-const uint16 Rigidbody::CATEGORY_COLLIDER = 0x0001;  // Binary: 0000000000000001
-const uint16 Rigidbody::CATEGORY_TRIGGER = 0x0002;   // Binary: 0000000000000010
-const uint16 Rigidbody::CATEGORY_PHANTOM = 0x0004;   // Binary: 0000000000000100
+#include "PhysicsConfig.h"
+#include "PhysicsPipeline.h"
+#include "StaticGeometry.h"
+
+const uint16 Rigidbody::CATEGORY_COLLIDER = 0x00FF;  // Binary: 0000000011111111
+const uint16 Rigidbody::CATEGORY_TRIGGER = 0xFF00;   // Binary: 1111111100000000
+const uint16 Rigidbody::CATEGORY_PHANTOM = 0x0000;
 
 Rigidbody::Rigidbody()
     : x(0.0f),
       y(0.0f),
       body_type("dynamic"),
       precise(true),
+      auto_ccd(true),
+      allow_sleep(true),
       gravity_scale(1.0f),
       density(1.0f),
       angular_friction(0.3f),
@@ -33,6 +40,10 @@ Rigidbody::~Rigidbody() {
 }
 
 void Rigidbody::Initialize() {
+  // tile colliders get merged with their neighbours instead
+  if (not body and mergeable and StaticGeometry::getInstance().try_add(this))
+    return;
+
   b2BodyDef bodyDef;
   if (body_type == "static")
     bodyDef.type = b2_staticBody;
@@ -42,17 +53,17 @@ void Rigidbody::Initialize() {
     bodyDef.type = b2_dynamicBody;
 
   bodyDef.position.Set(x, y);
-  bodyDef.bullet = precise;
+  // auto_ccd bodies start off as regular bodies, update_ccd flips them
+  bodyDef.bullet = precise and not auto_ccd;
   bodyDef.angularDamping = angular_friction;
   bodyDef.gravityScale = gravity_scale;
+  bodyDef.allowSleep = allow_sleep;
   bodyDef.angle = to_radian(rotation);
   // rotation is in degrees, angle in radians
 
   if (not body)
     body = SceneManager::getInstance().GetPhysWorld()->CreateBody(&bodyDef);
-
-  b2PolygonShape shape;
-  shape.SetAsBox(0.5f, 0.5f);
+  capture_snapshot();
 
   if (not has_collider and not has_trigger)
     CreatePhantomFixture();
@@ -62,12 +73,14 @@ void Rigidbody::Initialize() {
     CreateTrigger();
 }
 
+// Box2D clones the shape into its own allocator in CreateFixture, so the
+// shapes below only need to live on the stack.
 void Rigidbody::CreatePhantomFixture() {
-  auto* polygon_shape = new b2PolygonShape();
-  polygon_shape->SetAsBox(collider_width * 0.5f, collider_height * 0.5f);
+  b2PolygonShape polygon_shape;
+  polygon_shape.SetAsBox(collider_width * 0.5f, collider_height * 0.5f);
   b2FixtureDef fixture_def;
 
-  fixture_def.shape = polygon_shape;
+  fixture_def.shape = &polygon_shape;
   fixture_def.density = density;
   fixture_def.isSensor = true;
   fixture_def.userData.pointer = reinterpret_cast<uintptr_t>(actor);
@@ -78,15 +91,17 @@ void Rigidbody::CreatePhantomFixture() {
 }
 
 void Rigidbody::CreateCollider() {
+  b2PolygonShape polygon_shape;
+  b2CircleShape circle_shape;
   b2Shape* shape = nullptr;
   if (collider_type == "box") {
-    auto* polygon_shape = new b2PolygonShape();
-    polygon_shape->SetAsBox(collider_width * 0.5f, collider_height * 0.5f);
-    shape = polygon_shape;
+    polygon_shape.SetAsBox(collider_width * 0.5f, collider_height * 0.5f);
+    shape = &polygon_shape;
+    min_extent = std::min(collider_width, collider_height) * 0.5f;
   } else if (collider_type == "circle") {
-    auto* circle_shape = new b2CircleShape();
-    circle_shape->m_radius = collider_radius;
-    shape = circle_shape;
+    circle_shape.m_radius = collider_radius;
+    shape = &circle_shape;
+    min_extent = collider_radius;
   }
   b2FixtureDef fixture_def;
   fixture_def.shape = shape;
@@ -95,21 +110,20 @@ void Rigidbody::CreateCollider() {
   fixture_def.restitution = bounciness;
   fixture_def.friction = friction;
   fixture_def.userData.pointer = reinterpret_cast<uintptr_t>(actor);
-  fixture_def.filter.categoryBits = CATEGORY_COLLIDER;
-  fixture_def.filter.maskBits = CATEGORY_COLLIDER;
+  fixture_def.filter = get_collider_filter();
   body->CreateFixture(&fixture_def);
 }
 
 void Rigidbody::CreateTrigger() {
+  b2PolygonShape polygon_shape;
+  b2CircleShape circle_shape;
   b2Shape* shape = nullptr;
   if (trigger_type == "box") {
-    auto* polygon_shape = new b2PolygonShape();
-    polygon_shape->SetAsBox(trigger_width * 0.5f, trigger_height * 0.5f);
-    shape = polygon_shape;
+    polygon_shape.SetAsBox(trigger_width * 0.5f, trigger_height * 0.5f);
+    shape = &polygon_shape;
   } else if (trigger_type == "circle") {
-    auto* circle_shape = new b2CircleShape();
-    circle_shape->m_radius = trigger_radius;
-    shape = circle_shape;
+    circle_shape.m_radius = trigger_radius;
+    shape = &circle_shape;
   }
   b2FixtureDef fixture_def;
   fixture_def.shape = shape;
@@ -118,8 +132,14 @@ void Rigidbody::CreateTrigger() {
   fixture_def.restitution = bounciness;
   fixture_def.friction = friction;
   fixture_def.userData.pointer = reinterpret_cast<uintptr_t>(actor);
-  fixture_def.filter.categoryBits = CATEGORY_TRIGGER;
-  fixture_def.filter.maskBits = CATEGORY_TRIGGER;
+  const b2Filter collider_filter = get_collider_filter();
+  trigger_category = collider_filter.categoryBits;
+  trigger_mask = collider_filter.maskBits;
+  trigger_is_circle = trigger_type == "circle";
+  fixture_def.filter.categoryBits =
+      static_cast<uint16>(collider_filter.categoryBits << 8);
+  fixture_def.filter.maskBits =
+      static_cast<uint16>(collider_filter.maskBits << 8);
   body->CreateFixture(&fixture_def);
 }
 
@@ -127,42 +147,87 @@ void Rigidbody::SetPosition(const b2Vec2& pos) {
   if (not body) {
     x = pos.x;
     y = pos.y;
+    leave_static_geometry();
   } else {
+    snapshot.position = pos;
+    if (defer([this, pos] { SetPosition(pos); }))
+      return;
     body->SetTransform(pos, body->GetAngle());
   }
 }
 
 void Rigidbody::SetRotation(float new_rotation) {
+  if (not body) {
+    rotation = new_rotation;
+    leave_static_geometry();
+    return;
+  }
+  snapshot.angle = to_radian(new_rotation);
+  if (defer([this, new_rotation] { SetRotation(new_rotation); }))
+    return;
   body->SetTransform(body->GetPosition(), to_radian(new_rotation));
 }
 
 b2Vec2 Rigidbody::GetPosition() const {
   if (not body)
     return {x, y};
+  if (reads_snapshot())
+    return snapshot.position;
   return body->GetPosition();
 }
 
 float Rigidbody::GetRotation() const {
+  if (not body)
+    return rotation;
+  if (reads_snapshot())
+    return to_degree(snapshot.angle);
   return to_degree(body->GetAngle());
 }
 
 void Rigidbody::AddForce(const b2Vec2& force) {
+  if (not body)
+    return;
+  if (defer([this, force] { AddForce(force); }))
+    return;
   body->ApplyForceToCenter(force, true);
 }
 
 void Rigidbody::SetVelocity(const b2Vec2& velocity) {
+  if (not body)
+    return;
+  snapshot.velocity = velocity;
+  if (defer([this, velocity] { SetVelocity(velocity); }))
+    return;
   body->SetLinearVelocity(velocity);
 }
 
 void Rigidbody::SetAngularVelocity(float degrees_clockwise) {
+  if (not body)
+    return;
+  snapshot.angular_velocity = to_radian(degrees_clockwise);
+  if (defer([this, degrees_clockwise] {
+        SetAngularVelocity(degrees_clockwise);
+      }))
+    return;
   body->SetAngularVelocity(to_radian(degrees_clockwise));
 }
 
 void Rigidbody::SetGravityScale(float scale) {
+  if (not body) {
+    gravity_scale = scale;
+    return;
+  }
+  snapshot.gravity_scale = scale;
+  if (defer([this, scale] { SetGravityScale(scale); }))
+    return;
   body->SetGravityScale(scale);
 }
 
 void Rigidbody::SetUpDirection(const b2Vec2& direction) {
+  if (not body)
+    return;
+  if (defer([this, direction] { SetUpDirection(direction); }))
+    return;
   b2Vec2 normalised_direction = direction;
   normalised_direction.Normalize();
   body->SetTransform(body->GetPosition(), glm::atan(normalised_direction.x,
@@ -170,6 +235,10 @@ void Rigidbody::SetUpDirection(const b2Vec2& direction) {
 }
 
 void Rigidbody::SetRightDirection(const b2Vec2& direction) {
+  if (not body)
+    return;
+  if (defer([this, direction] { SetRightDirection(direction); }))
+    return;
   b2Vec2 normalised_direction = direction;
   normalised_direction.Normalize();
   body->SetTransform(body->GetPosition(), glm::atan(normalised_direction.x,
@@ -178,26 +247,38 @@ void Rigidbody::SetRightDirection(const b2Vec2& direction) {
 }
 
 b2Vec2 Rigidbody::GetVelocity() const {
+  if (not body)
+    return {0.0f, 0.0f};
+  if (reads_snapshot())
+    return snapshot.velocity;
   return body->GetLinearVelocity();
 }
 
 float Rigidbody::GetAngularVelocity() const {
+  if (not body)
+    return 0.0f;
+  if (reads_snapshot())
+    return to_degree(snapshot.angular_velocity);
   return to_degree(body->GetAngularVelocity());
 }
 
 float Rigidbody::GetGravityScale() const {
+  if (not body)
+    return gravity_scale;
+  if (reads_snapshot())
+    return snapshot.gravity_scale;
   return body->GetGravityScale();
 }
 
 b2Vec2 Rigidbody::GetUpDirection() const {
-  float angle = body->GetAngle();
+  float angle = to_radian(GetRotation());
   b2Vec2 upDirection(glm::sin(angle), -glm::cos(angle));
   upDirection.Normalize();
   return upDirection;
 }
 
 b2Vec2 Rigidbody::GetRightDirection() const {
-  float angle = body->GetAngle();
+  float angle = to_radian(GetRotation());
   b2Vec2 rightDirection(glm::cos(angle), glm::sin(angle));
   rightDirection.Normalize();
   return rightDirection;
@@ -211,7 +292,85 @@ float Rigidbody::to_radian(float degree) {
   return degree * (b2_pi / 180.0f);
 }
 void Rigidbody::Destroy() {
+  StaticGeometry::getInstance().remove(this);
   if (body) {
+    PhysicsPipeline::getInstance().wait();
     body->GetWorld()->DestroyBody(body);
+    body = nullptr;
   }
 }
+
+b2Filter Rigidbody::get_collider_filter() const {
+  const auto& config = PhysicsConfig::getInstance();
+  b2Filter filter;
+  filter.categoryBits = config.get_layer_bit(layer);
+  filter.maskBits = collides_with.empty()
+                        ? config.get_layer_mask(layer)
+                        : config.parse_layer_list(collides_with);
+  return filter;
+}
+
+void Rigidbody::capture_snapshot() {
+  if (not body)
+    return;
+  snapshot.position = body->GetPosition();
+  snapshot.angle = body->GetAngle();
+  snapshot.velocity = body->GetLinearVelocity();
+  snapshot.angular_velocity = body->GetAngularVelocity();
+  snapshot.gravity_scale = body->GetGravityScale();
+  snapshot.awake = body->IsAwake();
+}
+
+bool Rigidbody::IsBullet() const {
+  return body and body->IsBullet();
+}
+
+bool Rigidbody::IsAwake() const {
+  if (not body)
+    return false;
+  if (reads_snapshot())
+    return snapshot.awake;
+  return body->IsAwake();
+}
+
+void Rigidbody::SetAwake(bool awake) {
+  if (not body)
+    return;
+  snapshot.awake = awake;
+  if (defer([this, awake] { SetAwake(awake); }))
+    return;
+  body->SetAwake(awake);
+}
+
+bool Rigidbody::update_ccd(float time_step) {
+  if (not body or body->GetType() != b2_dynamicBody)
+    return false;
+
+  // Box2D already sweeps every dynamic body against static geometry, bullet
+  // mode only adds dynamic vs dynamic sweeps. Those only matter once a body
+  // covers more than its own half extent in a single step.
+  bool bullet = precise;
+  if (precise and auto_ccd and has_collider) {
+    const float travel = body->GetLinearVelocity().Length() * time_step;
+    bullet = travel > min_extent;
+  }
+  if (body->IsBullet() != bullet)
+    body->SetBullet(bullet);
+  return bullet;
+}
+
+void Rigidbody::leave_static_geometry() {
+  if (not StaticGeometry::getInstance().remove(this))
+    return;
+  // re-merging would rebake the region on every move, so it stays a body
+  mergeable = false;
+  Initialize();
+}
+
+bool Rigidbody::defer(std::function<void()> command) {
+  return PhysicsPipeline::getInstance().defer(std::move(command));
+}
+
+bool Rigidbody::reads_snapshot() const {
+  return PhysicsPipeline::getInstance().is_pipelined();
+}
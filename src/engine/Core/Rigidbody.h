@@ -6,6 +6,7 @@
 #define PULSAR_SRC_ENGINE_CORE_RIGIDBODY_H_
 
 #include <box2d/box2d.h>
+#include <functional>
 #include <string>
 
 #include "Actor.h"
@@ -39,6 +40,16 @@ class Rigidbody {
   [[nodiscard]] b2Vec2 GetUpDirection() const;
   [[nodiscard]] b2Vec2 GetRightDirection() const;
 
+  [[nodiscard]] bool IsBullet() const;
+  [[nodiscard]] bool IsAwake() const;
+  void SetAwake(bool awake);
+  [[nodiscard]] bool has_body() const { return body != nullptr; }
+
+  // Pipelined physics: scripts read this copy while the world steps.
+  void capture_snapshot();
+  // Picks bullet mode for the coming step, returns whether it is a bullet.
+  bool update_ccd(float time_step);
+
   [[nodiscard]] static float to_radian(float degree);
   [[nodiscard]] static float to_degree(float radian);
 
@@ -46,6 +57,10 @@ class Rigidbody {
   float y;
   std::string body_type;
   bool precise;
+  // precise bodies only become bullets while they move fast for their size
+  bool auto_ccd;
+  // let Box2D put the body to sleep once it comes to rest
+  bool allow_sleep;
   float gravity_scale;
   float density;
   float angular_friction;
@@ -61,6 +76,11 @@ class Rigidbody {
   float friction = 0.3f;
   float bounciness = 0.3f;
 
+  // Collision layer (see PhysicsConfig), collides_with overrides the
+  // layer's row of the collision matrix, e.g. "player, enemy".
+  std::string layer = "default";
+  std::string collides_with;
+
   // Trigger defaults
   std::string trigger_type = "box";
   float trigger_width = 1.0f;
@@ -71,10 +91,16 @@ class Rigidbody {
   std::string key;
   Actor* actor;  // TODO: make private ?
   bool enabled;
+  // set by RigidbodyPool once the actor or component is gone
+  bool released = false;
+  // Category bits reserved for collider and trigger layers, phantoms get none.
   static const uint16 CATEGORY_COLLIDER;
   static const uint16 CATEGORY_TRIGGER;
   static const uint16 CATEGORY_PHANTOM;
 
+  // Box2D filter for this body's collider, triggers use it shifted up a byte
+  [[nodiscard]] b2Filter get_collider_filter() const;
+
   friend std::ostream& operator<<(std::ostream& os,
                                   const Rigidbody& rigidBody) {
     os << "Rigidbody: " << rigidBody.key << " at (" << rigidBody.x << ", "
@@ -83,7 +109,33 @@ class Rigidbody {
   }
 
  private:
+  struct BodySnapshot {
+    b2Vec2 position{0.0f, 0.0f};
+    float angle = 0.0f;
+    b2Vec2 velocity{0.0f, 0.0f};
+    float angular_velocity = 0.0f;
+    float gravity_scale = 1.0f;
+    bool awake = true;
+  };
+
+  // true when a pipelined step owns the body, writes get replayed at sync
+  bool defer(std::function<void()> command);
+  [[nodiscard]] bool reads_snapshot() const;
+  // a merged tile has no body to move, it gets one of its own instead
+  void leave_static_geometry();
+
+  friend class TriggerBroadphase;
+
   b2Body* body;
+  BodySnapshot snapshot;
+  // cached by CreateTrigger so the broadphase doesn't parse layers per frame
+  uint16 trigger_category = 0;
+  uint16 trigger_mask = 0;
+  bool trigger_is_circle = false;
+  // smallest half extent of the collider, see update_ccd
+  float min_extent = 0.5f;
+  // cleared once the body has left StaticGeometry, it stays out
+  bool mergeable = true;
 };
 
 
@@ -0,0 +1,98 @@
+#include "RigidbodyPool.h"
+
+#include <algorithm>
+
+Rigidbody* RigidbodyPool::acquire() {
+  if (free_slots.empty())
+    reclaim();
+  if (free_slots.empty()) {
+    chunks.push_back(std::make_unique<chunk>());
+    auto& new_chunk = *chunks.back();
+    free_slots.reserve(free_slots.size() + CHUNK_SIZE);
+    // hand out low addresses first
+    for (auto it = new_chunk.rbegin(); it != new_chunk.rend(); ++it)
+      free_slots.push_back(&*it);
+  }
+
+  Rigidbody* rigidbody = free_slots.back();
+  free_slots.pop_back();
+  *rigidbody = Rigidbody();
+  live.insert(rigidbody);
+  return rigidbody;
+}
+
+void RigidbodyPool::release(Rigidbody* rigidbody) {
+  if (pinned.count(rigidbody) > 0 or live.erase(rigidbody) == 0)
+    return;
+  rigidbody->Destroy();
+  rigidbody->enabled = false;
+  rigidbody->actor = nullptr;
+  rigidbody->released = true;
+  released_this_frame.push_back(rigidbody);
+}
+
+void RigidbodyPool::release_actor_components(const Actor& actor) {
+  for (const auto& [key, component] : actor.entity_components) {
+    // overridden template components are plain tables inheriting from the
+    // template's Rigidbody, only direct instances are the actor's own.
+    if (component.isInstance<Rigidbody>())
+      release(component.cast<Rigidbody*>());
+  }
+}
+
+void RigidbodyPool::pin_template_components(const Actor& template_actor) {
+  for (const auto& [key, component] : template_actor.entity_components) {
+    if (component.isInstance<Rigidbody>())
+      pinned.insert(component.cast<Rigidbody*>());
+  }
+}
+
+void RigidbodyPool::release_all() {
+  for (Rigidbody* rigidbody : live) {
+    rigidbody->Destroy();
+    rigidbody->enabled = false;
+    rigidbody->actor = nullptr;
+    rigidbody->released = true;
+    released_this_frame.push_back(rigidbody);
+  }
+  live.clear();
+  pinned.clear();
+}
+
+void RigidbodyPool::recycle() {
+  retired.insert(retired.end(), released_this_frame.begin(),
+                 released_this_frame.end());
+  released_this_frame.clear();
+}
+
+void RigidbodyPool::reset() {
+  free_slots.insert(free_slots.end(), retired.begin(), retired.end());
+  free_slots.insert(free_slots.end(), released_this_frame.begin(),
+                    released_this_frame.end());
+  retired.clear();
+  released_this_frame.clear();
+  tracked.forget();
+}
+
+void RigidbodyPool::track(Rigidbody* rigidbody,
+                          const luabridge::LuaRef& component) {
+  tracked.track(rigidbody, component);
+}
+
+// Only runs when acquire is out of free slots, the incremental GC gets
+// there in its own time and a fresh chunk covers the meantime.
+void RigidbodyPool::reclaim() {
+  auto reclaimed = [this](Rigidbody* rigidbody) {
+    if (tracked.referenced(rigidbody))
+      return false;
+    free_slots.push_back(rigidbody);
+    return true;
+  };
+  retired.erase(std::remove_if(retired.begin(), retired.end(), reclaimed),
+                retired.end());
+}
+
+void RigidbodyPool::capture_snapshots() {
+  for (Rigidbody* rigidbody : live)
+    rigidbody->capture_snapshot();
+}
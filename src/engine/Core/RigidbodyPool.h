@@ -0,0 +1,80 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_RIGIDBODYPOOL_H_
+#define PULSAR_SRC_ENGINE_CORE_RIGIDBODYPOOL_H_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "ComponentTracker.h"
+#include "Rigidbody.h"
+
+// Owns every Rigidbody component. Lua only ever sees raw pointers into the
+// chunks, so storage never moves. A released slot is only handed out again
+// once Lua has collected the component userdata made for it, so a script
+// still holding a destroyed actor's Rigidbody can't end up moving someone
+// else's body. Until then using it is an error, see ECS::reg_rigidbody.
+class RigidbodyPool {
+  RigidbodyPool() = default;
+
+ public:
+  RigidbodyPool(const RigidbodyPool&) = delete;
+  RigidbodyPool& operator=(const RigidbodyPool&) = delete;
+  RigidbodyPool(RigidbodyPool&&) = delete;
+  RigidbodyPool& operator=(RigidbodyPool&&) = delete;
+
+  static RigidbodyPool& getInstance() {
+    static RigidbodyPool instance;
+    return instance;
+  }
+
+  Rigidbody* acquire();
+  // Remembers the component ECS made for the slot, weakly.
+  void track(Rigidbody* rigidbody, const luabridge::LuaRef& component);
+  // Destroys the body (if any) and returns the slot. Unknown or already
+  // released pointers are ignored.
+  void release(Rigidbody* rigidbody);
+  // Releases every Rigidbody component owned by the actor.
+  void release_actor_components(const Actor& actor);
+  // Scene actors built from a cached template share the template's
+  // components, those stay alive until release_all.
+  void pin_template_components(const Actor& template_actor);
+  void release_all();
+  // Retires slots released this frame, once their queued writes are gone.
+  void recycle();
+  // Before the Lua state closes, after release_all: nothing can reference a
+  // released slot anymore, so they all go straight back to free_slots and
+  // the state is forgotten until the next track.
+  void reset();
+  void capture_snapshots();
+
+  template <typename Fn>
+  void for_each_live(Fn&& fn) const {
+    for (Rigidbody* rigidbody : live)
+      fn(rigidbody);
+  }
+
+  [[nodiscard]] size_t get_live_count() const { return live.size(); }
+  [[nodiscard]] size_t get_retired_count() const { return retired.size(); }
+  [[nodiscard]] size_t get_capacity() const {
+    return chunks.size() * CHUNK_SIZE;
+  }
+
+ private:
+  static constexpr size_t CHUNK_SIZE = 128;
+  using chunk = std::array<Rigidbody, CHUNK_SIZE>;
+
+  // moves retired slots Lua no longer references to free_slots
+  void reclaim();
+
+  std::vector<std::unique_ptr<chunk>> chunks;
+  std::vector<Rigidbody*> free_slots;
+  std::vector<Rigidbody*> released_this_frame;
+  std::vector<Rigidbody*> retired;
+  ComponentTracker tracked;
+  std::unordered_set<Rigidbody*> live;
+  std::unordered_set<Rigidbody*> pinned;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_RIGIDBODYPOOL_H_
@@ -12,7 +12,14 @@
 #include "ActorTemplate.h"
 #include "ECS.h"
 #include "EngineUtils.h"
+#include "PhysicsDebugDraw.h"
+#include "PhysicsPipeline.h"
 #include "Resources.hpp"
+#include "RigidbodyPool.h"
+#include "TriggerBroadphase.h"
+#include "StaticGeometry.h"
+#include "TextureAtlas.h"
+#include "TextureLoader.h"
 
 std::optional<std::string> SceneManager::latest_scene_change_request =
     std::nullopt;
@@ -42,11 +49,16 @@ void SceneManager::initialize(const rapidjson::Document& game_config) {
 
   rapidjson::Document initial_scene_data;
   EngineUtils::ReadJsonFile(scene_file, initial_scene_data);
+  start_scene_preload(initial_scene_data);
+  finish_scene_preload();
+  load_scene_physics(initial_scene_data);
   load_scene_actors(initial_scene_data);
   current_scene_name = initial_scene;
 }
 
 void SceneManager::reset() {
+  PhysicsPipeline::getInstance().clear();
+  Renderer::invalidate_layers();
   scene_actors.clear();
   copy_of_scene_actors.clear();
   actors_by_name.clear();
@@ -59,14 +71,24 @@ void SceneManager::reset() {
   jit_instantiated_actors.clear();
   victim_actors_this_frame.clear();
   
+  // bodies have to go before the world that owns them
+  RigidbodyPool::getInstance().release_all();
+  RigidbodyPool::getInstance().reset();
+  TriggerBroadphase::getInstance().reset();
+  StaticGeometry::getInstance().reset();
+  spatial_hash.clear();
   if (phys_world_initialized) {
     delete phys_world;
+    delete phys_contact_listener;
+    phys_world = nullptr;
+    phys_contact_listener = nullptr;
     phys_world_initialized = false;
   }
 
   if (not actor_templates_map.empty()) {
     actor_templates_map.clear();
   }
+  ActorTemplate::clear_template_data();
 
   App::ECS::getInstance().reset();
 
@@ -77,10 +99,15 @@ void SceneManager::trigger_scene_change(const std::string& scene_name) {
   const std::string scene_path = "resources/scenes/" + scene_name + ".scene";
   if (not std::filesystem::exists(scene_path)) {
     std::cout << "error: scene " << scene_name << " is missing";
-    std::exit(0);
+    GameThread::quit(0);
   }
   rapidjson::Document new_scene_data;
   EngineUtils::ReadJsonFile(scene_path, new_scene_data);
+  start_scene_preload(new_scene_data);
+  Renderer::invalidate_layers();
+
+  // flush the in-flight step before tearing the scene down
+  SyncPhysWorld();
 
   for (const auto& actor : scene_actors) {
     if (ids_of_scene_persisting_actors.count(actor._id) <= 0 and
@@ -98,8 +125,19 @@ void SceneManager::trigger_scene_change(const std::string& scene_name) {
     }
   }
 
+  auto& rigidbody_pool = RigidbodyPool::getInstance();
+  auto& trigger_broadphase = TriggerBroadphase::getInstance();
+  for (const auto& actor : copy_of_scene_actors) {
+    if (ids_of_scene_persisting_actors.count(actor->_id) <= 0) {
+      rigidbody_pool.release_actor_components(*actor);
+      trigger_broadphase.release_actor_components(*actor);
+    }
+  }
+
   scene_actors.clear();
   copy_of_scene_actors.clear();
+  // persisting actors move, scripts and rigidbodies re-report them
+  spatial_hash.clear();
   // safety ?
   actors_by_name.clear();
   actor_booted_component_keys.clear();
@@ -121,10 +159,89 @@ void SceneManager::trigger_scene_change(const std::string& scene_name) {
     }
     //		source_of_scene_persisting_actors.clear();
   }
+  finish_scene_preload();
+  load_scene_physics(new_scene_data);
   load_scene_actors(new_scene_data);
   current_scene_name = scene_name;
 }
 
+namespace {
+// A component type's own declarations, same shape as a scene's "preload":
+//   MyComponent = { preload = { images = { "boss" }, audio = { "roar" } } }
+void declare_component_assets(const std::string& type,
+                              SceneManifest& manifest) {
+  const luabridge::LuaRef* component_type =
+      App::ECS::getInstance().find_component_type(type);
+  if (component_type == nullptr)
+    return;
+  const luabridge::LuaRef declared = (*component_type)["preload"];
+  if (not declared.isTable())
+    return;
+  const std::pair<const char*, SceneManifest::Kind> lists[] = {
+      {"images", SceneManifest::Kind::IMAGE},
+      {"audio", SceneManifest::Kind::AUDIO},
+      {"fonts", SceneManifest::Kind::FONT},
+      {"templates", SceneManifest::Kind::TEMPLATE}};
+  for (const auto& [key, kind] : lists) {
+    const luabridge::LuaRef names = declared[key];
+    if (not names.isTable())
+      continue;
+    for (luabridge::Iterator it(names); not it.isNil(); ++it) {
+      if (it.value().isString())
+        manifest.add(kind, it.value().cast<std::string>());
+    }
+  }
+}
+}  // namespace
+
+void SceneManager::start_scene_preload(const rapidjson::Document& scene_data) {
+  Renderer& renderer = Renderer::getInstance();
+  const std::filesystem::path game_path = App::Resources::game_path();
+  // the same string shows up on lots of actors, only look it up once
+  std::unordered_map<std::string, SceneManifest::Kind> kinds;
+  SceneManifest::Sources sources;
+  sources.classify = [&kinds, &game_path](const std::string& value) {
+    if (value.empty())
+      return SceneManifest::Kind::NONE;
+    if (const auto it = kinds.find(value); it != kinds.end())
+      return it->second;
+    SceneManifest::Kind kind = SceneManifest::Kind::NONE;
+    if (TextureAtlas::getInstance().find(value) != nullptr or
+        std::filesystem::exists(game_path / "images" / (value + ".png")))
+      kind = SceneManifest::Kind::IMAGE;
+    else if (not AudioManager::get_clip_path(value).empty())
+      kind = SceneManifest::Kind::AUDIO;
+    else if (std::filesystem::exists(game_path / "fonts" / (value + ".ttf")))
+      kind = SceneManifest::Kind::FONT;
+    else if (std::filesystem::exists(game_path / "actor_templates" /
+                                     (value + ".template")))
+      kind = SceneManifest::Kind::TEMPLATE;
+    kinds.emplace(value, kind);
+    return kind;
+  };
+  sources.find_template = [](const std::string& template_name) {
+    return static_cast<const rapidjson::Value*>(
+        ActorTemplate::find_template_data(template_name));
+  };
+  sources.declare_component = &declare_component_assets;
+
+  // templates get parsed (and cached) on the way
+  const SceneManifest manifest = SceneManifest::build(scene_data, sources);
+
+  for (const auto& image_name : manifest.images)
+    Renderer::preload_texture(image_name);
+  renderer.set_scene_textures(manifest.images);
+  for (const auto& font_name : manifest.fonts)
+    renderer.preload_font(font_name);
+  // decodes alongside the images
+  AudioManager::preload_clips(manifest.audio);
+}
+
+void SceneManager::finish_scene_preload() {
+  TextureLoader::getInstance().wait_idle();
+  Renderer::getInstance().upload_all_textures_next_frame();
+}
+
 void SceneManager::load_scene_actors(const rapidjson::Document& scene_data) {
   if (not scene_data.HasMember("actors") or
       not scene_data["actors"].IsArray()) {
@@ -144,6 +261,8 @@ void SceneManager::load_scene_actors(const rapidjson::Document& scene_data) {
       } else {
         actor = ActorTemplate::load_actor_template(template_name);
         actor_templates_map.emplace(template_name, actor);
+        RigidbodyPool::getInstance().pin_template_components(actor);
+        TriggerBroadphase::getInstance().pin_template_components(actor);
       }
     } else {
       actor.set_id();
@@ -168,6 +287,21 @@ void SceneManager::load_scene_actors(const rapidjson::Document& scene_data) {
   }
 }
 
+void SceneManager::load_scene_physics(const rapidjson::Document& scene_data) {
+  world_settings = PhysicsConfig::getInstance().world;
+  if (scene_data.HasMember("physics") and scene_data["physics"].IsObject())
+    world_settings.load(scene_data["physics"]);
+  velocity_iterations = world_settings.velocity_iterations;
+  position_iterations = world_settings.position_iterations;
+
+  // the world outlives scene changes
+  if (phys_world_initialized) {
+    b2World* world = GetPhysWorld();
+    world->SetGravity(world_settings.gravity);
+    world->SetAllowSleeping(world_settings.allow_sleep);
+  }
+}
+
 void SceneManager::update_scene_actors() {
   for (const auto& actor : copy_of_scene_actors) {
     if (not actor->entity_JIT_added_components.empty()) {
@@ -206,6 +340,8 @@ void SceneManager::update_scene_actors() {
       }
     }
   }
+  // bake tile colliders that just started so OnUpdate queries see them
+  StaticGeometry::getInstance().flush();
 
   for (const auto& actor : copy_of_scene_actors) {
     const bool has_JIT_added_components =
@@ -270,6 +406,11 @@ void SceneManager::update_scene_actors() {
     } catch (const luabridge::LuaException& e) {
       Renderer::log_error(actor->name, e);
     }
+    if (component.isInstance<Rigidbody>())
+      RigidbodyPool::getInstance().release(component.cast<Rigidbody*>());
+    else if (component.isInstance<TriggerVolume>())
+      TriggerBroadphase::getInstance().release(
+          component.cast<TriggerVolume*>());
     actor->entity_components.erase(key);
   }
 
@@ -292,6 +433,12 @@ void SceneManager::update_scene_actors() {
             Renderer::log_error((*actor_found_at)->name, e);
           }
         }
+        RigidbodyPool::getInstance().release_actor_components(
+            **actor_found_at);
+        TriggerBroadphase::getInstance().release_actor_components(
+            **actor_found_at);
+        PhysicsPipeline::getInstance().forget_actor(*actor_found_at);
+        spatial_hash.remove((*actor_found_at)->_id);
         copy_of_scene_actors.erase(actor_found_at);
         if (jit_created_actors_map.count(victim_pair.first) > 0 and
             victim_pair.second)
@@ -335,6 +482,49 @@ luabridge::LuaRef SceneManager::GetActors(const std::string& name) {
   }
   return actors_table;
 }
+luabridge::LuaRef SceneManager::LuaFindInRadius(const b2Vec2& center,
+                                                float radius) {
+  const auto L = App::ECS::getInstance().get_lua_state();
+  std::vector<Actor*> found;
+  getInstance().spatial_hash.query_radius(center.x, center.y, radius, found);
+  luabridge::LuaRef actors_table = luabridge::newTable(L);
+  int i = 1;
+  for (Actor* actor : found)
+    actors_table[i++] = actor;
+  return actors_table;
+}
+luabridge::LuaRef SceneManager::LuaFindInRect(const b2Vec2& min,
+                                              const b2Vec2& max) {
+  const auto L = App::ECS::getInstance().get_lua_state();
+  std::vector<Actor*> found;
+  getInstance().spatial_hash.query_rect(min.x, min.y, max.x, max.y, found);
+  luabridge::LuaRef actors_table = luabridge::newTable(L);
+  int i = 1;
+  for (Actor* actor : found)
+    actors_table[i++] = actor;
+  return actors_table;
+}
+void SceneManager::LuaSpatialUpdate(const Actor* actor, float x, float y) {
+  if (not actor)
+    return;
+  auto& scm = getInstance();
+  if (Actor* live = scm.find_live_actor(actor->_id))
+    scm.spatial_hash.update(live->_id, live, x, y);
+}
+Actor* SceneManager::find_live_actor(size_t id) const {
+  const auto has_id = [id](const Actor* actor) { return actor->_id == id; };
+  // instantiated this frame, not in copy_of_scene_actors until the frame ends
+  for (const auto* actors : {&copy_of_scene_actors, &jit_instantiated_actors}) {
+    const auto actor_itr = std::find_if(actors->begin(), actors->end(), has_id);
+    if (actor_itr != actors->end())
+      return *actor_itr;
+  }
+  return nullptr;
+}
+void SceneManager::LuaSpatialRemove(const Actor* actor) {
+  if (actor)
+    getInstance().spatial_hash.remove(actor->_id);
+}
 void SceneManager::LuaLoadNewScene(const std::string& name) {
   latest_scene_change_request = name;
 }
@@ -367,23 +557,192 @@ b2World* SceneManager::GetPhysWorld() const {
     std::cerr << "[FATAL] phys world NOT initialized but accessed.\n";
     std::exit(0);
   }
+  // callers touch the world directly, so any pipelined step has to finish
+  PhysicsPipeline::getInstance().wait();
   return phys_world;
 }
 
 void SceneManager::CreatePhysWorld() {
   if (not phys_world_initialized) {
-    phys_world = new b2World(b2Vec2(0.0f, 9.8f));
-    auto* contact_listener = new ContactListener();
-    phys_world->SetContactListener(contact_listener);
+    phys_world = new b2World(world_settings.gravity);
+    phys_world->SetAllowSleeping(world_settings.allow_sleep);
+    phys_world->SetDebugDraw(&PhysicsDebugDraw::getInstance());
+    phys_contact_listener = new ContactListener();
+    phys_world->SetContactListener(phys_contact_listener);
     phys_world_initialized = true;
   }
 }
 
-void SceneManager::StepPhysWorld() const {
+void SceneManager::StepPhysWorld() {
   //  if (not phys_world_initialized) {
   //	std::cerr << "[FATAL] phys world NOT initialized but updated.\n";
   //	std::exit(0);
   //  }
-  if (phys_world_initialized)
-    phys_world->Step(1.0f / 60.0f, 8, 3);
+  if (not phys_world_initialized)
+    return;
+
+  constexpr float time_step = 1.0f / 60.0f;
+  bullet_body_count = 0;
+  RigidbodyPool::getInstance().for_each_live([this](Rigidbody* rigidbody) {
+    if (rigidbody->update_ccd(time_step))
+      bullet_body_count++;
+  });
+
+  if (world_settings.adaptive_iterations)
+    adapt_solver_iterations();
+
+  if (auto& pipeline = PhysicsPipeline::getInstance(); pipeline.is_pipelined())
+    pipeline.kick(phys_world, time_step, velocity_iterations,
+                  position_iterations);
+  else
+    pipeline.run_step(phys_world, time_step, velocity_iterations,
+                      position_iterations);
+}
+
+// One iteration at a time, based on how long the last step took. Below half
+// the budget counts as room, the gap in between keeps it from flip-flopping.
+void SceneManager::adapt_solver_iterations() {
+  const float step_ms = PhysicsPipeline::getInstance().get_last_step_ms();
+  if (step_ms > world_settings.step_budget_ms) {
+    velocity_iterations = std::max(world_settings.min_velocity_iterations,
+                                   velocity_iterations - 1);
+    position_iterations = std::max(world_settings.min_position_iterations,
+                                   position_iterations - 1);
+  } else if (step_ms < world_settings.step_budget_ms * 0.5f) {
+    velocity_iterations =
+        std::min(world_settings.velocity_iterations, velocity_iterations + 1);
+    position_iterations =
+        std::min(world_settings.position_iterations, position_iterations + 1);
+  }
+}
+
+void SceneManager::SyncPhysWorld() {
+  PhysicsPipeline::getInstance().sync();
+  StaticGeometry::getInstance().flush();
+  RigidbodyPool::getInstance().for_each_live([this](Rigidbody* rigidbody) {
+    if (rigidbody->actor and rigidbody->enabled) {
+      const b2Vec2 pos = rigidbody->GetPosition();
+      spatial_hash.update(rigidbody->actor->_id, rigidbody->actor, pos.x,
+                          pos.y);
+    }
+  });
+  // only now are queued writes to released Rigidbodies gone
+  RigidbodyPool::getInstance().recycle();
+}
+
+void SceneManager::RenderPhysicsDebug() const {
+  auto& debug_draw = PhysicsDebugDraw::getInstance();
+  if (not debug_draw.is_enabled())
+    return;
+  debug_draw.render(phys_world_initialized ? GetPhysWorld() : nullptr,
+                    Renderer::getInstance().get_sdl_renderer());
+}
+
+void SceneManager::CollectPhysicsDebug() const {
+  auto& debug_draw = PhysicsDebugDraw::getInstance();
+  // still called when off, so last frame's shapes don't linger
+  if (not debug_draw.is_enabled())
+    return debug_draw.collect(nullptr);
+  debug_draw.collect(phys_world_initialized ? GetPhysWorld() : nullptr);
+}
+
+void SceneManager::UpdateTriggerVolumes() {
+  TriggerBroadphase::getInstance().update();
+  TriggerBroadphase::getInstance().recycle();
+}
+
+// Same islands b2World::Solve would build: awake bodies joined by touching
+// contacts and joints, static bodies don't link islands together.
+static int count_awake_islands(b2World* world, int& awake_bodies) {
+  std::unordered_set<b2Body*> visited;
+  std::vector<b2Body*> stack;
+  int islands = 0;
+  for (b2Body* seed = world->GetBodyList(); seed; seed = seed->GetNext()) {
+    if (seed->GetType() == b2_staticBody or not seed->IsAwake() or
+        not seed->IsEnabled() or visited.count(seed) > 0)
+      continue;
+    islands++;
+    stack.push_back(seed);
+    visited.insert(seed);
+    while (not stack.empty()) {
+      b2Body* body = stack.back();
+      stack.pop_back();
+      awake_bodies++;
+      if (body->GetType() == b2_staticBody)
+        continue;
+      for (b2ContactEdge* edge = body->GetContactList(); edge;
+           edge = edge->next) {
+        b2Contact* contact = edge->contact;
+        if (not contact->IsEnabled() or not contact->IsTouching() or
+            contact->GetFixtureA()->IsSensor() or
+            contact->GetFixtureB()->IsSensor())
+          continue;
+        if (edge->other->GetType() != b2_staticBody and
+            visited.insert(edge->other).second)
+          stack.push_back(edge->other);
+      }
+      for (b2JointEdge* edge = body->GetJointList(); edge; edge = edge->next) {
+        if (edge->other->IsEnabled() and
+            edge->other->GetType() != b2_staticBody and
+            visited.insert(edge->other).second)
+          stack.push_back(edge->other);
+      }
+    }
+  }
+  return islands;
+}
+
+luabridge::LuaRef SceneManager::LuaGetPhysicsStats() {
+  const auto L = App::ECS::getInstance().get_lua_state();
+  const auto& scm = SceneManager::getInstance();
+  const auto& rigidbody_pool = RigidbodyPool::getInstance();
+
+  int bodies = 0;
+  int fixtures = 0;
+  int proxies = 0;
+  int contacts = 0;
+  int awake_bodies = 0;
+  int islands = 0;
+  if (scm.phys_world_initialized) {
+    PhysicsPipeline::getInstance().wait();
+    bodies = scm.phys_world->GetBodyCount();
+    proxies = scm.phys_world->GetProxyCount();
+    contacts = scm.phys_world->GetContactCount();
+    islands = count_awake_islands(scm.phys_world, awake_bodies);
+    for (const b2Body* body = scm.phys_world->GetBodyList(); body;
+         body = body->GetNext()) {
+      for (const b2Fixture* fixture = body->GetFixtureList(); fixture;
+           fixture = fixture->GetNext())
+        fixtures++;
+    }
+  }
+
+  luabridge::LuaRef stats = luabridge::newTable(L);
+  stats["bodies"] = bodies;
+  stats["fixtures"] = fixtures;
+  stats["proxies"] = proxies;
+  stats["contacts"] = contacts;
+  stats["awake_bodies"] = awake_bodies;
+  stats["islands"] = islands;
+  stats["velocity_iterations"] = scm.velocity_iterations;
+  stats["position_iterations"] = scm.position_iterations;
+  stats["step_ms"] = PhysicsPipeline::getInstance().get_last_step_ms();
+  stats["rigidbodies"] = static_cast<int>(rigidbody_pool.get_live_count());
+  stats["rigidbody_capacity"] =
+      static_cast<int>(rigidbody_pool.get_capacity());
+  // released, waiting for Lua to let go of them
+  stats["rigidbodies_retired"] =
+      static_cast<int>(rigidbody_pool.get_retired_count());
+  stats["bullets"] = scm.bullet_body_count;
+  stats["toi_calls"] = PhysicsPipeline::getInstance().get_last_toi_calls();
+  stats["solve_toi_ms"] = PhysicsPipeline::getInstance().get_last_solve_toi_ms();
+  stats["trigger_volumes"] =
+      static_cast<int>(TriggerBroadphase::getInstance().get_volume_count());
+  stats["trigger_pairs"] =
+      static_cast<int>(TriggerBroadphase::getInstance().get_pair_count());
+  stats["static_regions"] =
+      static_cast<int>(StaticGeometry::getInstance().get_region_count());
+  stats["static_tiles"] =
+      static_cast<int>(StaticGeometry::getInstance().get_tile_count());
+  return stats;
 }
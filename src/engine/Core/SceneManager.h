@@ -20,13 +20,11 @@
 #include "ContactListener.h"
 #include "ECS.h"
 #include "EngineUtils.h"
+#include "PhysicsConfig.h"
 #include "Renderer.h"
+#include "SceneManifest.h"
+#include "SpatialHash.h"
 
-[[maybe_unused]] typedef std::
-    unordered_map<glm::ivec2, std::vector<Actor*>, EngineUtils::hash_pair>
-        spatial_grid;
-[[maybe_unused]] typedef std::unordered_set<std::pair<Actor*, Actor*>, ColliderCacheHash>
-    actor_interaction_cache;
 [[maybe_unused]] typedef std::vector<std::pair<std::string, size_t>> dialogues_ctr;
 
 class SceneManager {
@@ -58,12 +56,27 @@ class SceneManager {
   std::unordered_set<std::string> serviced_on_start_components;
 
   b2World* phys_world = nullptr;
-  [[maybe_unused]] ContactListener* phys_contact_listener = nullptr;
+  ContactListener* phys_contact_listener = nullptr;
   bool phys_world_initialized = false;
+  int bullet_body_count = 0;
+  // current scene's world settings, iterations are what the next step uses
+  WorldSettings world_settings;
+  int32 velocity_iterations = 8;
+  int32 position_iterations = 3;
 
   [[nodiscard]] b2World* GetPhysWorld() const;
+  [[nodiscard]] bool HasPhysWorld() const { return phys_world_initialized; }
   void CreatePhysWorld();
-  void StepPhysWorld() const;
+  void StepPhysWorld();
+  // Pipelined mode: wait for the step, replay queued Rigidbody writes and
+  // run the contact callbacks it produced.
+  void SyncPhysWorld();
+  // TriggerVolume enter / exit callbacks, after SyncPhysWorld
+  void UpdateTriggerVolumes();
+  // colliders, AABBs, joints and contacts over the scene, see PhysicsDebugDraw
+  void RenderPhysicsDebug() const;
+  // threaded game loop, see PhysicsDebugDraw::collect
+  void CollectPhysicsDebug() const;
 
   void reset();
 
@@ -71,7 +84,15 @@ class SceneManager {
 
   void trigger_scene_change(const std::string& scene_name);
 
+  // Loads everything the scene's manifest lists: images decode on the
+  // JobSystem while the old scene is torn down, finish_scene_preload waits
+  // for them so the first frame has them all.
+  void start_scene_preload(const rapidjson::Document& scene_data);
+  static void finish_scene_preload();
+
   void load_scene_actors(const rapidjson::Document& scene_data);
+  void load_scene_physics(const rapidjson::Document& scene_data);
+  void adapt_solver_iterations();
 
   void update_scene_actors();
   [[maybe_unused]] void update_scene_actors_helper(
@@ -114,6 +135,20 @@ class SceneManager {
   // Functions to expose to lua via the Actor namespace
   [[nodiscard]] static luabridge::LuaRef GetActor(const std::string& name);
   [[nodiscard]] static luabridge::LuaRef GetActors(const std::string& name);
+  [[nodiscard]] static luabridge::LuaRef LuaFindInRadius(const b2Vec2& center,
+                                                         float radius);
+  [[nodiscard]] static luabridge::LuaRef LuaFindInRect(const b2Vec2& min,
+                                                       const b2Vec2& max);
+
+  // Spatial namespace. Actors with a Rigidbody are tracked on their own,
+  // everything else has to report its position.
+  static void LuaSpatialUpdate(const Actor* actor, float x, float y);
+  static void LuaSpatialRemove(const Actor* actor);
+  // The scene's own pointer for an actor id, nullptr once it's destroyed.
+  // Lua can hold copies (Actor.Find pushes those), so never keep the address
+  // it handed in.
+  [[nodiscard]] Actor* find_live_actor(size_t id) const;
+  SpatialHash spatial_hash;
 
   std::string current_scene_name;
   static std::optional<std::string> latest_scene_change_request;
@@ -121,6 +156,8 @@ class SceneManager {
   static void LuaLoadNewScene(const std::string& name);
   [[nodiscard]] static std::string LuaGetCurrentScene();
   static void LuaPersistActor(const Actor*);
+  // bodies, fixtures, proxies, contacts and pooled Rigidbody counts
+  [[nodiscard]] static luabridge::LuaRef LuaGetPhysicsStats();
 
   actor_component_list late_update_components;
   actor_component_list on_destroy_components;
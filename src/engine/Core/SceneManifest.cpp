@@ -0,0 +1,100 @@
+#include "SceneManifest.h"
+
+SceneManifest SceneManifest::build(const rapidjson::Value& scene_data,
+                                   const Sources& sources) {
+  SceneManifest manifest;
+  if (not scene_data.IsObject())
+    return manifest;
+  if (scene_data.HasMember("preload"))
+    manifest.add_declared(scene_data["preload"]);
+  if (scene_data.HasMember("actors") and scene_data["actors"].IsArray()) {
+    for (const auto& actor_data : scene_data["actors"].GetArray())
+      manifest.collect_actor(actor_data, sources);
+  }
+  // declared templates get walked too, which can declare more
+  while (manifest.walked_templates.size() < manifest.templates.size()) {
+    const std::set<std::string> found = manifest.templates;
+    for (const auto& template_name : found)
+      manifest.collect_template(template_name, sources);
+  }
+  return manifest;
+}
+
+void SceneManifest::add(Kind kind, const std::string& name) {
+  switch (kind) {
+    case Kind::IMAGE:
+      images.insert(name);
+      return;
+    case Kind::AUDIO:
+      audio.insert(name);
+      return;
+    case Kind::FONT:
+      fonts.insert(name);
+      return;
+    case Kind::TEMPLATE:
+      templates.insert(name);
+      return;
+    default:
+      return;
+  }
+}
+
+void SceneManifest::add_declared(const rapidjson::Value& declared) {
+  if (not declared.IsObject())
+    return;
+  const std::pair<const char*, Kind> lists[] = {{"images", Kind::IMAGE},
+                                                {"audio", Kind::AUDIO},
+                                                {"fonts", Kind::FONT},
+                                                {"templates", Kind::TEMPLATE}};
+  for (const auto& [key, kind] : lists) {
+    if (not declared.HasMember(key) or not declared[key].IsArray())
+      continue;
+    for (const auto& name : declared[key].GetArray()) {
+      if (name.IsString())
+        add(kind, name.GetString());
+    }
+  }
+}
+
+void SceneManifest::collect_actor(const rapidjson::Value& actor_data,
+                                  const Sources& sources) {
+  if (not actor_data.IsObject())
+    return;
+  if (actor_data.HasMember("template") and actor_data["template"].IsString())
+    collect_template(actor_data["template"].GetString(), sources);
+  if (not actor_data.HasMember("components") or
+      not actor_data["components"].IsObject())
+    return;
+
+  for (const auto& component : actor_data["components"].GetObject()) {
+    if (not component.value.IsObject())
+      continue;
+    for (const auto& property : component.value.GetObject()) {
+      if (not property.value.IsString())
+        continue;
+      const std::string value = property.value.GetString();
+      if (std::string(property.name.GetString()) == "type") {
+        if (sources.declare_component and declared_types.insert(value).second)
+          sources.declare_component(value, *this);
+        continue;
+      }
+      const Kind kind = sources.classify ? sources.classify(value) : Kind::NONE;
+      if (kind == Kind::TEMPLATE)
+        collect_template(value, sources);
+      else
+        add(kind, value);
+    }
+  }
+}
+
+// Templates can name each other.
+void SceneManifest::collect_template(const std::string& template_name,
+                                     const Sources& sources) {
+  templates.insert(template_name);
+  if (not walked_templates.insert(template_name).second)
+    return;
+  const rapidjson::Value* template_data =
+      sources.find_template ? sources.find_template(template_name) : nullptr;
+  if (template_data != nullptr)
+    collect_actor(*template_data, sources);
+}
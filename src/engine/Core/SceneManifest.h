@@ -0,0 +1,52 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_SCENEMANIFEST_H_
+#define PULSAR_SRC_ENGINE_CORE_SCENEMANIFEST_H_
+
+#include <rapidjson/document.h>
+#include <cstddef>
+#include <functional>
+#include <set>
+#include <string>
+
+// Every image, audio clip, font and template a scene can reach: its actors,
+// the templates they (or their component properties) name, and whatever the
+// scene or a component type declares under "preload". Component properties
+// are plain strings, so sources.classify decides what each one names. Used
+// by SceneManager to load it all before the scene's first frame.
+struct SceneManifest {
+  enum class Kind { NONE, IMAGE, AUDIO, FONT, TEMPLATE };
+
+  struct Sources {
+    std::function<Kind(const std::string&)> classify;
+    // null when there's no such template
+    std::function<const rapidjson::Value*(const std::string&)> find_template;
+    // optional, lets a component type add its own declarations
+    std::function<void(const std::string&, SceneManifest&)> declare_component;
+  };
+
+  std::set<std::string> images;
+  std::set<std::string> audio;
+  std::set<std::string> fonts;
+  std::set<std::string> templates;
+
+  static SceneManifest build(const rapidjson::Value& scene_data,
+                             const Sources& sources);
+
+  void add(Kind kind, const std::string& name);
+  // {"images": [...], "audio": [...], "fonts": [...], "templates": [...]}
+  void add_declared(const rapidjson::Value& declared);
+
+  [[nodiscard]] size_t size() const {
+    return images.size() + audio.size() + fonts.size() + templates.size();
+  }
+
+ private:
+  void collect_actor(const rapidjson::Value& actor_data,
+                     const Sources& sources);
+  void collect_template(const std::string& template_name,
+                        const Sources& sources);
+
+  std::set<std::string> declared_types;
+  std::set<std::string> walked_templates;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_SCENEMANIFEST_H_
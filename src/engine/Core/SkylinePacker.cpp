@@ -0,0 +1,92 @@
+#include "SkylinePacker.h"
+
+#include <climits>
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : width(width), height(height) {
+  nodes.push_back({0, 0, width});
+}
+
+int SkylinePacker::fit(size_t index, int rect_width, int rect_height) const {
+  const int x = nodes[index].x;
+  if (x + rect_width > width)
+    return -1;
+  int y = nodes[index].y;
+  int width_left = rect_width;
+  for (size_t i = index; width_left > 0; i++) {
+    // x + rect_width <= width, so the nodes run out only once covered
+    if (nodes[i].y > y)
+      y = nodes[i].y;
+    if (y + rect_height > height)
+      return -1;
+    width_left -= nodes[i].width;
+  }
+  return y;
+}
+
+bool SkylinePacker::insert(int rect_width,
+                           int rect_height,
+                           int& out_x,
+                           int& out_y) {
+  if (rect_width <= 0 or rect_height <= 0)
+    return false;
+
+  int best_y = INT_MAX;
+  int best_width = INT_MAX;
+  size_t best_index = nodes.size();
+  for (size_t i = 0; i < nodes.size(); i++) {
+    const int y = fit(i, rect_width, rect_height);
+    if (y < 0)
+      continue;
+    if (y < best_y or (y == best_y and nodes[i].width < best_width)) {
+      best_y = y;
+      best_width = nodes[i].width;
+      best_index = i;
+    }
+  }
+  if (best_index == nodes.size())
+    return false;
+
+  out_x = nodes[best_index].x;
+  out_y = best_y;
+  add_level(best_index, out_x, out_y, rect_width, rect_height);
+  used_area += static_cast<long long>(rect_width) * rect_height;
+  return true;
+}
+
+void SkylinePacker::add_level(size_t index,
+                              int x,
+                              int y,
+                              int rect_width,
+                              int rect_height) {
+  nodes.insert(nodes.begin() + static_cast<long>(index),
+               {x, y + rect_height, rect_width});
+
+  // trim or drop the nodes the new one now covers
+  for (size_t i = index + 1; i < nodes.size(); i++) {
+    const Node& previous = nodes[i - 1];
+    const int covered = previous.x + previous.width - nodes[i].x;
+    if (covered <= 0)
+      break;
+    nodes[i].x += covered;
+    nodes[i].width -= covered;
+    if (nodes[i].width > 0)
+      break;
+    nodes.erase(nodes.begin() + static_cast<long>(i));
+    i--;
+  }
+
+  // neighbours at the same height become one
+  for (size_t i = 0; i + 1 < nodes.size(); i++) {
+    if (nodes[i].y == nodes[i + 1].y) {
+      nodes[i].width += nodes[i + 1].width;
+      nodes.erase(nodes.begin() + static_cast<long>(i) + 1);
+      i--;
+    }
+  }
+}
+
+float SkylinePacker::get_occupancy() const {
+  return static_cast<float>(used_area) /
+         (static_cast<float>(width) * static_cast<float>(height));
+}
@@ -0,0 +1,40 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_SKYLINEPACKER_H_
+#define PULSAR_SRC_ENGINE_CORE_SKYLINEPACKER_H_
+
+#include <cstddef>
+#include <vector>
+
+// Bottom-left skyline bin packer for one atlas page. The skyline is the
+// top edge of everything placed so far, a rect goes wherever it ends up
+// lowest, ties go to the spot that wastes the least width.
+class SkylinePacker {
+ public:
+  SkylinePacker(int width, int height);
+
+  // false when the rect no longer fits anywhere on the page
+  bool insert(int rect_width, int rect_height, int& out_x, int& out_y);
+
+  [[nodiscard]] int get_width() const { return width; }
+  [[nodiscard]] int get_height() const { return height; }
+  // area covered by inserted rects over page area
+  [[nodiscard]] float get_occupancy() const;
+
+ private:
+  struct Node {
+    int x;
+    int y;
+    int width;
+  };
+
+  // y the rect would rest at when its left edge sits on nodes[index], -1 if
+  // it does not fit there
+  [[nodiscard]] int fit(size_t index, int rect_width, int rect_height) const;
+  void add_level(size_t index, int x, int y, int rect_width, int rect_height);
+
+  int width;
+  int height;
+  long long used_area = 0;
+  std::vector<Node> nodes;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_SKYLINEPACKER_H_
@@ -0,0 +1,273 @@
+#include "SpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+constexpr size_t INITIAL_CELL_CAPACITY = 64;
+// keep probe chains short, the table is mostly read
+constexpr size_t MAX_LOAD_NUMERATOR = 7;
+constexpr size_t MAX_LOAD_DENOMINATOR = 10;
+}  // namespace
+
+SpatialHash::SpatialHash(float cell_size)
+    : cell_size(cell_size),
+      inv_cell_size(1.0f / cell_size),
+      cells(INITIAL_CELL_CAPACITY) {}
+
+void SpatialHash::set_cell_size(float new_cell_size) {
+  if (new_cell_size <= 0.0f or new_cell_size == cell_size)
+    return;
+  cell_size = new_cell_size;
+  inv_cell_size = 1.0f / new_cell_size;
+
+  // every entry changes cell, simplest to re-link from scratch
+  std::fill(cells.begin(), cells.end(), Cell{});
+  occupied_cells = 0;
+  for (const auto& [id, entry_index] : entry_of) {
+    const Entry& entry = entries[entry_index];
+    link(entry_index, cell_key(cell_coord(entry.x), cell_coord(entry.y)));
+  }
+}
+
+// Far out positions (an actor flung away by physics) share the outermost
+// cells, the cast itself is undefined past int32. Callers keep NaN out.
+int32_t SpatialHash::cell_coord(float v) const {
+  const double cell = std::floor(static_cast<double>(v) * inv_cell_size);
+  if (std::isnan(cell))
+    return 0;
+  return static_cast<int32_t>(
+      std::clamp(cell, static_cast<double>(std::numeric_limits<int32_t>::min()),
+                 static_cast<double>(std::numeric_limits<int32_t>::max())));
+}
+
+uint64_t SpatialHash::cell_key(int32_t cx, int32_t cy) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) |
+         static_cast<uint32_t>(cy);
+}
+
+// splitmix64 finalizer, neighbouring cells land far apart in the table
+uint64_t SpatialHash::mix(uint64_t key) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  return key;
+}
+
+int32_t SpatialHash::find_cell(uint64_t key) const {
+  const size_t capacity_mask = cells.size() - 1;
+  for (size_t slot = mix(key) & capacity_mask;;
+       slot = (slot + 1) & capacity_mask) {
+    const Cell& cell = cells[slot];
+    if (not cell.occupied)
+      return -1;
+    if (cell.key == key)
+      return static_cast<int32_t>(slot);
+  }
+}
+
+int32_t SpatialHash::find_or_insert_cell(uint64_t key) {
+  if ((occupied_cells + 1) * MAX_LOAD_DENOMINATOR >
+      cells.size() * MAX_LOAD_NUMERATOR) {
+    // cells left empty by moving actors get dropped by the rehash, so only
+    // grow for the ones still in use
+    const auto live_cells = static_cast<size_t>(
+        std::count_if(cells.begin(), cells.end(),
+                      [](const Cell& cell) { return cell.head != -1; }));
+    size_t new_capacity = cells.size();
+    while ((live_cells + 1) * 2 > new_capacity)
+      new_capacity *= 2;
+    rehash(new_capacity);
+  }
+
+  const size_t capacity_mask = cells.size() - 1;
+  for (size_t slot = mix(key) & capacity_mask;;
+       slot = (slot + 1) & capacity_mask) {
+    Cell& cell = cells[slot];
+    if (not cell.occupied) {
+      cell.key = key;
+      cell.head = -1;
+      cell.occupied = true;
+      occupied_cells++;
+      return static_cast<int32_t>(slot);
+    }
+    if (cell.key == key)
+      return static_cast<int32_t>(slot);
+  }
+}
+
+void SpatialHash::rehash(size_t new_capacity) {
+  std::vector<Cell> old_cells(new_capacity);
+  old_cells.swap(cells);
+  occupied_cells = 0;
+
+  const size_t capacity_mask = cells.size() - 1;
+  for (const Cell& old_cell : old_cells) {
+    // cells whose actors all left are dropped here
+    if (not old_cell.occupied or old_cell.head == -1)
+      continue;
+    size_t slot = mix(old_cell.key) & capacity_mask;
+    while (cells[slot].occupied)
+      slot = (slot + 1) & capacity_mask;
+    cells[slot] = old_cell;
+    occupied_cells++;
+  }
+}
+
+void SpatialHash::link(int32_t entry_index, uint64_t key) {
+  Cell& cell = cells[find_or_insert_cell(key)];
+  Entry& entry = entries[entry_index];
+  entry.cell = key;
+  entry.prev = -1;
+  entry.next = cell.head;
+  if (cell.head != -1)
+    entries[cell.head].prev = entry_index;
+  cell.head = entry_index;
+}
+
+void SpatialHash::unlink(int32_t entry_index) {
+  Entry& entry = entries[entry_index];
+  if (entry.prev != -1) {
+    entries[entry.prev].next = entry.next;
+  } else if (const int32_t slot = find_cell(entry.cell); slot != -1) {
+    cells[slot].head = entry.next;
+  }
+  if (entry.next != -1)
+    entries[entry.next].prev = entry.prev;
+  entry.prev = -1;
+  entry.next = -1;
+}
+
+void SpatialHash::update(size_t id, Actor* actor, float x, float y) {
+  // nowhere to file it, and no query could find it anyway
+  if (not std::isfinite(x) or not std::isfinite(y)) {
+    remove(id);
+    return;
+  }
+  const uint64_t key = cell_key(cell_coord(x), cell_coord(y));
+
+  if (const auto existing = entry_of.find(id); existing != entry_of.end()) {
+    Entry& entry = entries[existing->second];
+    entry.actor = actor;
+    entry.x = x;
+    entry.y = y;
+    if (entry.cell != key) {
+      unlink(existing->second);
+      link(existing->second, key);
+    }
+    return;
+  }
+
+  int32_t entry_index;
+  if (not free_entries.empty()) {
+    entry_index = free_entries.back();
+    free_entries.pop_back();
+  } else {
+    entry_index = static_cast<int32_t>(entries.size());
+    entries.emplace_back();
+  }
+  entries[entry_index] = Entry{actor, x, y, key, -1, -1};
+  link(entry_index, key);
+  entry_of.emplace(id, entry_index);
+}
+
+void SpatialHash::remove(size_t id) {
+  const auto existing = entry_of.find(id);
+  if (existing == entry_of.end())
+    return;
+  unlink(existing->second);
+  entries[existing->second].actor = nullptr;
+  free_entries.push_back(existing->second);
+  entry_of.erase(existing);
+}
+
+void SpatialHash::clear() {
+  entries.clear();
+  free_entries.clear();
+  entry_of.clear();
+  cells.assign(INITIAL_CELL_CAPACITY, Cell{});
+  occupied_cells = 0;
+}
+
+template <typename Visitor>
+void SpatialHash::visit_rect(float min_x,
+                             float min_y,
+                             float max_x,
+                             float max_y,
+                             Visitor&& visitor) const {
+  if (std::isnan(min_x) or std::isnan(min_y) or std::isnan(max_x) or
+      std::isnan(max_y))
+    return;
+  const auto visit_cell = [&](const Cell& cell) {
+    for (int32_t i = cell.head; i != -1; i = entries[i].next) {
+      const Entry& entry = entries[i];
+      if (entry.x >= min_x and entry.x <= max_x and entry.y >= min_y and
+          entry.y <= max_y)
+        visitor(entry);
+    }
+  };
+
+  const int64_t min_cx = cell_coord(min_x);
+  const int64_t max_cx = cell_coord(max_x);
+  const int64_t min_cy = cell_coord(min_y);
+  const int64_t max_cy = cell_coord(max_y);
+  const auto span_x = static_cast<uint64_t>(max_cx - min_cx + 1);
+  const auto span_y = static_cast<uint64_t>(max_cy - min_cy + 1);
+
+  // a huge rect touches more grid cells than there are live ones, checked
+  // one side at a time so the product can't overflow
+  if (span_x > occupied_cells or span_y > occupied_cells or
+      span_x * span_y > occupied_cells) {
+    for (const Cell& cell : cells) {
+      if (cell.occupied)
+        visit_cell(cell);
+    }
+    return;
+  }
+
+  for (int64_t cy = min_cy; cy <= max_cy; cy++) {
+    for (int64_t cx = min_cx; cx <= max_cx; cx++) {
+      const int32_t slot = find_cell(cell_key(static_cast<int32_t>(cx),
+                                              static_cast<int32_t>(cy)));
+      if (slot != -1)
+        visit_cell(cells[slot]);
+    }
+  }
+}
+
+void SpatialHash::query_rect(float min_x,
+                             float min_y,
+                             float max_x,
+                             float max_y,
+                             std::vector<Actor*>& actors) const {
+  if (min_x > max_x or min_y > max_y)
+    return;
+  visit_rect(min_x, min_y, max_x, max_y,
+             [&actors](const Entry& entry) { actors.push_back(entry.actor); });
+}
+
+void SpatialHash::query_radius(float x,
+                               float y,
+                               float radius,
+                               std::vector<Actor*>& actors) const {
+  if (radius < 0.0f)
+    return;
+  const float radius_squared = radius * radius;
+  std::vector<std::pair<float, Actor*>> hits;
+  visit_rect(x - radius, y - radius, x + radius, y + radius,
+             [&](const Entry& entry) {
+               const float dx = entry.x - x;
+               const float dy = entry.y - y;
+               if (const float d2 = dx * dx + dy * dy; d2 <= radius_squared)
+                 hits.emplace_back(d2, entry.actor);
+             });
+  std::sort(hits.begin(), hits.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+  actors.reserve(actors.size() + hits.size());
+  for (const auto& [d2, actor] : hits)
+    actors.push_back(actor);
+}
@@ -0,0 +1,87 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_SPATIALHASH_H_
+#define PULSAR_SRC_ENGINE_CORE_SPATIALHASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Actor;
+
+// Uniform grid over actor positions for proximity queries. Cells live in a
+// flat open-addressed table and each cell is an intrusive list threaded
+// through the entry array, so moving an actor between cells never allocates.
+// Entries are keyed by actor id since Lua can hand us copies of an Actor.
+class SpatialHash {
+ public:
+  explicit SpatialHash(float cell_size = 2.0f);
+
+  void set_cell_size(float new_cell_size);
+  [[nodiscard]] float get_cell_size() const { return cell_size; }
+
+  void update(size_t id, Actor* actor, float x, float y);
+  void remove(size_t id);
+  void clear();
+
+  // Appends actors inside the rectangle, in no particular order.
+  void query_rect(float min_x,
+                  float min_y,
+                  float max_x,
+                  float max_y,
+                  std::vector<Actor*>& actors) const;
+  // Appends actors within radius, nearest first.
+  void query_radius(float x,
+                    float y,
+                    float radius,
+                    std::vector<Actor*>& actors) const;
+
+  [[nodiscard]] size_t size() const { return entry_of.size(); }
+  [[nodiscard]] bool contains(size_t id) const {
+    return entry_of.count(id) > 0;
+  }
+
+ private:
+  struct Entry {
+    Actor* actor;
+    float x;
+    float y;
+    uint64_t cell;
+    int32_t prev;
+    int32_t next;
+  };
+
+  struct Cell {
+    uint64_t key = 0;
+    int32_t head = -1;
+    bool occupied = false;
+  };
+
+  template <typename Visitor>
+  void visit_rect(float min_x,
+                  float min_y,
+                  float max_x,
+                  float max_y,
+                  Visitor&& visitor) const;
+
+  [[nodiscard]] int32_t cell_coord(float v) const;
+  static uint64_t cell_key(int32_t cx, int32_t cy);
+  static uint64_t mix(uint64_t key);
+  [[nodiscard]] int32_t find_cell(uint64_t key) const;
+  int32_t find_or_insert_cell(uint64_t key);
+  void rehash(size_t new_capacity);
+  void link(int32_t entry_index, uint64_t key);
+  void unlink(int32_t entry_index);
+
+  float cell_size;
+  float inv_cell_size;
+
+  std::vector<Entry> entries;
+  std::vector<int32_t> free_entries;
+  std::unordered_map<size_t, int32_t> entry_of;
+
+  // capacity is always a power of two
+  std::vector<Cell> cells;
+  size_t occupied_cells = 0;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_SPATIALHASH_H_
@@ -0,0 +1,52 @@
+#include "SpriteBatch.h"
+
+void SpriteBatch::begin(SDL_Renderer* target) {
+  renderer = target;
+  texture = nullptr;
+  // textures can be freed and their address reused between frames
+  sized_texture = nullptr;
+  vertices.clear();
+  indices.clear();
+  draw_calls = 0;
+  sprite_count = 0;
+}
+
+void SpriteBatch::add(SDL_Texture* quad_texture,
+                      const SDL_FPoint corners[4],
+                      const SDL_FRect& uv,
+                      SDL_Color color) {
+  if (quad_texture != texture) {
+    flush();
+    texture = quad_texture;
+  }
+  const SDL_FPoint uvs[4] = {{uv.x, uv.y},
+                             {uv.x + uv.w, uv.y},
+                             {uv.x + uv.w, uv.y + uv.h},
+                             {uv.x, uv.y + uv.h}};
+  const int base = static_cast<int>(vertices.size());
+  for (int i = 0; i < 4; i++)
+    vertices.push_back({corners[i], color, uvs[i]});
+  indices.insert(indices.end(),
+                 {base, base + 1, base + 2, base, base + 2, base + 3});
+  sprite_count++;
+}
+
+void SpriteBatch::flush() {
+  if (indices.empty())
+    return;
+  SDL_RenderGeometry(renderer, texture, vertices.data(),
+                     static_cast<int>(vertices.size()), indices.data(),
+                     static_cast<int>(indices.size()));
+  draw_calls++;
+  vertices.clear();
+  indices.clear();
+}
+
+SDL_Point SpriteBatch::get_texture_size(SDL_Texture* sized) {
+  if (sized != sized_texture) {
+    sized_texture = sized;
+    SDL_QueryTexture(sized, nullptr, nullptr, &sized_texture_size.x,
+                     &sized_texture_size.y);
+  }
+  return sized_texture_size;
+}
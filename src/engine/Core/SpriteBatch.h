@@ -0,0 +1,44 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_SPRITEBATCH_H_
+#define PULSAR_SRC_ENGINE_CORE_SPRITEBATCH_H_
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <vector>
+
+// Collects textured quads and draws every run that shares a texture with one
+// SDL_RenderGeometry call. Callers bake position, rotation, pivot, scale and
+// zoom into the corners and colour/alpha mod into the vertex colour, so the
+// texture's own state is never touched. Runs are only ever consecutive quads,
+// draw order stays exactly what the caller asked for.
+class SpriteBatch {
+ public:
+  void begin(SDL_Renderer* target);
+  // corners go clockwise from the top left of the uv rect, which is in
+  // normalised texture coordinates ({0, 0, 1, 1} for the whole texture)
+  void add(SDL_Texture* texture,
+           const SDL_FPoint corners[4],
+           const SDL_FRect& uv,
+           SDL_Color color);
+  void flush();
+
+  // Size of the texture, remembered for the last one asked about since
+  // requests for the same sprite tend to come in a row.
+  SDL_Point get_texture_size(SDL_Texture* texture);
+
+  [[nodiscard]] size_t get_draw_calls() const { return draw_calls; }
+  [[nodiscard]] size_t get_sprite_count() const { return sprite_count; }
+
+ private:
+  SDL_Renderer* renderer = nullptr;
+  SDL_Texture* texture = nullptr;
+  std::vector<SDL_Vertex> vertices;
+  std::vector<int> indices;
+
+  SDL_Texture* sized_texture = nullptr;
+  SDL_Point sized_texture_size{0, 0};
+
+  size_t draw_calls = 0;
+  size_t sprite_count = 0;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_SPRITEBATCH_H_
@@ -0,0 +1,277 @@
+#include "StaticGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#include "PhysicsConfig.h"
+#include "Rigidbody.h"
+#include "SceneManager.h"
+
+namespace {
+constexpr float GRID_EPSILON = 0.001f;
+constexpr uintptr_t REGION_TAG = 1;
+}  // namespace
+
+uint64_t StaticGeometry::tile_key(int32 ix, int32 iy) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(ix)) << 32) |
+         static_cast<uint32_t>(iy);
+}
+
+bool StaticGeometry::tile_index(const Region& region,
+                                const b2Vec2& pos,
+                                int32& ix,
+                                int32& iy) {
+  const float fx = (pos.x - region.origin.x) / region.cell_size;
+  const float fy = (pos.y - region.origin.y) / region.cell_size;
+  ix = static_cast<int32>(std::lround(fx));
+  iy = static_cast<int32>(std::lround(fy));
+  return std::abs(fx - static_cast<float>(ix)) < GRID_EPSILON and
+         std::abs(fy - static_cast<float>(iy)) < GRID_EPSILON;
+}
+
+bool StaticGeometry::try_add(Rigidbody* rigidbody) {
+  const auto& config = PhysicsConfig::getInstance();
+  if (not config.merge_static_colliders)
+    return false;
+
+  const float cell = config.static_tile_size;
+  if (rigidbody->body_type != "static" or rigidbody->collider_type != "box" or
+      not rigidbody->has_collider or rigidbody->has_trigger or
+      rigidbody->rotation != 0.0f or
+      std::abs(rigidbody->collider_width - cell) > GRID_EPSILON or
+      std::abs(rigidbody->collider_height - cell) > GRID_EPSILON)
+    return false;
+
+  const b2Vec2 pos(rigidbody->x, rigidbody->y);
+  const b2Filter filter = rigidbody->get_collider_filter();
+  Region* target = nullptr;
+  int32 ix = 0;
+  int32 iy = 0;
+  for (const auto& region : regions) {
+    if (region->friction == rigidbody->friction and
+        region->bounciness == rigidbody->bounciness and
+        region->filter.categoryBits == filter.categoryBits and
+        region->filter.maskBits == filter.maskBits and
+        tile_index(*region, pos, ix, iy)) {
+      target = region.get();
+      break;
+    }
+  }
+  if (target == nullptr) {
+    auto region = std::make_unique<Region>();
+    region->origin = pos;
+    region->cell_size = cell;
+    region->friction = rigidbody->friction;
+    region->bounciness = rigidbody->bounciness;
+    region->filter = filter;
+    target = region.get();
+    regions.push_back(std::move(region));
+    ix = 0;
+    iy = 0;
+  }
+
+  // two colliders on one tile, let the second one be a normal body
+  const uint64_t key = tile_key(ix, iy);
+  if (not target->tiles.emplace(key, rigidbody).second)
+    return false;
+  region_of[rigidbody] = {target, key};
+  target->dirty = true;
+  return true;
+}
+
+bool StaticGeometry::remove(Rigidbody* rigidbody) {
+  const auto region_itr = region_of.find(rigidbody);
+  if (region_itr == region_of.end())
+    return false;
+
+  auto& [region, key] = region_itr->second;
+  region->tiles.erase(key);
+  region->dirty = true;
+  region_of.erase(region_itr);
+  return true;
+}
+
+void StaticGeometry::flush() {
+  for (auto& region : regions) {
+    if (region->dirty)
+      rebuild(*region);
+  }
+  // empty regions have no body left and nothing points at them
+  std::erase_if(regions, [](const auto& region) {
+    return region->tiles.empty() and region->body == nullptr;
+  });
+}
+
+void StaticGeometry::reset() {
+  regions.clear();
+  region_of.clear();
+}
+
+void StaticGeometry::rebuild(Region& region) {
+  region.dirty = false;
+  auto* phys_world = SceneManager::getInstance().GetPhysWorld();
+  if (region.body) {
+    phys_world->DestroyBody(region.body);
+    region.body = nullptr;
+  }
+  if (region.tiles.empty())
+    return;
+
+  std::vector<std::pair<int32, int32>> coords;
+  coords.reserve(region.tiles.size());
+  for (const auto& [key, rigidbody] : region.tiles)
+    coords.emplace_back(static_cast<int32>(key >> 32),
+                        static_cast<int32>(key & 0xffffffffu));
+
+  b2BodyDef body_def;
+  body_def.type = b2_staticBody;
+  body_def.position = region.origin;
+  region.body = phys_world->CreateBody(&body_def);
+
+  b2FixtureDef fixture_def;
+  fixture_def.friction = region.friction;
+  fixture_def.restitution = region.bounciness;
+  fixture_def.userData.pointer =
+      reinterpret_cast<uintptr_t>(&region) | REGION_TAG;
+  fixture_def.filter = region.filter;
+
+  const float cell = region.cell_size;
+  for (const TileRect& rect : merge_tiles(std::move(coords))) {
+    const b2Vec2 center(
+        (static_cast<float>(rect.x) + (rect.width - 1) * 0.5f) * cell,
+        (static_cast<float>(rect.y) + (rect.height - 1) * 0.5f) * cell);
+    b2PolygonShape rectangle;
+    rectangle.SetAsBox(rect.width * cell * 0.5f, rect.height * cell * 0.5f,
+                       center, 0.0f);
+    fixture_def.shape = &rectangle;
+    region.body->CreateFixture(&fixture_def);
+  }
+}
+
+std::vector<StaticGeometry::TileRect> StaticGeometry::merge_tiles(
+    std::vector<std::pair<int32, int32>> tiles) {
+  // row by row so the greedy pass below grows right first, then down
+  std::sort(tiles.begin(), tiles.end(), [](const auto& a, const auto& b) {
+    return a.second == b.second ? a.first < b.first : a.second < b.second;
+  });
+
+  std::unordered_set<uint64_t> present;
+  present.reserve(tiles.size());
+  for (const auto& [ix, iy] : tiles)
+    present.insert(tile_key(ix, iy));
+  std::unordered_set<uint64_t> merged;
+  merged.reserve(tiles.size());
+  const auto free_tile = [&](int32 x, int32 y) {
+    const uint64_t key = tile_key(x, y);
+    return present.count(key) > 0 and merged.count(key) == 0;
+  };
+
+  std::vector<TileRect> rects;
+  for (const auto& [ix, iy] : tiles) {
+    if (merged.count(tile_key(ix, iy)) > 0)
+      continue;
+
+    int32 width = 1;
+    while (free_tile(ix + width, iy))
+      width++;
+
+    int32 height = 1;
+    while (true) {
+      bool row_free = true;
+      for (int32 x = ix; x < ix + width and row_free; x++)
+        row_free = free_tile(x, iy + height);
+      if (not row_free)
+        break;
+      height++;
+    }
+
+    for (int32 y = iy; y < iy + height; y++)
+      for (int32 x = ix; x < ix + width; x++)
+        merged.insert(tile_key(x, y));
+    rects.push_back({ix, iy, width, height});
+  }
+  return rects;
+}
+
+bool StaticGeometry::is_region_fixture(const b2Fixture* fixture) {
+  return (fixture->GetUserData().pointer & REGION_TAG) != 0;
+}
+
+b2AABB StaticGeometry::fixture_bounds(const b2Fixture* fixture) {
+  b2AABB bounds;
+  fixture->GetShape()->ComputeAABB(&bounds, fixture->GetBody()->GetTransform(),
+                                   0);
+  return bounds;
+}
+
+Actor* StaticGeometry::resolve_actor(const b2Fixture* fixture,
+                                     const b2Vec2& hint) {
+  const uintptr_t pointer = fixture->GetUserData().pointer;
+  if ((pointer & REGION_TAG) == 0)
+    return reinterpret_cast<Actor*>(pointer);
+
+  const auto& region = *reinterpret_cast<const Region*>(pointer & ~REGION_TAG);
+  // keep the hint inside this fixture's rectangle so we land on one of its
+  // tiles even for points on the edge or next to it
+  const b2AABB bounds = fixture_bounds(fixture);
+  const float half_cell = region.cell_size * 0.5f;
+  const b2Vec2 clamped(
+      std::clamp(hint.x, bounds.lowerBound.x + half_cell,
+                 std::max(bounds.lowerBound.x + half_cell,
+                          bounds.upperBound.x - half_cell)),
+      std::clamp(hint.y, bounds.lowerBound.y + half_cell,
+                 std::max(bounds.lowerBound.y + half_cell,
+                          bounds.upperBound.y - half_cell)));
+
+  int32 ix = 0;
+  int32 iy = 0;
+  tile_index(region, clamped, ix, iy);
+  const auto tile = region.tiles.find(tile_key(ix, iy));
+  if (tile == region.tiles.end())
+    return nullptr;
+  return tile->second->actor;
+}
+
+void StaticGeometry::collect_overlapping(const b2Fixture* fixture,
+                                         const b2Shape* shape,
+                                         const b2Transform& transform,
+                                         std::vector<Actor*>& actors) {
+  const auto& region = *reinterpret_cast<const Region*>(
+      fixture->GetUserData().pointer & ~REGION_TAG);
+  b2AABB query_bounds;
+  shape->ComputeAABB(&query_bounds, transform, 0);
+  const b2AABB bounds = fixture_bounds(fixture);
+
+  const float cell = region.cell_size;
+  const auto first_tile = [&](float lower, float origin) {
+    return static_cast<int32>(std::floor((lower - origin) / cell + 0.5f));
+  };
+  const auto last_tile = [&](float upper, float origin) {
+    return static_cast<int32>(std::ceil((upper - origin) / cell - 0.5f));
+  };
+  const int32 min_x = first_tile(
+      std::max(query_bounds.lowerBound.x, bounds.lowerBound.x), region.origin.x);
+  const int32 max_x = last_tile(
+      std::min(query_bounds.upperBound.x, bounds.upperBound.x), region.origin.x);
+  const int32 min_y = first_tile(
+      std::max(query_bounds.lowerBound.y, bounds.lowerBound.y), region.origin.y);
+  const int32 max_y = last_tile(
+      std::min(query_bounds.upperBound.y, bounds.upperBound.y), region.origin.y);
+
+  b2PolygonShape tile_box;
+  tile_box.SetAsBox(cell * 0.5f, cell * 0.5f);
+  for (int32 iy = min_y; iy <= max_y; iy++) {
+    for (int32 ix = min_x; ix <= max_x; ix++) {
+      const auto tile = region.tiles.find(tile_key(ix, iy));
+      if (tile == region.tiles.end() or tile->second->actor == nullptr)
+        continue;
+      const b2Transform tile_transform(
+          region.origin + b2Vec2(ix * cell, iy * cell), b2Rot(0.0f));
+      if (b2TestOverlap(shape, 0, &tile_box, 0, transform, tile_transform) and
+          std::find(actors.begin(), actors.end(), tile->second->actor) ==
+              actors.end())
+        actors.push_back(tile->second->actor);
+    }
+  }
+}
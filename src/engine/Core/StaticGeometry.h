@@ -0,0 +1,101 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_STATICGEOMETRY_H_
+#define PULSAR_SRC_ENGINE_CORE_STATICGEOMETRY_H_
+
+#include <box2d/box2d.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Actor;
+class Rigidbody;
+
+// Bakes static, unrotated box colliders that sit on a shared grid into a few
+// large rectangles on one body per region instead of a body per tile. Region
+// fixtures carry a tagged region pointer as user data (low bit set) rather
+// than an Actor*, resolve_actor maps a point on them back to the tile's actor.
+// A tile whose position or rotation gets set leaves its region for a body of
+// its own, see Rigidbody::SetPosition.
+//
+// Contacts change with merging: Box2D reports one contact per fixture pair,
+// so a body sliding across a merged run gets one OnCollisionEnter / Exit for
+// the whole rectangle instead of one per tile. Enter goes to the tile at the
+// first contact point, Exit to the tile nearest the body as it leaves, which
+// can be a different one. Scripts that count tiles touched should use a
+// trigger or a query instead.
+class StaticGeometry {
+  StaticGeometry() = default;
+
+ public:
+  StaticGeometry(const StaticGeometry&) = delete;
+  StaticGeometry& operator=(const StaticGeometry&) = delete;
+  StaticGeometry(StaticGeometry&&) = delete;
+  StaticGeometry& operator=(StaticGeometry&&) = delete;
+
+  static StaticGeometry& getInstance() {
+    static StaticGeometry instance;
+    return instance;
+  }
+
+  // Takes the Rigidbody over when it qualifies, it then never gets a body of
+  // its own. Baking happens on the next flush.
+  bool try_add(Rigidbody* rigidbody);
+  // Returns whether the Rigidbody was one of the merged tiles.
+  bool remove(Rigidbody* rigidbody);
+  // Rebuilds the bodies of regions that gained or lost tiles.
+  void flush();
+  // Forgets every region, the world that owns their bodies is going away.
+  void reset();
+
+  // Actor behind a fixture. For region fixtures the tile nearest to hint
+  // (a world point on or inside the fixture) is picked.
+  static Actor* resolve_actor(const b2Fixture* fixture, const b2Vec2& hint);
+  static bool is_region_fixture(const b2Fixture* fixture);
+  // Actors of every tile of a region fixture that overlaps the shape.
+  static void collect_overlapping(const b2Fixture* fixture,
+                                  const b2Shape* shape,
+                                  const b2Transform& transform,
+                                  std::vector<Actor*>& actors);
+
+  // A run of tiles baked into one fixture, in tile coordinates.
+  struct TileRect {
+    int32 x;
+    int32 y;
+    int32 width;
+    int32 height;
+  };
+  // Greedy cover of the tiles, each rectangle grows right first and then
+  // down as far as whole rows of unclaimed tiles allow.
+  static std::vector<TileRect> merge_tiles(
+      std::vector<std::pair<int32, int32>> tiles);
+
+  [[nodiscard]] size_t get_region_count() const { return regions.size(); }
+  [[nodiscard]] size_t get_tile_count() const { return region_of.size(); }
+
+ private:
+  struct Region {
+    b2Vec2 origin;
+    float cell_size;
+    float friction;
+    float bounciness;
+    b2Filter filter;
+    std::unordered_map<uint64_t, Rigidbody*> tiles;
+    b2Body* body = nullptr;
+    bool dirty = false;
+  };
+
+  static uint64_t tile_key(int32 ix, int32 iy);
+  static bool tile_index(const Region& region,
+                         const b2Vec2& pos,
+                         int32& ix,
+                         int32& iy);
+  static b2AABB fixture_bounds(const b2Fixture* fixture);
+  void rebuild(Region& region);
+
+  // unique_ptr so the tagged pointers in fixture user data stay valid
+  std::vector<std::unique_ptr<Region>> regions;
+  std::unordered_map<Rigidbody*, std::pair<Region*, uint64_t>> region_of;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_STATICGEOMETRY_H_
@@ -0,0 +1,45 @@
+#include "TextLayoutCache.h"
+
+std::string TextLayoutCache::make_key(const std::string& font,
+                                      int size,
+                                      const std::string& text) {
+  std::string key;
+  key.reserve(font.size() + text.size() + 8);
+  key.append(font).push_back('\0');
+  key.append(std::to_string(size)).push_back('\0');
+  key.append(text);
+  return key;
+}
+
+const TextLayout* TextLayoutCache::find(const std::string& key) {
+  const auto it = index.find(key);
+  if (it == index.end()) {
+    misses++;
+    return nullptr;
+  }
+  hits++;
+  entries.splice(entries.begin(), entries, it->second);
+  return &it->second->second;
+}
+
+const TextLayout& TextLayoutCache::insert(const std::string& key,
+                                          TextLayout layout) {
+  const auto it = index.find(key);
+  if (it != index.end()) {
+    it->second->second = std::move(layout);
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+  }
+  if (capacity > 0 and entries.size() >= capacity) {
+    index.erase(entries.back().first);
+    entries.pop_back();
+  }
+  entries.emplace_front(key, std::move(layout));
+  index[key] = entries.begin();
+  return entries.front().second;
+}
+
+void TextLayoutCache::clear() {
+  entries.clear();
+  index.clear();
+}
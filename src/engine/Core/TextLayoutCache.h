@@ -0,0 +1,57 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_TEXTLAYOUTCACHE_H_
+#define PULSAR_SRC_ENGINE_CORE_TEXTLAYOUTCACHE_H_
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A string laid out once as glyph quads relative to its top left corner.
+struct TextLayout {
+  struct Quad {
+    SDL_Texture* texture;
+    SDL_FRect dst;
+    SDL_FRect uv;
+  };
+  std::vector<Quad> quads;
+  int width = 0;
+  int height = 0;
+};
+
+// Least recently used cache of TextLayouts, so HUD strings that don't change
+// from frame to frame skip layout too. Quads point at GlyphAtlas pages, clear
+// this whenever those go away.
+class TextLayoutCache {
+ public:
+  explicit TextLayoutCache(size_t capacity) : capacity(capacity) {}
+
+  static std::string make_key(const std::string& font,
+                              int size,
+                              const std::string& text);
+
+  // nullptr on a miss, a hit becomes the most recently used
+  const TextLayout* find(const std::string& key);
+  // evicts the least recently used entry when full
+  const TextLayout& insert(const std::string& key, TextLayout layout);
+  void clear();
+
+  [[nodiscard]] size_t size() const { return entries.size(); }
+  [[nodiscard]] size_t get_capacity() const { return capacity; }
+  [[nodiscard]] size_t get_hits() const { return hits; }
+  [[nodiscard]] size_t get_misses() const { return misses; }
+
+ private:
+  using Entry = std::pair<std::string, TextLayout>;
+
+  size_t capacity;
+  // front is the most recently used
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+  size_t hits = 0;
+  size_t misses = 0;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_TEXTLAYOUTCACHE_H_
@@ -0,0 +1,66 @@
+#include "TextureAtlas.h"
+
+#include <SDL2_image/SDL_image.h>
+#include <rapidjson/document.h>
+#include <filesystem>
+#include <iostream>
+
+#include "EngineUtils.h"
+#include "Core/Resources.hpp"
+
+void TextureAtlas::load(SDL_Renderer* renderer) {
+  clear();
+  const std::filesystem::path atlas_path =
+      App::Resources::game_path() / DIRECTORY;
+  const std::string manifest_path = (atlas_path / MANIFEST).generic_string();
+  if (not std::filesystem::exists(manifest_path))
+    return;
+
+  rapidjson::Document manifest;
+  EngineUtils::ReadJsonFile(manifest_path, manifest);
+  if (not manifest.HasMember("pages") or not manifest["pages"].IsArray() or
+      not manifest.HasMember("regions") or not manifest["regions"].IsObject()) {
+    std::cout << "error: atlas manifest " << manifest_path << " is malformed";
+    std::exit(0);
+  }
+
+  std::vector<SDL_Point> page_sizes;
+  for (const auto& page : manifest["pages"].GetArray()) {
+    const std::string page_path =
+        (atlas_path / page.GetString()).generic_string();
+    SDL_Texture* texture = IMG_LoadTexture(renderer, page_path.c_str());
+    if (texture == nullptr) {
+      std::cout << "error: missing atlas page " << page_path;
+      std::exit(0);
+    }
+    SDL_Point size{0, 0};
+    SDL_QueryTexture(texture, nullptr, nullptr, &size.x, &size.y);
+    pages.push_back(texture);
+    page_sizes.push_back(size);
+  }
+
+  for (const auto& entry : manifest["regions"].GetObject()) {
+    const auto& value = entry.value;
+    const auto page = static_cast<size_t>(value["page"].GetInt());
+    if (page >= pages.size())
+      continue;
+    const auto page_w = static_cast<float>(page_sizes[page].x);
+    const auto page_h = static_cast<float>(page_sizes[page].y);
+    Region region{};
+    region.texture = pages[page];
+    region.width = value["w"].GetInt();
+    region.height = value["h"].GetInt();
+    region.uv = {static_cast<float>(value["x"].GetInt()) / page_w,
+                 static_cast<float>(value["y"].GetInt()) / page_h,
+                 static_cast<float>(region.width) / page_w,
+                 static_cast<float>(region.height) / page_h};
+    regions.emplace(entry.name.GetString(), region);
+  }
+}
+
+void TextureAtlas::clear() {
+  for (SDL_Texture* page : pages)
+    SDL_DestroyTexture(page);
+  pages.clear();
+  regions.clear();
+}
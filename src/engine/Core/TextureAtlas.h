@@ -0,0 +1,54 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_TEXTUREATLAS_H_
+#define PULSAR_SRC_ENGINE_CORE_TEXTUREATLAS_H_
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Runtime side of the atlas AtlasBuilder writes to <game>/atlas. Image names
+// in the manifest resolve to a rect on one of the page textures, everything
+// else keeps going through Renderer's per image textures.
+class TextureAtlas {
+  TextureAtlas() = default;
+
+ public:
+  TextureAtlas(const TextureAtlas&) = delete;
+  TextureAtlas& operator=(const TextureAtlas&) = delete;
+  TextureAtlas(TextureAtlas&&) = delete;
+  TextureAtlas& operator=(TextureAtlas&&) = delete;
+
+  static TextureAtlas& getInstance() {
+    static TextureAtlas instance;
+    return instance;
+  }
+
+  struct Region {
+    SDL_Texture* texture;
+    SDL_FRect uv;
+    // source image size in pixels
+    int width;
+    int height;
+  };
+
+  static constexpr const char* DIRECTORY = "atlas";
+  static constexpr const char* MANIFEST = "atlas.json";
+
+  // No manifest, no atlas.
+  void load(SDL_Renderer* renderer);
+  void clear();
+
+  [[nodiscard]] const Region* find(const std::string& image_name) const {
+    const auto it = regions.find(image_name);
+    return it == regions.end() ? nullptr : &it->second;
+  }
+  [[nodiscard]] size_t get_page_count() const { return pages.size(); }
+  [[nodiscard]] size_t get_region_count() const { return regions.size(); }
+
+ private:
+  std::vector<SDL_Texture*> pages;
+  std::unordered_map<std::string, Region> regions;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_TEXTUREATLAS_H_
@@ -0,0 +1,42 @@
+#include "TextureCache.h"
+
+SDL_Texture* TextureCache::find(const std::string& name) const {
+  const auto it = entries.find(name);
+  return it == entries.end() ? nullptr : it->second.texture;
+}
+
+void TextureCache::insert(const std::string& name,
+                          SDL_Texture* texture,
+                          size_t bytes,
+                          uint64_t frame) {
+  const auto [it, inserted] =
+      entries.try_emplace(name, Entry{texture, bytes, frame});
+  if (not inserted) {
+    resident_bytes -= it->second.bytes;
+    it->second = {texture, bytes, frame};
+  }
+  resident_bytes += bytes;
+}
+
+void TextureCache::touch(const std::string& name, uint64_t frame) {
+  const auto it = entries.find(name);
+  if (it != entries.end() and it->second.last_used < frame)
+    it->second.last_used = frame;
+}
+
+void TextureCache::acquire(const std::string& name) {
+  references[name]++;
+}
+
+void TextureCache::release(const std::string& name) {
+  const auto it = references.find(name);
+  if (it == references.end())
+    return;
+  if (--it->second == 0)
+    references.erase(it);
+}
+
+uint32_t TextureCache::get_references(const std::string& name) const {
+  const auto it = references.find(name);
+  return it == references.end() ? 0 : it->second;
+}
@@ -0,0 +1,143 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_TEXTURECACHE_H_
+#define PULSAR_SRC_ENGINE_CORE_TEXTURECACHE_H_
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Renderer's per image textures, with how big they are, who holds them and
+// when they were last drawn. References are by name and can be taken before
+// the texture is even loaded (a scene holds everything in its manifest).
+// trim() frees textures until the resident bytes fit the budget,
+// unreferenced ones first, least recently used first within each. Textures
+// used at or after keep_frame are never freed, the frame being drawn may
+// still point at them. Nothing here calls SDL, evicted textures go to the
+// caller to destroy.
+class TextureCache {
+ public:
+  struct Entry {
+    SDL_Texture* texture;
+    size_t bytes;
+    uint64_t last_used;
+  };
+
+  // 0 means no budget
+  explicit TextureCache(size_t budget_bytes = 0) : budget(budget_bytes) {}
+
+  [[nodiscard]] SDL_Texture* find(const std::string& name) const;
+  [[nodiscard]] bool contains(const std::string& name) const {
+    return entries.count(name) > 0;
+  }
+  void insert(const std::string& name,
+              SDL_Texture* texture,
+              size_t bytes,
+              uint64_t frame);
+  void touch(const std::string& name, uint64_t frame);
+
+  void acquire(const std::string& name);
+  void release(const std::string& name);
+  [[nodiscard]] uint32_t get_references(const std::string& name) const;
+
+  template <typename Fn>
+  size_t trim(uint64_t keep_frame, Fn&& on_evicted);
+  // frees every unreferenced texture not used since keep_frame, budget or not
+  template <typename Fn>
+  size_t drop_unreferenced(uint64_t keep_frame, Fn&& on_evicted);
+  template <typename Fn>
+  void clear(Fn&& on_evicted);
+
+  template <typename Fn>
+  void for_each(Fn&& fn) const {
+    for (const auto& [name, entry] : entries)
+      fn(name, entry, get_references(name));
+  }
+
+  void set_budget(size_t budget_bytes) { budget = budget_bytes; }
+  [[nodiscard]] size_t get_budget() const { return budget; }
+  [[nodiscard]] size_t get_resident_bytes() const { return resident_bytes; }
+  [[nodiscard]] size_t size() const { return entries.size(); }
+  [[nodiscard]] size_t get_evicted_count() const { return evicted_count; }
+
+ private:
+  template <typename Fn>
+  void evict(const std::string& name, Fn& on_evicted);
+
+  std::unordered_map<std::string, Entry> entries;
+  std::unordered_map<std::string, uint32_t> references;
+  size_t budget;
+  size_t resident_bytes = 0;
+  size_t evicted_count = 0;
+  // trim's candidate list, kept for its capacity
+  std::vector<const std::string*> candidates;
+};
+
+template <typename Fn>
+void TextureCache::evict(const std::string& name, Fn& on_evicted) {
+  const auto it = entries.find(name);
+  resident_bytes -= it->second.bytes;
+  SDL_Texture* texture = it->second.texture;
+  // the name might be the map's own key
+  const std::string evicted_name = name;
+  entries.erase(it);
+  evicted_count++;
+  on_evicted(evicted_name, texture);
+}
+
+template <typename Fn>
+size_t TextureCache::trim(uint64_t keep_frame, Fn&& on_evicted) {
+  if (budget == 0 or resident_bytes <= budget)
+    return 0;
+  candidates.clear();
+  for (const auto& [name, entry] : entries) {
+    if (entry.last_used < keep_frame)
+      candidates.push_back(&name);
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [this](const std::string* a, const std::string* b) {
+              const bool a_held = get_references(*a) > 0;
+              const bool b_held = get_references(*b) > 0;
+              if (a_held != b_held)
+                return b_held;
+              return entries.at(*a).last_used < entries.at(*b).last_used;
+            });
+  // names are copied out first, evicting erases the keys they point at
+  std::vector<std::string> victims;
+  size_t bytes_left = resident_bytes;
+  for (const std::string* name : candidates) {
+    if (bytes_left <= budget)
+      break;
+    bytes_left -= entries.at(*name).bytes;
+    victims.push_back(*name);
+  }
+  candidates.clear();
+  for (const auto& name : victims)
+    evict(name, on_evicted);
+  return victims.size();
+}
+
+template <typename Fn>
+size_t TextureCache::drop_unreferenced(uint64_t keep_frame, Fn&& on_evicted) {
+  std::vector<std::string> victims;
+  for (const auto& [name, entry] : entries) {
+    if (entry.last_used < keep_frame and get_references(name) == 0)
+      victims.push_back(name);
+  }
+  for (const auto& name : victims)
+    evict(name, on_evicted);
+  return victims.size();
+}
+
+template <typename Fn>
+void TextureCache::clear(Fn&& on_evicted) {
+  for (auto& [name, entry] : entries)
+    on_evicted(name, entry.texture);
+  entries.clear();
+  references.clear();
+  resident_bytes = 0;
+}
+
+#endif  // PULSAR_SRC_ENGINE_CORE_TEXTURECACHE_H_
@@ -0,0 +1,66 @@
+#include "TextureLoader.h"
+
+#include <SDL2_image/SDL_image.h>
+
+#include "JobSystem.h"
+
+// Make sure the pool outlives us, decodes still running at exit need it.
+TextureLoader::TextureLoader() {
+  JobSystem::getInstance();
+}
+
+TextureLoader::~TextureLoader() {
+  std::unique_lock lock(mutex);
+  idle_cv.wait(lock, [this] { return in_flight == 0; });
+  for (auto& image : decoded)
+    SDL_FreeSurface(image.surface);
+  decoded.clear();
+}
+
+void TextureLoader::request(const std::string& image_name,
+                            const std::string& path) {
+  {
+    std::lock_guard lock(mutex);
+    if (not requested.insert(image_name).second)
+      return;
+    in_flight++;
+  }
+  JobSystem::getInstance().submit([this, image_name, path] {
+    SDL_Surface* surface = IMG_Load(path.c_str());
+    {
+      std::lock_guard lock(mutex);
+      decoded.push_back({image_name, surface});
+      in_flight--;
+    }
+    idle_cv.notify_all();
+  });
+}
+
+void TextureLoader::forget(const std::string& image_name) {
+  std::lock_guard lock(mutex);
+  requested.erase(image_name);
+}
+
+bool TextureLoader::pop_decoded(size_t budget_left, bool first, Decoded& out) {
+  std::lock_guard lock(mutex);
+  if (decoded.empty())
+    return false;
+  const SDL_Surface* surface = decoded.front().surface;
+  const size_t bytes =
+      surface ? static_cast<size_t>(surface->pitch) * surface->h : 0;
+  if (not first and bytes > budget_left)
+    return false;
+  out = std::move(decoded.front());
+  decoded.pop_front();
+  return true;
+}
+
+size_t TextureLoader::get_loading_count() const {
+  std::lock_guard lock(mutex);
+  return in_flight + decoded.size();
+}
+
+void TextureLoader::wait_idle() {
+  std::unique_lock lock(mutex);
+  idle_cv.wait(lock, [this] { return in_flight == 0; });
+}
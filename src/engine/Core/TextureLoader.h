@@ -0,0 +1,82 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_TEXTURELOADER_H_
+#define PULSAR_SRC_ENGINE_CORE_TEXTURELOADER_H_
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+// Decodes PNGs on the JobSystem and hands the surfaces back to the main
+// thread, which uploads as many per frame as the budget allows (but always
+// at least one, so a big image can't stall forever). Renderer draws nothing
+// for an image until its texture is up.
+class TextureLoader {
+  TextureLoader();
+  ~TextureLoader();
+
+ public:
+  TextureLoader(const TextureLoader&) = delete;
+  TextureLoader& operator=(const TextureLoader&) = delete;
+  TextureLoader(TextureLoader&&) = delete;
+  TextureLoader& operator=(TextureLoader&&) = delete;
+
+  static TextureLoader& getInstance() {
+    static TextureLoader instance;
+    return instance;
+  }
+
+  // Any thread. Names already requested are ignored.
+  void request(const std::string& image_name, const std::string& path);
+  // the texture was freed, the next request loads it again
+  void forget(const std::string& image_name);
+
+  // Main thread. Creates textures for decoded images until budget_bytes of
+  // pixels went up, calling on_uploaded(name, texture) for each. texture is
+  // null when the PNG couldn't be decoded.
+  template <typename Fn>
+  size_t upload(SDL_Renderer* renderer, size_t budget_bytes, Fn&& on_uploaded);
+
+  [[nodiscard]] size_t get_loading_count() const;
+  // blocks until every requested image has been decoded
+  void wait_idle();
+
+ private:
+  struct Decoded {
+    std::string name;
+    SDL_Surface* surface;
+  };
+
+  bool pop_decoded(size_t budget_left, bool first, Decoded& out);
+
+  mutable std::mutex mutex;
+  std::condition_variable idle_cv;
+  std::unordered_set<std::string> requested;
+  std::deque<Decoded> decoded;
+  size_t in_flight = 0;
+};
+
+template <typename Fn>
+size_t TextureLoader::upload(SDL_Renderer* renderer,
+                             size_t budget_bytes,
+                             Fn&& on_uploaded) {
+  size_t uploaded = 0;
+  size_t spent = 0;
+  Decoded next;
+  while (pop_decoded(spent < budget_bytes ? budget_bytes - spent : 0,
+                     uploaded == 0, next)) {
+    SDL_Texture* texture = nullptr;
+    if (next.surface != nullptr) {
+      spent += static_cast<size_t>(next.surface->pitch) * next.surface->h;
+      texture = SDL_CreateTextureFromSurface(renderer, next.surface);
+      SDL_FreeSurface(next.surface);
+    }
+    on_uploaded(next.name, texture);
+    uploaded++;
+  }
+  return uploaded;
+}
+
+#endif  // PULSAR_SRC_ENGINE_CORE_TEXTURELOADER_H_
@@ -0,0 +1,289 @@
+#include "TriggerBroadphase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "Actor.h"
+#include "ContactListener.h"
+#include "Rigidbody.h"
+#include "RigidbodyPool.h"
+
+TriggerVolume* TriggerBroadphase::acquire() {
+  if (free_volumes.empty() and not reclaimed_this_frame)
+    reclaim();
+  TriggerVolume* volume;
+  if (free_volumes.empty()) {
+    storage.push_back(std::make_unique<TriggerVolume>());
+    volume = storage.back().get();
+  } else {
+    volume = free_volumes.back();
+    free_volumes.pop_back();
+    *volume = TriggerVolume();
+  }
+  live.insert(volume);
+  return volume;
+}
+
+void TriggerBroadphase::release(TriggerVolume* volume) {
+  if (pinned.count(volume) > 0 or live.erase(volume) == 0)
+    return;
+  deactivate(volume);
+  volume->enabled = false;
+  volume->actor = nullptr;
+  volume->released = true;
+  released_this_frame.push_back(volume);
+}
+
+void TriggerBroadphase::release_actor_components(const Actor& actor) {
+  for (const auto& [key, component] : actor.entity_components) {
+    if (component.isInstance<TriggerVolume>())
+      release(component.cast<TriggerVolume*>());
+  }
+}
+
+void TriggerBroadphase::pin_template_components(const Actor& template_actor) {
+  for (const auto& [key, component] : template_actor.entity_components) {
+    if (component.isInstance<TriggerVolume>())
+      pinned.insert(component.cast<TriggerVolume*>());
+  }
+}
+
+void TriggerBroadphase::release_all() {
+  for (TriggerVolume* volume : live) {
+    volume->active_index = -1;
+    volume->enabled = false;
+    volume->actor = nullptr;
+    volume->released = true;
+    released_this_frame.push_back(volume);
+  }
+  live.clear();
+  pinned.clear();
+  active.clear();
+}
+
+void TriggerBroadphase::recycle() {
+  retired.insert(retired.end(), released_this_frame.begin(),
+                 released_this_frame.end());
+  released_this_frame.clear();
+  reclaimed_this_frame = false;
+}
+
+void TriggerBroadphase::track(TriggerVolume* volume,
+                              const luabridge::LuaRef& component) {
+  tracked.track(volume, component);
+}
+
+void TriggerBroadphase::reclaim() {
+  reclaimed_this_frame = true;
+  auto reclaimed = [this](TriggerVolume* volume) {
+    if (tracked.referenced(volume))
+      return false;
+    free_volumes.push_back(volume);
+    return true;
+  };
+  retired.erase(std::remove_if(retired.begin(), retired.end(), reclaimed),
+                retired.end());
+}
+
+void TriggerBroadphase::activate(TriggerVolume* volume) {
+  if (volume->active_index >= 0)
+    return;
+  // a fresh id, so pairs from an earlier life never match again
+  volume->id = next_volume_id++ & ~RIGIDBODY_KEY_BIT;
+  volume->active_index = static_cast<int32_t>(active.size());
+  active.push_back(volume);
+}
+
+void TriggerBroadphase::deactivate(TriggerVolume* volume) {
+  if (volume->active_index < 0)
+    return;
+  // swap remove, its pairs get dropped quietly on the next update
+  TriggerVolume* last = active.back();
+  active[volume->active_index] = last;
+  last->active_index = volume->active_index;
+  active.pop_back();
+  volume->active_index = -1;
+}
+
+void TriggerBroadphase::reset() {
+  release_all();
+  free_volumes.insert(free_volumes.end(), retired.begin(), retired.end());
+  free_volumes.insert(free_volumes.end(), released_this_frame.begin(),
+                      released_this_frame.end());
+  retired.clear();
+  released_this_frame.clear();
+  tracked.forget();
+  touching.clear();
+}
+
+bool TriggerBroadphase::overlaps(const Proxy& a, const Proxy& b) {
+  if (a.radius > 0.0f and b.radius > 0.0f) {
+    const float reach = a.radius + b.radius;
+    return b2DistanceSquared(a.center, b.center) <= reach * reach;
+  }
+  if (a.radius > 0.0f or b.radius > 0.0f) {
+    const Proxy& circle = a.radius > 0.0f ? a : b;
+    const Proxy& box = a.radius > 0.0f ? b : a;
+    const b2Vec2 closest(
+        std::clamp(circle.center.x, box.min_x, box.max_x),
+        std::clamp(circle.center.y, box.min_y, box.max_y));
+    return b2DistanceSquared(circle.center, closest) <=
+           circle.radius * circle.radius;
+  }
+  // two boxes, the AABB test already said yes
+  return true;
+}
+
+uint64_t TriggerBroadphase::pair_key(uint32_t a, uint32_t b) {
+  if (a > b)
+    std::swap(a, b);
+  return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+void TriggerBroadphase::collect_proxies() {
+  proxies.clear();
+  present.clear();
+
+  for (TriggerVolume* volume : active) {
+    present.push_back({volume->id, volume->actor, b2Vec2(0.0f, 0.0f)});
+    if (not volume->enabled or not volume->actor)
+      continue;
+    Proxy proxy{};
+    proxy.center.Set(volume->x, volume->y);
+    float half_width = volume->width * 0.5f;
+    float half_height = volume->height * 0.5f;
+    if (volume->is_circle) {
+      proxy.radius = volume->radius;
+      half_width = half_height = volume->radius;
+    }
+    proxy.min_x = volume->x - half_width;
+    proxy.max_x = volume->x + half_width;
+    proxy.min_y = volume->y - half_height;
+    proxy.max_y = volume->y + half_height;
+    proxy.key = volume->id;
+    proxy.category_bits = volume->category_bits;
+    proxy.mask_bits = volume->mask_bits;
+    proxy.is_volume = true;
+    proxy.actor = volume->actor;
+    proxies.push_back(proxy);
+  }
+
+  RigidbodyPool::getInstance().for_each_live([this](Rigidbody* rigidbody) {
+    if (not rigidbody->actor or not rigidbody->has_trigger or
+        not rigidbody->has_body())
+      return;
+    const uint32_t key =
+        RIGIDBODY_KEY_BIT | static_cast<uint32_t>(rigidbody->actor->_id);
+    present.push_back({key, rigidbody->actor, rigidbody->GetVelocity()});
+
+    Proxy proxy{};
+    proxy.center = rigidbody->GetPosition();
+    float half_width = rigidbody->trigger_width * 0.5f;
+    float half_height = rigidbody->trigger_height * 0.5f;
+    if (rigidbody->trigger_is_circle) {
+      proxy.radius = rigidbody->trigger_radius;
+      half_width = half_height = rigidbody->trigger_radius;
+    } else if (const float angle =
+                   Rigidbody::to_radian(rigidbody->GetRotation());
+               angle != 0.0f) {
+      // rotated boxes are tested by their AABB
+      const float c = std::abs(std::cos(angle));
+      const float s = std::abs(std::sin(angle));
+      const float w = half_width;
+      half_width = c * w + s * half_height;
+      half_height = s * w + c * half_height;
+    }
+    proxy.min_x = proxy.center.x - half_width;
+    proxy.max_x = proxy.center.x + half_width;
+    proxy.min_y = proxy.center.y - half_height;
+    proxy.max_y = proxy.center.y + half_height;
+    proxy.key = key;
+    proxy.category_bits = rigidbody->trigger_category;
+    proxy.mask_bits = rigidbody->trigger_mask;
+    proxy.is_volume = false;
+    proxy.actor = rigidbody->actor;
+    proxies.push_back(proxy);
+  });
+
+  std::sort(present.begin(), present.end(),
+            [](const ProxyInfo& a, const ProxyInfo& b) {
+              return a.key < b.key;
+            });
+}
+
+const TriggerBroadphase::ProxyInfo* TriggerBroadphase::find_present(
+    const uint32_t key) const {
+  const auto it = std::lower_bound(
+      present.begin(), present.end(), key,
+      [](const ProxyInfo& info, uint32_t k) { return info.key < k; });
+  return it != present.end() and it->key == key ? &*it : nullptr;
+}
+
+void TriggerBroadphase::queue_events(const std::vector<uint64_t>& pair_keys,
+                                     EngineUtils::LifeCycle event) {
+  for (const uint64_t pair : pair_keys) {
+    const ProxyInfo* a = find_present(static_cast<uint32_t>(pair >> 32));
+    const ProxyInfo* b = find_present(static_cast<uint32_t>(pair));
+    // one side is gone (destroyed, released), nobody left to tell
+    if (a == nullptr or b == nullptr or not a->actor or not b->actor)
+      continue;
+    const b2Vec2 relative_velocity = a->velocity - b->velocity;
+    events.push_back({event, a->actor, b->actor, relative_velocity});
+    events.push_back({event, b->actor, a->actor, relative_velocity});
+  }
+}
+
+void TriggerBroadphase::update() {
+  // callbacks may add or start volumes, so the events are all found first
+  for (const auto& [event, self, other, relative_velocity] : find_events()) {
+    Contact contact;
+    contact.SetOther(other);
+    contact.SetTriggerContact();
+    contact.SetRelativeVelocity(relative_velocity);
+    ContactListener::LuaOnContactHandle(contact, event, self);
+  }
+}
+
+const std::vector<TriggerBroadphase::Event>& TriggerBroadphase::find_events() {
+  events.clear();
+  if (active.empty() and touching.empty())
+    return events;
+
+  collect_proxies();
+
+  std::sort(proxies.begin(), proxies.end(),
+            [](const Proxy& a, const Proxy& b) { return a.min_x < b.min_x; });
+
+  overlapping.clear();
+  const size_t count = proxies.size();
+  for (size_t i = 0; i < count; i++) {
+    const Proxy& a = proxies[i];
+    for (size_t j = i + 1; j < count and proxies[j].min_x <= a.max_x; j++) {
+      const Proxy& b = proxies[j];
+      if (not a.is_volume and not b.is_volume)
+        continue;
+      if (a.actor == b.actor or a.max_y < b.min_y or b.max_y < a.min_y)
+        continue;
+      if ((a.category_bits & b.mask_bits) == 0 or
+          (b.category_bits & a.mask_bits) == 0)
+        continue;
+      if (overlaps(a, b))
+        overlapping.push_back(pair_key(a.key, b.key));
+    }
+  }
+  std::sort(overlapping.begin(), overlapping.end());
+  overlapping.erase(std::unique(overlapping.begin(), overlapping.end()),
+                    overlapping.end());
+
+  changed.clear();
+  std::set_difference(touching.begin(), touching.end(), overlapping.begin(),
+                      overlapping.end(), std::back_inserter(changed));
+  queue_events(changed, EngineUtils::LifeCycle::OnTriggerExit);
+  changed.clear();
+  std::set_difference(overlapping.begin(), overlapping.end(), touching.begin(),
+                      touching.end(), std::back_inserter(changed));
+  queue_events(changed, EngineUtils::LifeCycle::OnTriggerEnter);
+  touching.swap(overlapping);
+  return events;
+}
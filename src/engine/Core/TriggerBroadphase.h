@@ -0,0 +1,134 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_TRIGGERBROADPHASE_H_
+#define PULSAR_SRC_ENGINE_CORE_TRIGGERBROADPHASE_H_
+
+#include <box2d/box2d.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "ComponentTracker.h"
+#include "EngineUtils.h"
+#include "TriggerVolume.h"
+
+class Actor;
+
+// Owns every TriggerVolume and finds their overlaps with a sweep and prune
+// over x, once per frame. Rigidbody triggers take part as well so a player's
+// trigger can walk into a pickup volume, but Rigidbody vs Rigidbody pairs are
+// left to Box2D. The pairs touching last frame are kept as a sorted vector of
+// packed keys, diffing it with this frame's gives the enter / exit events.
+class TriggerBroadphase {
+  TriggerBroadphase() = default;
+
+ public:
+  TriggerBroadphase(const TriggerBroadphase&) = delete;
+  TriggerBroadphase& operator=(const TriggerBroadphase&) = delete;
+  TriggerBroadphase(TriggerBroadphase&&) = delete;
+  TriggerBroadphase& operator=(TriggerBroadphase&&) = delete;
+
+  static TriggerBroadphase& getInstance() {
+    static TriggerBroadphase instance;
+    return instance;
+  }
+
+  // Component storage, same rules as RigidbodyPool: a released volume is
+  // only handed out again once Lua has collected its component.
+  TriggerVolume* acquire();
+  void track(TriggerVolume* volume, const luabridge::LuaRef& component);
+  void release(TriggerVolume* volume);
+  void release_actor_components(const Actor& actor);
+  void pin_template_components(const Actor& template_actor);
+  void release_all();
+  void recycle();
+
+  // OnStart / OnDestroy
+  void activate(TriggerVolume* volume);
+  void deactivate(TriggerVolume* volume);
+
+  struct Event {
+    EngineUtils::LifeCycle event;
+    Actor* self;
+    Actor* other;
+    b2Vec2 relative_velocity;
+  };
+
+  // Finds this frame's overlaps and runs the Lua callbacks, main thread only.
+  void update();
+  // update without the callbacks: this frame's enter / exit events against
+  // the pairs touching last frame, valid until the next call
+  const std::vector<Event>& find_events();
+  // Before the Lua state closes: releases everything and hands every slot
+  // straight back, nothing can reference them anymore.
+  void reset();
+
+  template <typename Fn>
+  void for_each_active(Fn&& fn) const {
+    for (const TriggerVolume* volume : active)
+      fn(volume);
+  }
+
+  [[nodiscard]] size_t get_volume_count() const { return active.size(); }
+  [[nodiscard]] size_t get_pair_count() const { return touching.size(); }
+  [[nodiscard]] size_t get_retired_count() const { return retired.size(); }
+
+ private:
+  struct Proxy {
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+    b2Vec2 center;
+    float radius;  // 0 for boxes, the AABB is the shape then
+    uint32_t key;
+    uint16 category_bits;
+    uint16 mask_bits;
+    bool is_volume;
+    Actor* actor;
+  };
+
+  struct ProxyInfo {
+    uint32_t key;
+    Actor* actor;
+    b2Vec2 velocity;
+  };
+
+  // volumes use their id, Rigidbody triggers their actor's id with this set
+  static constexpr uint32_t RIGIDBODY_KEY_BIT = 0x80000000u;
+
+  static bool overlaps(const Proxy& a, const Proxy& b);
+  static uint64_t pair_key(uint32_t a, uint32_t b);
+  void collect_proxies();
+  [[nodiscard]] const ProxyInfo* find_present(uint32_t key) const;
+  // moves retired volumes Lua no longer references to free_volumes
+  void reclaim();
+  void queue_events(const std::vector<uint64_t>& pair_keys,
+                    EngineUtils::LifeCycle event);
+
+  std::vector<std::unique_ptr<TriggerVolume>> storage;
+  std::vector<TriggerVolume*> free_volumes;
+  std::vector<TriggerVolume*> released_this_frame;
+  std::vector<TriggerVolume*> retired;
+  ComponentTracker tracked;
+  // volumes come one at a time, so retired is scanned at most once a frame
+  bool reclaimed_this_frame = false;
+  std::unordered_set<TriggerVolume*> live;
+  std::unordered_set<TriggerVolume*> pinned;
+
+  std::vector<TriggerVolume*> active;
+  uint32_t next_volume_id = 1;
+
+  // rebuilt every update, kept around for their capacity
+  std::vector<Proxy> proxies;
+  // sorted by key once collected
+  std::vector<ProxyInfo> present;
+  std::vector<uint64_t> overlapping;
+  std::vector<uint64_t> changed;
+  std::vector<Event> events;
+
+  // sorted
+  std::vector<uint64_t> touching;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_TRIGGERBROADPHASE_H_
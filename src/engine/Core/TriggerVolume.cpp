@@ -0,0 +1,26 @@
+#include "TriggerVolume.h"
+
+#include "PhysicsConfig.h"
+#include "TriggerBroadphase.h"
+
+void TriggerVolume::Initialize() {
+  const auto& config = PhysicsConfig::getInstance();
+  category_bits = config.get_layer_bit(layer);
+  mask_bits = collides_with.empty() ? config.get_layer_mask(layer)
+                                    : config.parse_layer_list(collides_with);
+  is_circle = trigger_type == "circle";
+  TriggerBroadphase::getInstance().activate(this);
+}
+
+void TriggerVolume::Destroy() {
+  TriggerBroadphase::getInstance().deactivate(this);
+}
+
+void TriggerVolume::SetPosition(const b2Vec2& pos) {
+  x = pos.x;
+  y = pos.y;
+}
+
+b2Vec2 TriggerVolume::GetPosition() const {
+  return {x, y};
+}
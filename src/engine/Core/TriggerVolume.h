@@ -0,0 +1,51 @@
+#ifndef PULSAR_SRC_ENGINE_CORE_TRIGGERVOLUME_H_
+#define PULSAR_SRC_ENGINE_CORE_TRIGGERVOLUME_H_
+
+#include <box2d/box2d.h>
+#include <cstdint>
+#include <string>
+
+class Actor;
+
+// Box or circle area that raises OnTriggerEnter / OnTriggerExit without a
+// Box2D body. Overlaps against other volumes and Rigidbody triggers are found
+// by TriggerBroadphase once per frame. Volumes don't follow anything, scripts
+// move them with SetPosition.
+class TriggerVolume {
+ public:
+  void Initialize();
+  void Destroy();
+
+  void SetPosition(const b2Vec2& pos);
+  [[nodiscard]] b2Vec2 GetPosition() const;
+
+  float x = 0.0f;
+  float y = 0.0f;
+  std::string trigger_type = "box";
+  float width = 1.0f;
+  float height = 1.0f;
+  float radius = 0.5f;
+
+  // same meaning as on Rigidbody, see PhysicsConfig
+  std::string layer = "default";
+  std::string collides_with;
+
+  std::string type = "TriggerVolume";
+  std::string key = "???";
+  Actor* actor = nullptr;
+  bool enabled = true;
+  // set once its actor is gone, the slot waits for Lua to let go of it
+  bool released = false;
+
+ private:
+  friend class TriggerBroadphase;
+
+  // set by TriggerBroadphase when the volume starts
+  uint32_t id = 0;
+  int32_t active_index = -1;
+  uint16 category_bits = 0;
+  uint16 mask_bits = 0;
+  bool is_circle = false;
+};
+
+#endif  // PULSAR_SRC_ENGINE_CORE_TRIGGERVOLUME_H_
@@ -4,6 +4,8 @@
 
 #include "UI.h"
 #include "Core/Engine.h"
+#include "Core/FramePacer.h"
+#include "Core/PhysicsDebugDraw.h"
 #include "Core/ResourceManager.h"
 #include "Core/SceneManager.h"
 
@@ -84,6 +86,52 @@ void UI::drawToolbar() {
   if (m_show_demo_panel) {
     ImGui::ShowDemoWindow(&m_show_demo_panel);
   }
+  if (m_show_debug_panel) {
+    drawDebugPanel();
+  }
+}
+
+void UI::drawDebugPanel() {
+  ImGui::Begin("Debug", &m_show_debug_panel);
+  if (ImGui::CollapsingHeader("Physics Debug Draw",
+                              ImGuiTreeNodeFlags_DefaultOpen)) {
+    auto& debug_draw = PhysicsDebugDraw::getInstance();
+    ImGui::Checkbox("Shapes", &debug_draw.draw_shapes);
+    ImGui::Checkbox("AABBs", &debug_draw.draw_aabbs);
+    ImGui::Checkbox("Joints", &debug_draw.draw_joints);
+    ImGui::Checkbox("Contacts", &debug_draw.draw_contacts);
+    ImGui::Checkbox("Centers of Mass", &debug_draw.draw_centers);
+    ImGui::Text("%zu vertices, %zu draw calls",
+                debug_draw.get_vertex_count(), debug_draw.get_draw_calls());
+  }
+  if (ImGui::CollapsingHeader("Rendering", ImGuiTreeNodeFlags_DefaultOpen)) {
+    const auto& stats = Renderer::getInstance().get_render_stats();
+    ImGui::Text("%zu draws, %zu culled", stats.draws, stats.culled);
+    ImGui::Text("%zu sprites, %zu draw calls", stats.sprites,
+                stats.draw_calls);
+    ImGui::Text("%zu textures, %.1f MB", stats.textures_resident,
+                static_cast<double>(stats.texture_bytes) / (1024.0 * 1024.0));
+    ImGui::Text("%zu layers cached, %zu redrawn", stats.layers_cached,
+                stats.layers_redrawn);
+  }
+  if (ImGui::CollapsingHeader("Frame Pacing", ImGuiTreeNodeFlags_DefaultOpen)) {
+    auto& pacer = FramePacer::getInstance();
+    const auto summary = pacer.get_summary();
+    if (pacer.is_yielding_to_vsync())
+      ImGui::Text("vsync, %d Hz", pacer.get_refresh_rate());
+    else
+      ImGui::Text("target %d fps", pacer.get_target_rate());
+    ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", summary.p50,
+                summary.p95, summary.p99, summary.max);
+    static std::vector<float> frame_times;
+    frame_times.clear();
+    pacer.for_each_sample(
+        [](float frame_ms) { frame_times.push_back(frame_ms); });
+    ImGui::PlotLines("##frame_times", frame_times.data(),
+                     static_cast<int>(frame_times.size()), 0, nullptr, 0.0f,
+                     static_cast<float>(summary.p99 * 1.5), ImVec2(0, 60));
+  }
+  ImGui::End();
 }
 
 void UI::drawSceneEditorPane() {
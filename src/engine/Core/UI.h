@@ -28,6 +28,7 @@ class UI {
   void drawCenterPane();
   void drawPlaybackControls();
   void drawEditorPane();
+  void drawDebugPanel();
 
   void onQuitEvent();
 
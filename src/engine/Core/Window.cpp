@@ -11,6 +11,16 @@ namespace App {
 Window::Window(const Settings& settings) {
   APP_PROFILE_FUNCTION();
 
+  if (settings.is_headless) {
+    m_surface = SDL_CreateRGBSurfaceWithFormat(0, settings.width, settings.height,
+                                               32, SDL_PIXELFORMAT_ARGB8888);
+    if (m_surface != nullptr)
+      m_renderer = SDL_CreateSoftwareRenderer(m_surface);
+    if (m_renderer == nullptr)
+      APP_ERROR("Error creating headless SDL_Renderer: {}", SDL_GetError());
+    return;
+  }
+
   const auto window_flags{
       static_cast<SDL_WindowFlags>(SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI |
                                    (settings.is_hidden ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN))};
@@ -44,7 +54,10 @@ Window::~Window() {
   APP_PROFILE_FUNCTION();
 
   SDL_DestroyRenderer(m_renderer);
-  SDL_DestroyWindow(m_window);
+  if (m_window != nullptr)
+    SDL_DestroyWindow(m_window);
+  if (m_surface != nullptr)
+    SDL_FreeSurface(m_surface);
 }
 
 SDL_Window* Window::get_native_window() const {
@@ -13,6 +13,8 @@ class Window {
     int width{1280};
     int height{720};
     bool is_hidden{false};
+    // no window, a software renderer drawing into an offscreen surface
+    bool is_headless{false};
   };
 
   explicit Window(const Settings& settings);
@@ -40,6 +42,7 @@ class Window {
  private:
   SDL_Window* m_window{nullptr};
   SDL_Renderer* m_renderer{nullptr};
+  SDL_Surface* m_surface{nullptr};
 
   Uint32 m_ID{0};
   bool m_MouseFocus{false};
@@ -0,0 +1,17 @@
+#ifndef PULSAR_SRC_ENGINE_TESTS_FAKEACTOR_H_
+#define PULSAR_SRC_ENGINE_TESTS_FAKEACTOR_H_
+
+#include <array>
+#include <cstddef>
+
+class Actor;
+
+// Stand-in actors for specs that only store or compare the pointer, like
+// FakeTexture.h. Same id, same address; each is a distinct byte of real
+// storage, so none is null and nothing ever dereferences them.
+inline Actor* fake_actor(size_t id) {
+  static std::array<std::byte, 1024> storage{};
+  return reinterpret_cast<Actor*>(&storage.at(id));
+}
+
+#endif  // PULSAR_SRC_ENGINE_TESTS_FAKEACTOR_H_
@@ -0,0 +1,16 @@
+#ifndef PULSAR_SRC_ENGINE_TESTS_FAKETEXTURE_H_
+#define PULSAR_SRC_ENGINE_TESTS_FAKETEXTURE_H_
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstddef>
+
+// Stand-in textures for specs that only compare or hand back the pointer.
+// Same id, same address; each is a distinct byte of real storage, so none
+// is null and nothing ever dereferences them.
+inline SDL_Texture* fake_texture(size_t id) {
+  static std::array<std::byte, 64> storage{};
+  return reinterpret_cast<SDL_Texture*>(&storage.at(id));
+}
+
+#endif  // PULSAR_SRC_ENGINE_TESTS_FAKETEXTURE_H_
@@ -0,0 +1,147 @@
+#include <doctest/doctest.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Core/FrameCapture.h"
+#include "Core/QoiEncoder.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+uint32_t read_u32(const std::vector<uint8_t>& data, size_t at) {
+  return static_cast<uint32_t>(data[at]) << 24 | data[at + 1] << 16 |
+         data[at + 2] << 8 | data[at + 3];
+}
+
+// straight from the spec, only here to check the encoder against
+std::vector<uint8_t> decode(const std::vector<uint8_t>& data) {
+  const uint32_t width = read_u32(data, 4);
+  const uint32_t height = read_u32(data, 8);
+  std::vector<uint8_t> out;
+  std::array<std::array<uint8_t, 4>, 64> index{};
+  std::array<uint8_t, 4> px = {0, 0, 0, 255};
+  size_t at = 14;
+  int run = 0;
+  for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+    if (run > 0) {
+      run--;
+    } else {
+      const uint8_t b1 = data[at++];
+      if (b1 == 0xFE) {
+        px[0] = data[at++];
+        px[1] = data[at++];
+        px[2] = data[at++];
+      } else if (b1 == 0xFF) {
+        for (auto& channel : px)
+          channel = data[at++];
+      } else if ((b1 & 0xC0) == 0x00) {
+        px = index[b1];
+      } else if ((b1 & 0xC0) == 0x40) {
+        px[0] += ((b1 >> 4) & 3) - 2;
+        px[1] += ((b1 >> 2) & 3) - 2;
+        px[2] += (b1 & 3) - 2;
+      } else if ((b1 & 0xC0) == 0x80) {
+        const uint8_t b2 = data[at++];
+        const int vg = (b1 & 0x3F) - 32;
+        px[0] += vg - 8 + ((b2 >> 4) & 0x0F);
+        px[1] += vg;
+        px[2] += vg - 8 + (b2 & 0x0F);
+      } else {
+        run = b1 & 0x3F;
+      }
+      index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64] = px;
+    }
+    out.insert(out.end(), px.begin(), px.end());
+  }
+  return out;
+}
+
+std::vector<uint8_t> gradient(int width, int height) {
+  std::vector<uint8_t> pixels;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      // flat runs, small steps, big jumps and alpha changes
+      const auto r = static_cast<uint8_t>(x < 20 ? 10 : x * 3);
+      const auto g = static_cast<uint8_t>(y * 7 + x);
+      const auto b = static_cast<uint8_t>((x * y) % 251);
+      const auto a = static_cast<uint8_t>(x % 17 == 0 ? 128 : 255);
+      pixels.insert(pixels.end(), {r, g, b, a});
+    }
+  }
+  return pixels;
+}
+}  // namespace
+
+TEST_SUITE("Core::FrameCapture") {
+  TEST_CASE("QOI output decodes back to the same pixels") {
+    const int width = 97;
+    const int height = 13;
+    const auto pixels = gradient(width, height);
+    const auto encoded = Qoi::encode(pixels.data(), width, height, width * 4);
+
+    REQUIRE(encoded.size() > 22);
+    CHECK(encoded[0] == 'q');
+    CHECK(encoded[3] == 'f');
+    CHECK(read_u32(encoded, 4) == width);
+    CHECK(read_u32(encoded, 8) == height);
+    CHECK(encoded.back() == 1);
+    CHECK(decode(encoded) == pixels);
+  }
+
+  TEST_CASE("QOI respects the row pitch") {
+    const int width = 5;
+    const int height = 3;
+    const auto tight = gradient(width, height);
+    std::vector<uint8_t> padded;
+    for (int y = 0; y < height; y++) {
+      padded.insert(padded.end(), tight.begin() + y * width * 4,
+                    tight.begin() + (y + 1) * width * 4);
+      padded.insert(padded.end(), 12, 0xAB);
+    }
+    CHECK(Qoi::encode(padded.data(), width, height, width * 4 + 12) ==
+          Qoi::encode(tight.data(), width, height, width * 4));
+  }
+
+  TEST_CASE("A flat frame is a handful of run bytes") {
+    const std::vector<uint8_t> black(64 * 64 * 4, 0);
+    std::vector<uint8_t> opaque = black;
+    for (size_t i = 3; i < opaque.size(); i += 4)
+      opaque[i] = 255;
+    const auto encoded = Qoi::encode(opaque.data(), 64, 64, 64 * 4);
+    // 4096 pixels in runs of 62
+    CHECK(encoded.size() == 14 + 67 + 8);
+    CHECK(decode(encoded) == opaque);
+  }
+
+  TEST_CASE("Frames are picked by range and stride") {
+    FrameCapture::Settings settings;
+    settings.first_frame = 10;
+    settings.last_frame = 20;
+    settings.every = 5;
+    std::vector<int> picked;
+    for (int frame = 0; frame < 30; frame++)
+      if (FrameCapture::selects(settings, frame))
+        picked.push_back(frame);
+    const std::vector<int> expected = {10, 15, 20};
+    CHECK(picked == expected);
+
+    settings.last_frame = -1;
+    CHECK(FrameCapture::selects(settings, 1000));
+    CHECK(not FrameCapture::selects(settings, 1001));
+  }
+
+  TEST_CASE("File names keep the autograder's pattern") {
+    CHECK(FrameCapture::file_name(42, FrameCapture::Format::BMP) ==
+          "frame_00042.bmp");
+    CHECK(FrameCapture::file_name(7, FrameCapture::Format::QOI) ==
+          "frame_00007.qoi");
+    FrameCapture::Format format = FrameCapture::Format::BMP;
+    CHECK(FrameCapture::parse_format("png", format));
+    CHECK(format == FrameCapture::Format::PNG);
+    CHECK(not FrameCapture::parse_format("gif", format));
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,73 @@
+#include <doctest/doctest.h>
+
+#include <vector>
+
+#include "Core/FrameTimeHistogram.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+TEST_SUITE("Core::FrameTimeHistogram") {
+  TEST_CASE("An empty histogram summarizes to zeros") {
+    FrameTimeHistogram histogram;
+    const auto summary = histogram.summarize();
+    CHECK(summary.samples == 0);
+    CHECK(summary.p99 == 0.0);
+    CHECK(summary.max == 0.0);
+  }
+
+  TEST_CASE("Percentiles come from the bucket holding the ranked sample") {
+    FrameTimeHistogram histogram;
+    // 98 smooth frames and two hitches
+    for (int i = 0; i < 98; i++)
+      histogram.add(16.65);
+    histogram.add(33.35);
+    histogram.add(50.0);
+
+    const auto summary = histogram.summarize();
+    CHECK(summary.samples == 100);
+    CHECK(summary.p50 == doctest::Approx(16.7));
+    CHECK(summary.p95 == doctest::Approx(16.7));
+    CHECK(summary.p99 == doctest::Approx(33.4));
+    CHECK(summary.max == doctest::Approx(50.0));
+    CHECK(summary.mean == doctest::Approx((98 * 16.65 + 33.35 + 50.0) / 100));
+  }
+
+  TEST_CASE("Long frames land in the last bucket but keep their max") {
+    FrameTimeHistogram histogram;
+    histogram.add(250.0);
+    CHECK(histogram.percentile(0.5) == doctest::Approx(100.0));
+    CHECK(histogram.max() == doctest::Approx(250.0));
+  }
+
+  TEST_CASE("Only the last WINDOW frames are kept") {
+    FrameTimeHistogram histogram;
+    histogram.add(80.0);
+    for (size_t i = 0; i < FrameTimeHistogram::WINDOW; i++)
+      histogram.add(10.0);
+
+    CHECK(histogram.size() == FrameTimeHistogram::WINDOW);
+    CHECK(histogram.max() == doctest::Approx(10.0));
+    CHECK(histogram.percentile(1.0) == doctest::Approx(10.0));
+    CHECK(histogram.summarize().mean == doctest::Approx(10.0));
+  }
+
+  TEST_CASE("Samples are visited oldest first") {
+    FrameTimeHistogram histogram;
+    for (size_t i = 0; i < FrameTimeHistogram::WINDOW + 2; i++)
+      histogram.add(static_cast<double>(i));
+
+    std::vector<float> visited;
+    histogram.for_each_sample([&visited](float sample) {
+      visited.push_back(sample);
+    });
+    REQUIRE(visited.size() == FrameTimeHistogram::WINDOW);
+    CHECK(visited.front() == doctest::Approx(2.0));
+    CHECK(visited.back() ==
+          doctest::Approx(static_cast<double>(FrameTimeHistogram::WINDOW + 1)));
+
+    histogram.clear();
+    CHECK(histogram.size() == 0);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
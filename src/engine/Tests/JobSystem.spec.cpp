@@ -0,0 +1,105 @@
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core/JobSystem.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+// Parks every worker until release(), so nothing else can pick up jobs.
+class BusyWorkers {
+ public:
+  explicit BusyWorkers(JobSystem& jobs)
+      : worker_count(jobs.get_worker_count()) {
+    for (size_t i = 0; i < worker_count; i++) {
+      jobs.submit([this] {
+        std::unique_lock lock(mutex);
+        parked++;
+        cv.notify_all();
+        cv.wait(lock, [this] { return released; });
+        parked--;
+        cv.notify_all();
+      });
+    }
+    std::unique_lock lock(mutex);
+    cv.wait(lock, [this] { return parked == worker_count; });
+  }
+  ~BusyWorkers() {
+    std::unique_lock lock(mutex);
+    released = true;
+    cv.notify_all();
+    // the jobs reference us, wait for them to leave
+    cv.wait(lock, [this] { return parked == 0; });
+  }
+  BusyWorkers(const BusyWorkers&) = delete;
+  BusyWorkers& operator=(const BusyWorkers&) = delete;
+
+ private:
+  const size_t worker_count;
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t parked = 0;
+  bool released = false;
+};
+}  // namespace
+
+TEST_SUITE("Core::JobSystem") {
+  TEST_CASE("Every index is visited exactly once") {
+    JobSystem& jobs = JobSystem::getInstance();
+    for (const size_t count : {1, 7, 64, 1000, 4097}) {
+      for (const size_t min_batch : {0, 1, 16, 5000}) {
+        std::vector<std::atomic<int>> visits(count);
+        jobs.parallel_for(count, min_batch, [&](size_t begin, size_t end) {
+          CHECK(begin < end);
+          for (size_t i = begin; i < end; i++)
+            visits[i]++;
+        });
+        size_t wrong = 0;
+        for (const auto& visit : visits)
+          wrong += visit != 1 ? 1 : 0;
+        CHECK_EQ(wrong, 0);
+      }
+    }
+    size_t empty_calls = 0;
+    jobs.parallel_for(0, 1, [&](size_t, size_t) { empty_calls++; });
+    CHECK_EQ(empty_calls, 0);
+  }
+
+  TEST_CASE("The caller finishes alone when every worker is busy") {
+    JobSystem& jobs = JobSystem::getInstance();
+    const BusyWorkers busy(jobs);
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic<size_t> visited{0};
+    std::atomic<size_t> elsewhere{0};
+    // the helpers are still queued behind the parked jobs when this returns
+    jobs.parallel_for(4096, 1, [&](size_t begin, size_t end) {
+      visited += end - begin;
+      if (std::this_thread::get_id() != caller)
+        elsewhere++;
+    });
+    CHECK_EQ(visited.load(), 4096);
+    CHECK_EQ(elsewhere.load(), 0);
+  }
+
+  TEST_CASE("Late helpers don't run anything") {
+    JobSystem& jobs = JobSystem::getInstance();
+    std::atomic<size_t> calls{0};
+    {
+      const BusyWorkers busy(jobs);
+      jobs.parallel_for(64, 1, [&](size_t, size_t) { calls++; });
+    }
+    const size_t after_return = calls.load();
+    {
+      // every worker parked again means the queued helpers have finished
+      const BusyWorkers drained(jobs);
+    }
+    CHECK_EQ(calls.load(), after_return);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
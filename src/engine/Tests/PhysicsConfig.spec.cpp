@@ -0,0 +1,148 @@
+#include <doctest/doctest.h>
+#include <string>
+
+#include <rapidjson/document.h>
+
+#include "Core/PhysicsConfig.h"
+#include "Core/PhysicsQuery.h"
+#include "Core/Rigidbody.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+PhysicsConfig& load_config(const char* json) {
+  rapidjson::Document document;
+  document.Parse(json);
+  auto& config = PhysicsConfig::getInstance();
+  config.reset();
+  config.load(document);
+  return config;
+}
+
+uint16 bit_of(const PhysicsConfig& config, const std::string& name) {
+  uint16 bit = 0;
+  CHECK(config.find_layer_bit(name, bit));
+  return bit;
+}
+
+// what Box2D decides for two colliders: both masks have to allow the pair
+bool collides(const PhysicsConfig& config,
+              const std::string& a,
+              const std::string& b) {
+  return (config.get_layer_mask(a) & bit_of(config, b)) != 0 and
+         (config.get_layer_mask(b) & bit_of(config, a)) != 0;
+}
+
+const char* const LAYERED_CONFIG = R"({
+  "layers": ["player", "enemy", "bullet", "player", 7],
+  "collision_matrix": { "bullet": ["player", "enemy"] }
+})";
+}  // namespace
+
+TEST_SUITE("Core::PhysicsConfig") {
+  TEST_CASE("Category layout keeps colliders low and triggers high") {
+    CHECK_EQ(Rigidbody::CATEGORY_COLLIDER, 0x00FF);
+    CHECK_EQ(Rigidbody::CATEGORY_TRIGGER, 0xFF00);
+    CHECK_EQ(Rigidbody::CATEGORY_TRIGGER, Rigidbody::CATEGORY_COLLIDER << 8);
+    CHECK_EQ(Rigidbody::CATEGORY_PHANTOM, 0);
+    CHECK_EQ(PhysicsQuery::DEFAULT_QUERY_MASK, 0xFFFF);
+  }
+
+  TEST_CASE("Missing layers keep only default, colliding with everything") {
+    const auto& config = load_config("{}");
+    REQUIRE_EQ(config.layers.size(), 1);
+    CHECK_EQ(config.layers[0], "default");
+    CHECK_EQ(bit_of(config, "default"), 1);
+    CHECK_EQ(config.get_layer_mask("default"), 0x00FF);
+  }
+
+  TEST_CASE("Layers skip duplicates and non-strings") {
+    const auto& config = load_config(LAYERED_CONFIG);
+    REQUIRE_EQ(config.layers.size(), 4);
+    CHECK_EQ(bit_of(config, "default"), 1 << 0);
+    CHECK_EQ(bit_of(config, "player"), 1 << 1);
+    CHECK_EQ(bit_of(config, "enemy"), 1 << 2);
+    CHECK_EQ(bit_of(config, "bullet"), 1 << 3);
+  }
+
+  TEST_CASE("Unknown layers are not found") {
+    const auto& config = load_config(LAYERED_CONFIG);
+    uint16 bit = 0xBEEF;
+    CHECK_FALSE(config.find_layer_bit("wall", bit));
+    CHECK_FALSE(config.find_layer_bit("", bit));
+    CHECK_FALSE(config.find_layer_bit("Player", bit));
+    CHECK_EQ(bit, 0xBEEF);
+  }
+
+  TEST_CASE("The collision matrix is symmetric") {
+    const auto& config = load_config(LAYERED_CONFIG);
+    CHECK_EQ(config.get_layer_mask("bullet"),
+             bit_of(config, "player") | bit_of(config, "enemy"));
+    CHECK_EQ(config.get_layer_mask("player"), 0x00FF);
+
+    for (const auto& a : config.layers) {
+      for (const auto& b : config.layers)
+        CHECK_EQ(collides(config, a, b), collides(config, b, a));
+    }
+    CHECK(collides(config, "bullet", "player"));
+    CHECK(collides(config, "enemy", "bullet"));
+    CHECK(not collides(config, "bullet", "bullet"));
+    CHECK(not collides(config, "default", "bullet"));
+    CHECK(collides(config, "player", "enemy"));
+  }
+
+  TEST_CASE("A matrix entry without a list collides with nothing") {
+    const auto& config = load_config(R"({
+      "layers": ["ghost"],
+      "collision_matrix": { "ghost": null }
+    })");
+    CHECK_EQ(config.get_layer_mask("ghost"), 0);
+    CHECK(not collides(config, "ghost", "default"));
+  }
+
+  TEST_CASE("Layer lists trim names and ignore empty entries") {
+    const auto& config = load_config(LAYERED_CONFIG);
+    CHECK_EQ(config.parse_layer_list(""), 0);
+    CHECK_EQ(config.parse_layer_list(" , "), 0);
+    CHECK_EQ(config.parse_layer_list("player, enemy"),
+             bit_of(config, "player") | bit_of(config, "enemy"));
+    CHECK_EQ(config.parse_layer_list("\tbullet ,"), bit_of(config, "bullet"));
+  }
+
+  TEST_CASE("resolve_mask on nil, number, string and table") {
+    const auto& config = load_config(LAYERED_CONFIG);
+    lua_State* L = luaL_newstate();
+    const uint16 player = bit_of(config, "player");
+    const uint16 enemy = bit_of(config, "enemy");
+
+    {
+      const luabridge::LuaRef nil(L);
+      CHECK_EQ(PhysicsQuery::resolve_mask(nil),
+               PhysicsQuery::DEFAULT_QUERY_MASK);
+
+      // raw bits pass through untouched, collider byte only here
+      const luabridge::LuaRef number(L, 0x0006);
+      CHECK_EQ(PhysicsQuery::resolve_mask(number), 0x0006);
+
+      // names cover both the collider and the trigger side of the layer
+      const luabridge::LuaRef name(L, std::string("player"));
+      CHECK_EQ(PhysicsQuery::resolve_mask(name), player | (player << 8));
+
+      const luabridge::LuaRef list(L, std::string("player, enemy"));
+      CHECK_EQ(PhysicsQuery::resolve_mask(list),
+               (player | enemy) | ((player | enemy) << 8));
+
+      luabridge::LuaRef table = luabridge::newTable(L);
+      table[1] = std::string("enemy");
+      table[2] = std::string("player");
+      CHECK_EQ(PhysicsQuery::resolve_mask(table),
+               (player | enemy) | ((player | enemy) << 8));
+
+      const luabridge::LuaRef empty = luabridge::newTable(L);
+      CHECK_EQ(PhysicsQuery::resolve_mask(empty), 0);
+    }
+    lua_close(L);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,78 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+
+#include "Core/PixelLayer.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+// what SDL_BLENDMODE_BLEND did per pixel, premultiplied and rounded the same
+uint32_t reference_over(uint32_t dst, SDL_Color src) {
+  const uint32_t channels[4] = {src.r, src.g, src.b, 255};
+  uint32_t out = 0;
+  for (int i = 0; i < 4; i++) {
+    const uint32_t premultiplied = (channels[i] * src.a + 127) / 255;
+    const uint32_t d = (dst >> (8 * i)) & 0xFF;
+    out |= (premultiplied + (d * (255u - src.a) + 127) / 255) << (8 * i);
+  }
+  return out;
+}
+}  // namespace
+
+TEST_SUITE("Core::PixelLayer") {
+  TEST_CASE("Opaque draws overwrite, transparent ones are dropped") {
+    PixelLayer layer;
+    layer.resize(4, 4);
+    layer.draw(1, 2, {10, 20, 30, 255});
+    layer.draw(1, 2, {0, 0, 0, 0});
+    CHECK(layer.get_row(2)[1] == PixelLayer::pack({10, 20, 30, 255}));
+    CHECK(layer.get_drawn_count() == 1);
+  }
+
+  TEST_CASE("Blending matches per channel over, within rounding") {
+    const uint32_t dst = PixelLayer::pack({200, 100, 50, 255});
+    const SDL_Color src = {30, 240, 128, 77};
+    const uint32_t blended =
+        PixelLayer::blend(dst, PixelLayer::premultiply(src));
+    const uint32_t expected = reference_over(dst, src);
+    for (int shift = 0; shift < 32; shift += 8) {
+      const int a = static_cast<int>((blended >> shift) & 0xFF);
+      const int b = static_cast<int>((expected >> shift) & 0xFF);
+      CHECK(a - b <= 1);
+      CHECK(b - a <= 1);
+    }
+  }
+
+  TEST_CASE("Blending onto nothing leaves the premultiplied source") {
+    const SDL_Color src = {255, 128, 0, 128};
+    CHECK(PixelLayer::blend(0, PixelLayer::premultiply(src)) ==
+          PixelLayer::premultiply(src));
+    const SDL_Color half_yellow = {255, 255, 0, 128};
+    CHECK(PixelLayer::unpremultiply(PixelLayer::premultiply(half_yellow)) ==
+          PixelLayer::pack(half_yellow));
+  }
+
+  TEST_CASE("Only the drawn rect is tracked and cleared") {
+    PixelLayer layer;
+    layer.resize(8, 8);
+    CHECK(layer.empty());
+    layer.draw(2, 3, {1, 1, 1, 255});
+    layer.draw(5, 1, {1, 1, 1, 255});
+    layer.draw(-1, 4, {1, 1, 1, 255});
+    layer.draw(8, 0, {1, 1, 1, 255});
+    const SDL_Rect dirty = layer.get_dirty_rect();
+    CHECK(dirty.x == 2);
+    CHECK(dirty.y == 1);
+    CHECK(dirty.w == 4);
+    CHECK(dirty.h == 3);
+    CHECK(layer.get_drawn_count() == 2);
+
+    layer.clear();
+    CHECK(layer.empty());
+    CHECK(layer.get_row(3)[2] == 0u);
+    CHECK(layer.get_row(1)[5] == 0u);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,153 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+
+#include "Core/RenderLayer.h"
+#include "FakeTexture.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+using Action = LayerCache::Action;
+using Mode = RenderLayer::Mode;
+
+LayerCache::Submission scene(uint64_t content, float camera_x = 0.0f) {
+  LayerCache::Submission submission;
+  submission.content = content;
+  submission.empty = false;
+  submission.has_scene = true;
+  submission.view = {camera_x, 0.0f, 1.0f};
+  return submission;
+}
+
+LayerCache::Submission nothing() {
+  return {};
+}
+}  // namespace
+
+TEST_SUITE("Core::RenderLayer") {
+  TEST_CASE("Dynamic layers are always drawn straight") {
+    LayerCache cache;
+    CHECK(cache.decide(Mode::DYNAMIC, scene(1), 1.0f, 1.0f) == Action::DRAW);
+    CHECK(cache.decide(Mode::DYNAMIC, nothing(), 1.0f, 1.0f) == Action::SKIP);
+  }
+
+  TEST_CASE("Static layers are drawn once and then composited") {
+    LayerCache cache;
+    CHECK(cache.decide(Mode::STATIC, scene(1), 1.0f, 1.0f) == Action::REDRAW);
+    cache.store(scene(1));
+    // different draws don't matter, nor does drawing nothing at all
+    CHECK(cache.decide(Mode::STATIC, scene(2), 1.0f, 1.0f) ==
+          Action::COMPOSITE);
+    CHECK(cache.decide(Mode::STATIC, nothing(), 1.0f, 1.0f) ==
+          Action::COMPOSITE);
+
+    auto invalidated = scene(2);
+    invalidated.generation = 1;
+    CHECK(cache.decide(Mode::STATIC, invalidated, 1.0f, 1.0f) ==
+          Action::REDRAW);
+    auto invalidated_empty = nothing();
+    invalidated_empty.generation = 1;
+    CHECK(cache.decide(Mode::STATIC, invalidated_empty, 1.0f, 1.0f) ==
+          Action::SKIP);
+  }
+
+  TEST_CASE("Static layers scrolled past the margin wait for a redraw") {
+    LayerCache cache;
+    cache.store(scene(1, 0.0f));
+    auto scrolled = nothing();
+    scrolled.view = {0.5f, 0.0f, 1.0f};
+    CHECK(cache.decide(Mode::STATIC, scrolled, 1.0f, 1.0f) ==
+          Action::COMPOSITE);
+    scrolled.view.x = 1.5f;
+    CHECK(cache.decide(Mode::STATIC, scrolled, 1.0f, 1.0f) == Action::SKIP);
+    CHECK(not cache.is_valid());
+    // even back in range the texture is gone
+    scrolled.view.x = 0.0f;
+    CHECK(cache.decide(Mode::STATIC, scrolled, 1.0f, 1.0f) == Action::SKIP);
+    CHECK(cache.decide(Mode::STATIC, scene(1, 1.5f), 1.0f, 1.0f) ==
+          Action::REDRAW);
+  }
+
+  TEST_CASE("On change layers are drawn again when their draws differ") {
+    LayerCache cache;
+    cache.store(scene(1));
+    CHECK(cache.decide(Mode::ON_CHANGE, scene(1), 1.0f, 1.0f) ==
+          Action::COMPOSITE);
+    CHECK(cache.decide(Mode::ON_CHANGE, scene(2), 1.0f, 1.0f) ==
+          Action::REDRAW);
+    // hidden this frame
+    CHECK(cache.decide(Mode::ON_CHANGE, nothing(), 1.0f, 1.0f) ==
+          Action::SKIP);
+  }
+
+  TEST_CASE("Scrolling past the margin draws the texture again") {
+    LayerCache cache;
+    cache.store(scene(1, 0.0f));
+    CHECK(cache.decide(Mode::ON_CHANGE, scene(1, 0.5f), 1.0f, 1.0f) ==
+          Action::COMPOSITE);
+    CHECK(cache.decide(Mode::ON_CHANGE, scene(1, 1.5f), 1.0f, 1.0f) ==
+          Action::REDRAW);
+    auto zoomed = scene(1);
+    zoomed.view.zoom = 2.0f;
+    CHECK(cache.decide(Mode::STATIC, zoomed, 1.0f, 1.0f) == Action::REDRAW);
+
+    const SDL_FPoint drift = cache.drift({0.5f, -0.25f, 2.0f}, 100.0f);
+    CHECK(drift.x == doctest::Approx(-100.0));
+    CHECK(drift.y == doctest::Approx(50.0));
+  }
+
+  TEST_CASE("UI only layers ignore the camera, mixed ones can't scroll") {
+    LayerCache cache;
+    auto panel = nothing();
+    panel.empty = false;
+    panel.has_ui = true;
+    cache.store(panel);
+    panel.view = {40.0f, 12.0f, 3.0f};
+    CHECK(cache.decide(Mode::STATIC, panel, 0.0f, 0.0f) == Action::COMPOSITE);
+    CHECK(cache.drift(panel.view, 100.0f).x == doctest::Approx(0.0));
+
+    auto mixed = scene(1);
+    mixed.has_ui = true;
+    cache.store(mixed);
+    mixed.view.x = 0.01f;
+    CHECK(cache.decide(Mode::STATIC, mixed, 1.0f, 1.0f) == Action::REDRAW);
+  }
+
+  TEST_CASE("Layers with images still loading aren't cached") {
+    LayerCache cache;
+    auto loading = scene(1);
+    loading.complete = false;
+    CHECK(cache.decide(Mode::STATIC, loading, 1.0f, 1.0f) == Action::DRAW);
+
+    RenderQueue queue;
+    RenderCommand missing{};
+    missing.type = IMGType::UI;
+    queue.push(missing, 0);
+    RenderCommand loaded{};
+    loaded.type = IMGType::Scene;
+    loaded.texture = fake_texture(1);
+    queue.push(loaded, 0);
+    const auto described =
+        LayerCache::describe(queue, Mode::ON_CHANGE, 3, {});
+    CHECK(not described.empty);
+    CHECK(described.has_scene);
+    CHECK(described.has_ui);
+    CHECK(not described.complete);
+    CHECK(described.generation == 3);
+    CHECK(described.content == queue.content_hash());
+    // only on change layers pay for the hash
+    CHECK(LayerCache::describe(queue, Mode::STATIC, 3, {}).content == 0);
+  }
+
+  TEST_CASE("Modes parse from their Lua names") {
+    Mode mode = Mode::DYNAMIC;
+    CHECK(RenderLayer::parse_mode("on_change", mode));
+    CHECK(mode == Mode::ON_CHANGE);
+    CHECK(RenderLayer::parse_mode("static", mode));
+    CHECK(mode == Mode::STATIC);
+    CHECK(not RenderLayer::parse_mode("sometimes", mode));
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
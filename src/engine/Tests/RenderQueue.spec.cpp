@@ -0,0 +1,136 @@
+#include <doctest/doctest.h>
+#include <vector>
+
+#include "Core/RenderQueue.h"
+#include "FakeTexture.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+RenderCommand command(IMGType type, float x, SDL_Texture* texture = nullptr) {
+  RenderCommand result{};
+  result.type = type;
+  result.texture = texture;
+  result.x = x;
+  return result;
+}
+
+std::vector<float> sorted_xs(const RenderQueue& queue) {
+  std::vector<float> xs;
+  for (const RenderCommand* sorted : queue.get_sorted())
+    xs.push_back(sorted->x);
+  return xs;
+}
+}  // namespace
+
+TEST_SUITE("Core::RenderQueue") {
+  TEST_CASE("Keys order by type, then render order, then submission") {
+    CHECK(RenderQueue::make_key(IMGType::Scene, 100, 0, 5) <
+          RenderQueue::make_key(IMGType::UI, -100, 0, 0));
+    CHECK(RenderQueue::make_key(IMGType::Scene, -1, 0, 9) <
+          RenderQueue::make_key(IMGType::Scene, 0, 0, 0));
+    CHECK(RenderQueue::make_key(IMGType::Scene, 0, 0, 1) <
+          RenderQueue::make_key(IMGType::Scene, 0, 0, 2));
+  }
+
+  TEST_CASE("Sorts like a stable sort on type and render order") {
+    RenderQueue queue;
+    queue.push(command(IMGType::Pixel, 0), 0);
+    queue.push(command(IMGType::UI, 1), 0);
+    queue.push(command(IMGType::Scene, 2), 5);
+    queue.push(command(IMGType::Scene, 3), -5);
+    queue.push(command(IMGType::Scene, 4), 5);
+    queue.push(command(IMGType::Scene, 5), 0);
+    queue.sort();
+    const std::vector<float> expected{3, 5, 2, 4, 1, 0};
+    CHECK(sorted_xs(queue) == expected);
+  }
+
+  TEST_CASE("Out of range render orders clamp instead of wrapping") {
+    RenderQueue queue;
+    queue.push(command(IMGType::Scene, 0), 1 << 30);
+    queue.push(command(IMGType::Scene, 1), -(1 << 30));
+    queue.push(command(IMGType::Scene, 2), 0);
+    queue.sort();
+    const std::vector<float> expected{1, 2, 0};
+    CHECK(sorted_xs(queue) == expected);
+  }
+
+  TEST_CASE("batch_by_texture groups equal orders by texture only") {
+    // ids go by first draw, texture 1 before texture 2
+    RenderQueue queue;
+    queue.set_batch_by_texture(true);
+    queue.push(command(IMGType::Scene, 0, fake_texture(1)), 0);
+    queue.push(command(IMGType::Scene, 1, fake_texture(2)), 0);
+    queue.push(command(IMGType::Scene, 2, fake_texture(1)), 0);
+    queue.push(command(IMGType::Scene, 3, fake_texture(2)), 1);
+    queue.push(command(IMGType::Scene, 4, fake_texture(1)), 1);
+    queue.sort();
+    const std::vector<float> expected{0, 2, 1, 4, 3};
+    CHECK(sorted_xs(queue) == expected);
+  }
+
+  TEST_CASE("Culling drops scene draws whose bounds miss the camera") {
+    RenderQueue queue;
+    // camera at (10, 0) seeing 4 units either side and 2 up and down
+    queue.push(command(IMGType::Scene, 0), 0, 10.0f, 0.0f, 0.5f);
+    queue.push(command(IMGType::Scene, 1), 0, 20.0f, 0.0f, 0.5f);
+    // centre is outside but the radius reaches in
+    queue.push(command(IMGType::Scene, 2), 0, 15.0f, 0.0f, 1.5f);
+    queue.push(command(IMGType::Scene, 3), 0, 10.0f, 3.0f, 0.5f);
+    queue.push(command(IMGType::UI, 4), 0);
+    queue.push(command(IMGType::Pixel, 5), 0);
+    queue.cull(10.0f, 0.0f, 4.0f, 2.0f);
+    queue.sort();
+    CHECK(queue.get_culled_count() == 2);
+    const std::vector<float> expected{0, 2, 4, 5};
+    CHECK(sorted_xs(queue) == expected);
+  }
+
+  TEST_CASE("Clearing keeps the queue reusable") {
+    RenderQueue queue;
+    queue.push(command(IMGType::Scene, 0), 0);
+    queue.sort();
+    queue.cull(100.0f, 100.0f, 1.0f, 1.0f);
+    queue.clear();
+    CHECK(queue.empty());
+    CHECK(queue.get_culled_count() == 0);
+    queue.sort();
+    CHECK(queue.get_sorted().empty());
+    queue.push(command(IMGType::UI, 7), 0);
+    queue.sort();
+    const std::vector<float> expected{7};
+    CHECK(sorted_xs(queue) == expected);
+  }
+
+  TEST_CASE("Content hash follows what would be drawn") {
+    auto fill = [](RenderQueue& queue, float last_x, int last_order) {
+      queue.push(command(IMGType::Scene, 1, fake_texture(1)), 0);
+      queue.push(command(IMGType::UI, 2, fake_texture(2)), 3);
+      queue.push(command(IMGType::Scene, last_x, fake_texture(1)), last_order);
+    };
+    RenderQueue a;
+    RenderQueue b;
+    fill(a, 3, 0);
+    fill(b, 3, 0);
+    CHECK(a.content_hash() == b.content_hash());
+    // sorting only moves entries around
+    b.sort();
+    CHECK(a.content_hash() == b.content_hash());
+
+    RenderQueue moved;
+    fill(moved, 4, 0);
+    CHECK(moved.content_hash() != a.content_hash());
+    RenderQueue reordered;
+    fill(reordered, 3, 1);
+    CHECK(reordered.content_hash() != a.content_hash());
+
+    RenderQueue swapped;
+    swapped.push(command(IMGType::Scene, 3, fake_texture(1)), 0);
+    swapped.push(command(IMGType::UI, 2, fake_texture(2)), 3);
+    swapped.push(command(IMGType::Scene, 1, fake_texture(1)), 0);
+    CHECK(swapped.content_hash() != a.content_hash());
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,106 @@
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <vector>
+
+#include "Core/RigidbodyPool.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+// more than one chunk, so acquire has to go through reclaim
+constexpr int BODY_COUNT = 200;
+
+// acquires count slots and tracks each with a table Lua keeps alive in the
+// global "held", the pool can't tell that from a Rigidbody component
+std::vector<Rigidbody*> acquire_held(lua_State* L, int count) {
+  auto& pool = RigidbodyPool::getInstance();
+  luabridge::LuaRef held = luabridge::newTable(L);
+  luabridge::setGlobal(L, held, "held");
+  std::vector<Rigidbody*> rigidbodies;
+  for (int i = 0; i < count; i++) {
+    Rigidbody* rigidbody = pool.acquire();
+    luabridge::LuaRef component = luabridge::newTable(L);
+    held[i + 1] = component;
+    pool.track(rigidbody, component);
+    rigidbodies.push_back(rigidbody);
+  }
+  return rigidbodies;
+}
+}  // namespace
+
+TEST_SUITE("Core::RigidbodyPool") {
+  TEST_CASE("Slots Lua still references are not handed out again") {
+    auto& pool = RigidbodyPool::getInstance();
+    lua_State* L = luaL_newstate();
+    {
+      const auto first = acquire_held(L, BODY_COUNT);
+      pool.release_all();
+      pool.recycle();
+      CHECK_EQ(pool.get_retired_count(), BODY_COUNT);
+
+      // drain the never used slots, then one more has to be a new chunk
+      const size_t capacity = pool.get_capacity();
+      for (size_t i = 0; i <= capacity - BODY_COUNT; i++) {
+        Rigidbody* fresh = pool.acquire();
+        CHECK(std::find(first.begin(), first.end(), fresh) == first.end());
+      }
+      CHECK_EQ(pool.get_retired_count(), BODY_COUNT);
+      CHECK(pool.get_capacity() > capacity);
+    }
+    pool.release_all();
+    pool.reset();
+    lua_close(L);
+  }
+
+  TEST_CASE("Slots come back once Lua has collected their components") {
+    auto& pool = RigidbodyPool::getInstance();
+    lua_State* L = luaL_newstate();
+    {
+      acquire_held(L, BODY_COUNT);
+      pool.release_all();
+      pool.recycle();
+      lua_pushnil(L);
+      lua_setglobal(L, "held");
+      lua_gc(L, LUA_GCCOLLECT, 0);
+
+      const size_t capacity = pool.get_capacity();
+      for (size_t i = 0; i < capacity; i++)
+        pool.acquire();
+      CHECK_EQ(pool.get_capacity(), capacity);
+      CHECK_EQ(pool.get_retired_count(), 0);
+    }
+    pool.release_all();
+    pool.reset();
+    lua_close(L);
+  }
+
+  TEST_CASE("Reset hands every slot back before the Lua state closes") {
+    auto& pool = RigidbodyPool::getInstance();
+    lua_State* L = luaL_newstate();
+    acquire_held(L, BODY_COUNT);
+    // what SceneManager::reset does on Stop, ECS::reset closes the state
+    pool.release_all();
+    pool.reset();
+    lua_close(L);
+    CHECK_EQ(pool.get_retired_count(), 0);
+    CHECK_EQ(pool.get_live_count(), 0);
+
+    // the next scene acquires before it tracks anything, past a chunk's
+    // worth of slots, without touching the closed state
+    const size_t capacity = pool.get_capacity();
+    std::vector<Rigidbody*> next_scene;
+    for (size_t i = 0; i < capacity; i++)
+      next_scene.push_back(pool.acquire());
+    CHECK_EQ(pool.get_capacity(), capacity);
+    CHECK_EQ(pool.get_live_count(), capacity);
+    for (Rigidbody* rigidbody : next_scene)
+      CHECK(not rigidbody->released);
+
+    pool.acquire();
+    CHECK(pool.get_capacity() > capacity);
+    pool.release_all();
+    pool.reset();
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,144 @@
+#include <doctest/doctest.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Core/SceneManifest.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+using Kind = SceneManifest::Kind;
+
+std::unique_ptr<rapidjson::Document> parse(const char* json) {
+  auto document = std::make_unique<rapidjson::Document>();
+  document->Parse(json);
+  CHECK(not document->HasParseError());
+  return document;
+}
+
+// a fake game: names decide what they are, templates live in a map
+struct FakeGame {
+  std::map<std::string, std::unique_ptr<rapidjson::Document>> templates;
+  std::map<std::string, std::vector<std::string>> component_images;
+  int template_lookups = 0;
+
+  SceneManifest::Sources sources() {
+    SceneManifest::Sources sources;
+    sources.classify = [this](const std::string& value) {
+      if (value.rfind("img_", 0) == 0)
+        return Kind::IMAGE;
+      if (value.rfind("sfx_", 0) == 0)
+        return Kind::AUDIO;
+      if (value.rfind("font_", 0) == 0)
+        return Kind::FONT;
+      if (templates.count(value) > 0)
+        return Kind::TEMPLATE;
+      return Kind::NONE;
+    };
+    sources.find_template =
+        [this](const std::string& name) -> const rapidjson::Value* {
+      template_lookups++;
+      const auto it = templates.find(name);
+      return it == templates.end() ? nullptr : it->second.get();
+    };
+    sources.declare_component = [this](const std::string& type,
+                                       SceneManifest& manifest) {
+      for (const auto& image : component_images[type])
+        manifest.add(Kind::IMAGE, image);
+    };
+    return sources;
+  }
+};
+
+std::vector<std::string> as_vector(const std::set<std::string>& names) {
+  return {names.begin(), names.end()};
+}
+}  // namespace
+
+TEST_SUITE("Core::SceneManifest") {
+  TEST_CASE("Component properties are sorted by what they name") {
+    FakeGame game;
+    const auto scene = parse(R"({"actors": [
+      {"name": "player", "components": {
+        "1": {"type": "Sprite", "sprite": "img_player", "hurt": "sfx_ouch"},
+        "2": {"type": "Label", "font": "font_main", "text": "hello", "x": 3}
+      }},
+      {"name": "other", "components": {
+        "1": {"type": "Sprite", "sprite": "img_player"}
+      }}
+    ]})");
+    const SceneManifest manifest =
+        SceneManifest::build(*scene, game.sources());
+
+    const std::vector<std::string> expected_images = {"img_player"};
+    const std::vector<std::string> expected_audio = {"sfx_ouch"};
+    const std::vector<std::string> expected_fonts = {"font_main"};
+    CHECK(as_vector(manifest.images) == expected_images);
+    CHECK(as_vector(manifest.audio) == expected_audio);
+    CHECK(as_vector(manifest.fonts) == expected_fonts);
+    CHECK(manifest.templates.empty());
+    CHECK(manifest.size() == 3);
+  }
+
+  TEST_CASE("Templates are followed, including ones a property names") {
+    FakeGame game;
+    game.templates["Enemy"] = parse(R"({"components": {
+      "1": {"type": "Sprite", "sprite": "img_enemy", "drops": "Coin"}
+    }})");
+    game.templates["Coin"] = parse(R"({"components": {
+      "1": {"type": "Sprite", "sprite": "img_coin", "spawns": "Enemy"}
+    }})");
+    const auto scene = parse(R"({"actors": [
+      {"template": "Enemy"}, {"template": "Enemy"}
+    ]})");
+    const SceneManifest manifest =
+        SceneManifest::build(*scene, game.sources());
+
+    const std::vector<std::string> expected_images = {"img_coin",
+                                                      "img_enemy"};
+    const std::vector<std::string> expected_templates = {"Coin", "Enemy"};
+    CHECK(as_vector(manifest.images) == expected_images);
+    CHECK(as_vector(manifest.templates) == expected_templates);
+    // each template is only walked once, even though they name each other
+    CHECK(game.template_lookups == 2);
+  }
+
+  TEST_CASE("Scenes and component types can declare extra assets") {
+    FakeGame game;
+    game.templates["Boss"] = parse(R"({"components": {
+      "1": {"type": "Sprite", "sprite": "img_boss"}
+    }})");
+    game.component_images["Spawner"] = {"img_portal"};
+    const auto scene = parse(R"({
+      "preload": {"audio": ["sfx_music"], "templates": ["Boss"],
+                  "images": ["img_sky", 4]},
+      "actors": [{"components": {"1": {"type": "Spawner"}}}]
+    })");
+    const SceneManifest manifest =
+        SceneManifest::build(*scene, game.sources());
+
+    const std::vector<std::string> expected_images = {"img_boss", "img_portal",
+                                                      "img_sky"};
+    const std::vector<std::string> expected_audio = {"sfx_music"};
+    CHECK(as_vector(manifest.images) == expected_images);
+    CHECK(as_vector(manifest.audio) == expected_audio);
+  }
+
+  TEST_CASE("Missing templates and odd shapes are skipped") {
+    FakeGame game;
+    const auto scene = parse(R"({"actors": [
+      {"template": "Nowhere"}, 3, {"components": {"1": 5}}
+    ]})");
+    const SceneManifest manifest =
+        SceneManifest::build(*scene, game.sources());
+    const std::vector<std::string> expected_templates = {"Nowhere"};
+    CHECK(as_vector(manifest.templates) == expected_templates);
+    CHECK(manifest.images.empty());
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
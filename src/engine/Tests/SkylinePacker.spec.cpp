@@ -0,0 +1,80 @@
+#include <doctest/doctest.h>
+#include <vector>
+
+#include "Core/SkylinePacker.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+struct Placed {
+  int x, y, w, h;
+};
+
+bool overlap(const Placed& a, const Placed& b) {
+  return a.x < b.x + b.w and b.x < a.x + a.w and a.y < b.y + b.h and
+         b.y < a.y + a.h;
+}
+}  // namespace
+
+TEST_SUITE("Core::SkylinePacker") {
+  TEST_CASE("Rects stay on the page and never overlap") {
+    SkylinePacker packer(256, 256);
+    std::vector<Placed> placed;
+    const int sizes[][2] = {{64, 32}, {17, 90}, {128, 16}, {33, 33},
+                            {70, 12}, {5, 200}, {40, 40}, {90, 60}};
+    for (int round = 0; round < 3; round++) {
+      for (const auto& size : sizes) {
+        int x = 0;
+        int y = 0;
+        if (not packer.insert(size[0], size[1], x, y))
+          continue;
+        CHECK_GE(x, 0);
+        CHECK_GE(y, 0);
+        CHECK_LE(x + size[0], 256);
+        CHECK_LE(y + size[1], 256);
+        placed.push_back({x, y, size[0], size[1]});
+      }
+    }
+    CHECK_GT(placed.size(), 8);
+    for (size_t i = 0; i < placed.size(); i++) {
+      for (size_t j = i + 1; j < placed.size(); j++)
+        CHECK_FALSE(overlap(placed[i], placed[j]));
+    }
+  }
+
+  TEST_CASE("Equal tiles fill the page exactly") {
+    SkylinePacker packer(64, 64);
+    int x = 0;
+    int y = 0;
+    for (int i = 0; i < 16; i++)
+      REQUIRE(packer.insert(16, 16, x, y));
+    CHECK_FALSE(packer.insert(1, 1, x, y));
+    CHECK_EQ(packer.get_occupancy(), doctest::Approx(1.0f));
+  }
+
+  TEST_CASE("Rects bigger than the page are rejected") {
+    SkylinePacker packer(32, 32);
+    int x = 0;
+    int y = 0;
+    CHECK_FALSE(packer.insert(33, 1, x, y));
+    CHECK_FALSE(packer.insert(1, 33, x, y));
+    CHECK_FALSE(packer.insert(0, 4, x, y));
+    CHECK(packer.insert(32, 32, x, y));
+  }
+
+  TEST_CASE("Lowest spot wins") {
+    SkylinePacker packer(100, 100);
+    int x = 0;
+    int y = 0;
+    REQUIRE(packer.insert(50, 40, x, y));
+    REQUIRE(packer.insert(50, 10, x, y));
+    CHECK_EQ(x, 50);
+    CHECK_EQ(y, 0);
+    // next to the short one beats on top of the tall one
+    REQUIRE(packer.insert(50, 10, x, y));
+    CHECK_EQ(x, 50);
+    CHECK_EQ(y, 10);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
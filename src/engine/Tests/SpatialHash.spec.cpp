@@ -0,0 +1,117 @@
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "Core/SpatialHash.h"
+#include "FakeActor.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+bool contains(const std::vector<Actor*>& actors, size_t id) {
+  return std::find(actors.begin(), actors.end(), fake_actor(id)) !=
+         actors.end();
+}
+}  // namespace
+
+TEST_SUITE("Core::SpatialHash") {
+  TEST_CASE("Rect query returns only actors inside the rect") {
+    SpatialHash hash(1.0f);
+    hash.update(1, fake_actor(1), 0.5f, 0.5f);
+    hash.update(2, fake_actor(2), 3.5f, 0.5f);
+    hash.update(3, fake_actor(3), -2.0f, -2.0f);
+
+    std::vector<Actor*> found;
+    hash.query_rect(0.0f, 0.0f, 4.0f, 1.0f, found);
+    CHECK_EQ(found.size(), 2);
+    CHECK(contains(found, 1));
+    CHECK(contains(found, 2));
+  }
+
+  TEST_CASE("Radius query is sorted by distance") {
+    SpatialHash hash(2.0f);
+    hash.update(1, fake_actor(1), 3.0f, 0.0f);
+    hash.update(2, fake_actor(2), 1.0f, 0.0f);
+    hash.update(3, fake_actor(3), 2.0f, 0.0f);
+    hash.update(4, fake_actor(4), 10.0f, 0.0f);
+
+    std::vector<Actor*> found;
+    hash.query_radius(0.0f, 0.0f, 3.5f, found);
+    REQUIRE_EQ(found.size(), 3);
+    CHECK_EQ(found[0], fake_actor(2));
+    CHECK_EQ(found[1], fake_actor(3));
+    CHECK_EQ(found[2], fake_actor(1));
+  }
+
+  TEST_CASE("Moving and removing actors") {
+    SpatialHash hash(1.0f);
+    hash.update(1, fake_actor(1), 0.5f, 0.5f);
+    hash.update(2, fake_actor(2), 0.6f, 0.6f);
+    hash.update(1, fake_actor(1), 50.5f, 50.5f);
+
+    std::vector<Actor*> found;
+    hash.query_rect(0.0f, 0.0f, 1.0f, 1.0f, found);
+    CHECK_EQ(found.size(), 1);
+    CHECK(contains(found, 2));
+
+    hash.remove(2);
+    found.clear();
+    hash.query_rect(0.0f, 0.0f, 1.0f, 1.0f, found);
+    CHECK(found.empty());
+    CHECK_EQ(hash.size(), 1);
+    CHECK(hash.contains(1));
+    CHECK_FALSE(hash.contains(2));
+  }
+
+  TEST_CASE("Survives growth and cell size changes") {
+    SpatialHash hash(1.0f);
+    for (size_t i = 0; i < 1000; i++)
+      hash.update(i + 1, fake_actor(i + 1), static_cast<float>(i) + 0.5f,
+                  -static_cast<float>(i) - 0.5f);
+
+    std::vector<Actor*> found;
+    hash.query_rect(0.0f, -1000.0f, 1000.0f, 0.0f, found);
+    CHECK_EQ(found.size(), 1000);
+
+    hash.set_cell_size(8.0f);
+    found.clear();
+    hash.query_radius(500.5f, -500.5f, 0.1f, found);
+    REQUIRE_EQ(found.size(), 1);
+    CHECK_EQ(found[0], fake_actor(501));
+
+    hash.clear();
+    found.clear();
+    hash.query_rect(0.0f, -1000.0f, 1000.0f, 0.0f, found);
+    CHECK(found.empty());
+  }
+
+  TEST_CASE("Far away and non-finite positions are handled") {
+    SpatialHash hash(0.5f);
+    const float far = 1e30f;
+    const float infinity = std::numeric_limits<float>::infinity();
+    hash.update(1, fake_actor(1), far, -far);
+    hash.update(2, fake_actor(2), 3e9f, 0.0f);
+    hash.update(3, fake_actor(3), 0.0f, 0.0f);
+
+    std::vector<Actor*> found;
+    hash.query_rect(far * 0.5f, -far * 2.0f, far * 2.0f, -far * 0.5f, found);
+    REQUIRE_EQ(found.size(), 1);
+    CHECK(contains(found, 1));
+
+    found.clear();
+    hash.query_rect(-infinity, -infinity, infinity, infinity, found);
+    CHECK_EQ(found.size(), 3);
+
+    // a NaN position drops the actor instead of filing it somewhere random
+    hash.update(3, fake_actor(3), std::nanf(""), 0.0f);
+    CHECK(not hash.contains(3));
+    found.clear();
+    hash.query_radius(std::nanf(""), 0.0f, 10.0f, found);
+    hash.query_rect(0.0f, std::nanf(""), 1.0f, 1.0f, found);
+    CHECK(found.empty());
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
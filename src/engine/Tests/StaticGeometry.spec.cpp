@@ -0,0 +1,104 @@
+#include <doctest/doctest.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Core/StaticGeometry.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+using Tiles = std::vector<std::pair<int32, int32>>;
+
+Tiles block(int32 x, int32 y, int32 width, int32 height) {
+  Tiles tiles;
+  for (int32 iy = y; iy < y + height; iy++)
+    for (int32 ix = x; ix < x + width; ix++)
+      tiles.emplace_back(ix, iy);
+  return tiles;
+}
+
+// how many rectangles cover each tile, every tile has to be covered once
+std::map<std::pair<int32, int32>, int> coverage(
+    const std::vector<StaticGeometry::TileRect>& rects) {
+  std::map<std::pair<int32, int32>, int> covered;
+  for (const auto& rect : rects)
+    for (int32 y = rect.y; y < rect.y + rect.height; y++)
+      for (int32 x = rect.x; x < rect.x + rect.width; x++)
+        covered[{x, y}]++;
+  return covered;
+}
+
+bool covers_exactly(const Tiles& tiles,
+                    const std::vector<StaticGeometry::TileRect>& rects) {
+  const auto covered = coverage(rects);
+  if (covered.size() != tiles.size())
+    return false;
+  for (const auto& tile : tiles) {
+    const auto it = covered.find(tile);
+    if (it == covered.end() or it->second != 1)
+      return false;
+  }
+  return true;
+}
+}  // namespace
+
+TEST_SUITE("Core::StaticGeometry") {
+  TEST_CASE("A filled block becomes one rectangle") {
+    const Tiles tiles = block(-3, 2, 5, 4);
+    const auto rects = StaticGeometry::merge_tiles(tiles);
+    REQUIRE_EQ(rects.size(), 1);
+    CHECK_EQ(rects[0].x, -3);
+    CHECK_EQ(rects[0].y, 2);
+    CHECK_EQ(rects[0].width, 5);
+    CHECK_EQ(rects[0].height, 4);
+  }
+
+  TEST_CASE("Rectangles grow right first, then down by whole rows") {
+    // ###
+    // #..
+    // #..
+    Tiles tiles = block(0, 0, 3, 1);
+    tiles.emplace_back(0, 1);
+    tiles.emplace_back(0, 2);
+    const auto rects = StaticGeometry::merge_tiles(tiles);
+    REQUIRE_EQ(rects.size(), 2);
+    CHECK_EQ(rects[0].width, 3);
+    CHECK_EQ(rects[0].height, 1);
+    CHECK_EQ(rects[1].x, 0);
+    CHECK_EQ(rects[1].y, 1);
+    CHECK_EQ(rects[1].width, 1);
+    CHECK_EQ(rects[1].height, 2);
+    CHECK(covers_exactly(tiles, rects));
+  }
+
+  TEST_CASE("Gaps and scattered tiles are covered exactly once") {
+    Tiles tiles = block(0, 0, 6, 3);
+    // punch a hole and add stragglers, input order doesn't matter
+    std::erase(tiles, std::make_pair(2, 1));
+    tiles.emplace_back(10, -4);
+    tiles.emplace_back(-7, 5);
+    std::swap(tiles.front(), tiles.back());
+    const auto rects = StaticGeometry::merge_tiles(tiles);
+    CHECK(covers_exactly(tiles, rects));
+    CHECK(rects.size() < tiles.size());
+  }
+
+  TEST_CASE("A checkerboard can't merge at all") {
+    Tiles tiles;
+    for (int32 y = 0; y < 4; y++)
+      for (int32 x = 0; x < 4; x++)
+        if ((x + y) % 2 == 0)
+          tiles.emplace_back(x, y);
+    const auto rects = StaticGeometry::merge_tiles(tiles);
+    CHECK_EQ(rects.size(), tiles.size());
+    CHECK(covers_exactly(tiles, rects));
+  }
+
+  TEST_CASE("No tiles, no rectangles") {
+    CHECK(StaticGeometry::merge_tiles({}).empty());
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
@@ -0,0 +1,61 @@
+#include <doctest/doctest.h>
+
+#include "Core/TextLayoutCache.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+TextLayout layout_of_width(int width) {
+  TextLayout layout;
+  layout.width = width;
+  return layout;
+}
+}  // namespace
+
+TEST_SUITE("Core::TextLayoutCache") {
+  TEST_CASE("Keys tell font, size and text apart") {
+    CHECK(TextLayoutCache::make_key("a", 16, "bc") !=
+          TextLayoutCache::make_key("ab", 16, "c"));
+    CHECK(TextLayoutCache::make_key("a", 16, "b") !=
+          TextLayoutCache::make_key("a", 1, "6b"));
+    CHECK(TextLayoutCache::make_key("a", 16, "b") ==
+          TextLayoutCache::make_key("a", 16, "b"));
+  }
+
+  TEST_CASE("Hits return what was inserted") {
+    TextLayoutCache cache(4);
+    CHECK(cache.find("score") == nullptr);
+    cache.insert("score", layout_of_width(40));
+    const TextLayout* hit = cache.find("score");
+    REQUIRE(hit != nullptr);
+    CHECK(hit->width == 40);
+    CHECK(cache.get_hits() == 1);
+    CHECK(cache.get_misses() == 1);
+  }
+
+  TEST_CASE("The least recently used entry is evicted") {
+    TextLayoutCache cache(2);
+    cache.insert("a", layout_of_width(1));
+    cache.insert("b", layout_of_width(2));
+    // touching a leaves b as the oldest
+    CHECK(cache.find("a") != nullptr);
+    cache.insert("c", layout_of_width(3));
+    CHECK(cache.size() == 2);
+    CHECK(cache.find("b") == nullptr);
+    CHECK(cache.find("a") != nullptr);
+    CHECK(cache.find("c") != nullptr);
+  }
+
+  TEST_CASE("Inserting an existing key replaces it without growing") {
+    TextLayoutCache cache(2);
+    cache.insert("a", layout_of_width(1));
+    cache.insert("a", layout_of_width(5));
+    CHECK(cache.size() == 1);
+    CHECK(cache.find("a")->width == 5);
+    cache.clear();
+    CHECK(cache.size() == 0);
+    CHECK(cache.find("a") == nullptr);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
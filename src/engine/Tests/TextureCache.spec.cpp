@@ -0,0 +1,95 @@
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Core/TextureCache.h"
+#include "FakeTexture.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+struct Evictions {
+  std::vector<std::string> names;
+  void operator()(const std::string& name, SDL_Texture*) {
+    names.push_back(name);
+  }
+};
+}  // namespace
+
+TEST_SUITE("Core::TextureCache") {
+  TEST_CASE("Resident bytes follow inserts and evictions") {
+    TextureCache cache(0);
+    cache.insert("a", fake_texture(0), 100, 0);
+    cache.insert("b", fake_texture(1), 50, 0);
+    CHECK(cache.get_resident_bytes() == 150);
+    CHECK(cache.find("a") == fake_texture(0));
+    CHECK(cache.find("missing") == nullptr);
+
+    Evictions evictions;
+    // no budget, trim leaves everything
+    CHECK(cache.trim(10, evictions) == 0);
+    CHECK(cache.drop_unreferenced(10, evictions) == 2);
+    CHECK(cache.get_resident_bytes() == 0);
+    CHECK(cache.size() == 0);
+    CHECK(cache.get_evicted_count() == 2);
+  }
+
+  TEST_CASE("Over budget the least recently used go first") {
+    TextureCache cache(250);
+    cache.insert("old", fake_texture(0), 100, 1);
+    cache.insert("older", fake_texture(1), 100, 0);
+    cache.insert("new", fake_texture(2), 100, 5);
+    Evictions evictions;
+    CHECK(cache.trim(6, evictions) == 1);
+    const std::vector<std::string> expected = {"older"};
+    CHECK(evictions.names == expected);
+    CHECK(cache.get_resident_bytes() == 200);
+  }
+
+  TEST_CASE("Referenced textures outlive unreferenced ones") {
+    TextureCache cache(150);
+    cache.insert("held", fake_texture(0), 100, 0);
+    cache.insert("loose", fake_texture(1), 100, 3);
+    cache.acquire("held");
+    Evictions evictions;
+    cache.trim(10, evictions);
+    const std::vector<std::string> expected = {"loose"};
+    CHECK(evictions.names == expected);
+
+    // still over budget alone, but it's held
+    cache.set_budget(50);
+    cache.trim(10, evictions);
+    const std::vector<std::string> expected_after = {"loose", "held"};
+    CHECK(evictions.names == expected_after);
+  }
+
+  TEST_CASE("Textures used by the frame being drawn are kept") {
+    TextureCache cache(10);
+    cache.insert("drawing", fake_texture(0), 100, 7);
+    cache.insert("idle", fake_texture(1), 100, 2);
+    cache.touch("idle", 7);
+    Evictions evictions;
+    CHECK(cache.trim(7, evictions) == 0);
+    CHECK(cache.drop_unreferenced(7, evictions) == 0);
+    CHECK(cache.size() == 2);
+  }
+
+  TEST_CASE("References can be taken before the texture exists") {
+    TextureCache cache(0);
+    cache.acquire("later");
+    cache.acquire("later");
+    cache.release("later");
+    cache.insert("later", fake_texture(0), 10, 0);
+    CHECK(cache.get_references("later") == 1);
+    Evictions evictions;
+    CHECK(cache.drop_unreferenced(5, evictions) == 0);
+    cache.release("later");
+    cache.release("later");
+    CHECK(cache.get_references("later") == 0);
+    CHECK(cache.drop_unreferenced(5, evictions) == 1);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
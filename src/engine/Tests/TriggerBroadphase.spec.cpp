@@ -0,0 +1,223 @@
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <vector>
+
+#include "Core/Actor.h"
+#include "Core/PhysicsConfig.h"
+#include "Core/TriggerBroadphase.h"
+
+// NOLINTBEGIN(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)
+
+namespace {
+using LifeCycle = EngineUtils::LifeCycle;
+using Events = std::vector<TriggerBroadphase::Event>;
+
+Actor make_actor(size_t id) {
+  Actor actor;
+  actor._id = id;
+  return actor;
+}
+
+TriggerVolume* add_box(Actor& actor, float x, float y) {
+  TriggerVolume* volume = TriggerBroadphase::getInstance().acquire();
+  volume->actor = &actor;
+  volume->x = x;
+  volume->y = y;
+  volume->Initialize();
+  return volume;
+}
+
+TriggerVolume* add_circle(Actor& actor, float x, float y, float radius) {
+  TriggerVolume* volume = TriggerBroadphase::getInstance().acquire();
+  volume->actor = &actor;
+  volume->trigger_type = "circle";
+  volume->radius = radius;
+  volume->x = x;
+  volume->y = y;
+  volume->Initialize();
+  return volume;
+}
+
+int count(const Events& events,
+          LifeCycle event,
+          const Actor& self,
+          const Actor& other) {
+  int found = 0;
+  for (const auto& e : events) {
+    if (e.event == event and e.self == &self and e.other == &other)
+      found++;
+  }
+  return found;
+}
+
+bool mentions(const Events& events, const Actor& actor) {
+  for (const auto& e : events) {
+    if (e.self == &actor or e.other == &actor)
+      return true;
+  }
+  return false;
+}
+
+// every case starts from the default layers and an empty broadphase
+void start() {
+  PhysicsConfig::getInstance().reset();
+  TriggerBroadphase::getInstance().reset();
+}
+}  // namespace
+
+TEST_SUITE("Core::TriggerBroadphase") {
+  TEST_CASE("Overlaps enter once, persist quietly and exit once") {
+    start();
+    auto& broadphase = TriggerBroadphase::getInstance();
+    Actor a = make_actor(1);
+    Actor b = make_actor(2);
+    add_box(a, 0.0f, 0.0f);
+    TriggerVolume* moving = add_box(b, 0.5f, 0.0f);
+
+    const Events entered = broadphase.find_events();
+    CHECK_EQ(entered.size(), 2);
+    CHECK_EQ(count(entered, LifeCycle::OnTriggerEnter, a, b), 1);
+    CHECK_EQ(count(entered, LifeCycle::OnTriggerEnter, b, a), 1);
+    CHECK_EQ(broadphase.get_pair_count(), 1);
+
+    moving->SetPosition(b2Vec2(0.75f, 0.25f));
+    CHECK(broadphase.find_events().empty());
+    CHECK_EQ(broadphase.get_pair_count(), 1);
+
+    moving->SetPosition(b2Vec2(5.0f, 0.0f));
+    const Events exited = broadphase.find_events();
+    CHECK_EQ(exited.size(), 2);
+    CHECK_EQ(count(exited, LifeCycle::OnTriggerExit, a, b), 1);
+    CHECK_EQ(count(exited, LifeCycle::OnTriggerExit, b, a), 1);
+    CHECK_EQ(broadphase.get_pair_count(), 0);
+
+    CHECK(broadphase.find_events().empty());
+    broadphase.reset();
+  }
+
+  TEST_CASE("Circles only touch when the shapes do, not their bounds") {
+    start();
+    auto& broadphase = TriggerBroadphase::getInstance();
+    Actor box = make_actor(1);
+    Actor circle = make_actor(2);
+    add_box(box, 0.0f, 0.0f);
+    // bounds overlap past the box's corner, the circle itself misses it
+    TriggerVolume* ball = add_circle(circle, 0.9f, 0.9f, 0.5f);
+    CHECK(broadphase.find_events().empty());
+
+    ball->SetPosition(b2Vec2(0.9f, 0.0f));
+    CHECK_EQ(count(broadphase.find_events(), LifeCycle::OnTriggerEnter, box,
+                   circle),
+             1);
+    broadphase.reset();
+  }
+
+  TEST_CASE("Disabled volumes and an actor's own volumes never pair") {
+    start();
+    auto& broadphase = TriggerBroadphase::getInstance();
+    Actor a = make_actor(1);
+    Actor b = make_actor(2);
+    add_box(a, 0.0f, 0.0f);
+    add_box(a, 0.25f, 0.0f);
+    TriggerVolume* hidden = add_box(b, 0.5f, 0.0f);
+    hidden->enabled = false;
+    CHECK(broadphase.find_events().empty());
+
+    hidden->enabled = true;
+    // b against both of a's volumes
+    CHECK_EQ(count(broadphase.find_events(), LifeCycle::OnTriggerEnter, b, a),
+             2);
+    broadphase.reset();
+  }
+
+  TEST_CASE("A volume released mid-overlap leaves without an exit") {
+    start();
+    auto& broadphase = TriggerBroadphase::getInstance();
+    Actor a = make_actor(1);
+    Actor b = make_actor(2);
+    add_box(a, 0.0f, 0.0f);
+    TriggerVolume* doomed = add_box(b, 0.5f, 0.0f);
+    CHECK_EQ(broadphase.find_events().size(), 2);
+
+    broadphase.release(doomed);
+    CHECK(doomed->released);
+    const Events after = broadphase.find_events();
+    CHECK(not mentions(after, b));
+    CHECK(after.empty());
+    CHECK_EQ(broadphase.get_pair_count(), 0);
+
+    // a new volume in the same spot is a new overlap
+    broadphase.recycle();
+    Actor c = make_actor(3);
+    add_box(c, 0.5f, 0.0f);
+    const Events entered = broadphase.find_events();
+    CHECK_EQ(count(entered, LifeCycle::OnTriggerEnter, a, c), 1);
+    CHECK_EQ(count(entered, LifeCycle::OnTriggerEnter, c, a), 1);
+    broadphase.reset();
+  }
+
+  TEST_CASE("Released volumes Lua still references are not handed out") {
+    start();
+    auto& broadphase = TriggerBroadphase::getInstance();
+    lua_State* L = luaL_newstate();
+    {
+      Actor a = make_actor(1);
+      TriggerVolume* kept = add_box(a, 0.0f, 0.0f);
+      luabridge::LuaRef component = luabridge::newTable(L);
+      luabridge::setGlobal(L, component, "kept");
+      broadphase.track(kept, component);
+
+      broadphase.release(kept);
+      broadphase.recycle();
+      CHECK_EQ(broadphase.get_retired_count(), 1);
+      // more than the earlier cases left free, so the last ones are new
+      for (int i = 0; i < 64; i++)
+        CHECK(broadphase.acquire() != kept);
+      CHECK_EQ(broadphase.get_retired_count(), 1);
+
+      lua_pushnil(L);
+      lua_setglobal(L, "kept");
+      component = luabridge::LuaRef(L);
+      lua_gc(L, LUA_GCCOLLECT, 0);
+      broadphase.recycle();
+      TriggerVolume* reused = broadphase.acquire();
+      CHECK(reused == kept);
+      CHECK(not reused->released);
+      CHECK_EQ(broadphase.get_retired_count(), 0);
+    }
+    broadphase.reset();
+    lua_close(L);
+  }
+
+  TEST_CASE("Reset hands every volume back and forgets the Lua state") {
+    start();
+    auto& broadphase = TriggerBroadphase::getInstance();
+    lua_State* L = luaL_newstate();
+    Actor a = make_actor(1);
+    std::vector<TriggerVolume*> volumes;
+    {
+      luabridge::LuaRef held = luabridge::newTable(L);
+      luabridge::setGlobal(L, held, "held");
+      for (int i = 0; i < 4; i++) {
+        TriggerVolume* volume = add_box(a, 0.0f, 0.0f);
+        luabridge::LuaRef component = luabridge::newTable(L);
+        held[i + 1] = component;
+        broadphase.track(volume, component);
+        volumes.push_back(volume);
+      }
+    }
+    // what SceneManager::reset does before ECS::reset closes the state
+    broadphase.reset();
+    lua_close(L);
+    CHECK_EQ(broadphase.get_retired_count(), 0);
+    CHECK_EQ(broadphase.get_volume_count(), 0);
+
+    for (size_t i = 0; i < volumes.size(); i++) {
+      TriggerVolume* volume = broadphase.acquire();
+      CHECK(std::find(volumes.begin(), volumes.end(), volume) != volumes.end());
+    }
+    broadphase.reset();
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace, cppcoreguidelines-avoid-do-while, cert-err33-c)